@@ -1,8 +1,13 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include <nlohmann/json.hpp>
+#include <SpiceQL/snapshot.h>
 
 namespace SpiceQL {
 
@@ -25,6 +30,10 @@ namespace SpiceQL {
       /**
        * @brief Gets SpiceQL name given alias or frame name
        * 
+       * Aliases take precedence over frame list names. Reads an immutable index
+       * without locking; the frame list part is only reloaded on a miss after
+       * the inventory DB has changed.
+       * 
        * @param name Given string name to look up
        * @return The SpiceQL name or empty string if not found
        */
@@ -52,25 +61,69 @@ namespace SpiceQL {
        */
       void setAliasMap(const nlohmann::json& newAliasMap);
 
+      /**
+       * @brief Gets a counter that changes every time the lookup table is replaced
+       * 
+       * Lets callers that derive tables from the alias map know when to rebuild them.
+       * 
+       * @return The generation of the current lookup table
+       */
+      unsigned long long getGeneration();
+
     private:
       AliasMap() = default; // Prevents others from making new instances
 
       /**
-       * @brief Checks initialization status and loads default aliases if necessary
+       * @brief Immutable lookup index, replaced as a whole on every update
+       */
+      struct Index {
+        // upper-cased alias -> SpiceQL name, as loaded or set by the user
+        std::unordered_map<std::string, std::string> aliases;
+        // frameList() as of framesGeneration of the inventory frame cache
+        std::vector<std::string> frames;
+        bool framesLoaded = false;
+        unsigned long long framesGeneration = 0;
+        unsigned long long generation = 0;
+        // aliases merged over upper-cased frame names, sorted by key
+        std::vector<std::pair<std::string, std::string>> entries;
+      };
+
+      /**
+       * @brief Returns the current index, loading the default aliases if there is none yet
+       *
+       * The index stays valid while the caller holds a SnapshotReadGuard.
        */
-      void ensure_init();
+      const Index *ensure_init();
 
       /**
-       * @brief Internal logic for parsing JSON and populating the lookup table without locking
+       * @brief Internal logic for parsing an alias JSON file into a lookup table
        * 
        * @param path Path to the JSON file to load
+       * @return upper-cased alias to SpiceQL name
+       */
+      std::unordered_map<std::string, std::string> load_internal(std::string path);
+
+      /**
+       * @brief Reloads the frame list part of the index for the given frame cache generation
+       */
+      const Index *refresh_frames(unsigned long long generation);
+
+      /**
+       * @brief Rebuilds the merged entries of an index and publishes it, m_mutex must be held
+       */
+      const Index *publish(std::unique_ptr<Index> index);
+
+      /**
+       * @brief Case-insensitive binary search of the merged entries
        */
-      void load_internal(std::string path);
+      static const std::string *find(const Index &index, std::string_view name);
 
-      // These live inside the class so the Singleton "owns" them
-      std::unordered_map<std::string, std::string> m_lookupTable;
+      // Readers only load m_index inside a SnapshotReadGuard. Writers are
+      // serialized by m_mutex, and a replaced index is freed by a later update
+      // once no reader can still hold it.
+      Snapshot<Index> m_index;
+      unsigned long long m_generations = 0;
       std::mutex m_mutex;
-      bool m_initialized = false;
   };
 
   /**
@@ -86,7 +86,7 @@ namespace SpiceQL {
      * @param spkQualities string of strings describing the quality of spks to try and obtain
      * @param searchKernels bool Whether to search the kernels for the user
      * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
-     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all, -2 for the minimal set covering the time range
      * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
      * @param kernelList vector<string> vector of additional kernels to load 
      * 
@@ -140,7 +140,7 @@ namespace SpiceQL {
      * @param spkQualities string of strings describing the quality of spks to try and obtain
      * @param searchKernels bool Whether to search the kernels for the user
      * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
-     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all, -2 for the minimal set covering the time range
      * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
      * @param kernelList vector<string> vector of additional kernels to load 
      * 
@@ -181,7 +181,7 @@ namespace SpiceQL {
      * @param ckQualities vector of string describing the quality of cks to try and obtain
      * @param searchKernels bool Whether to search the kernels for the user
      * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
-     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all, -2 for the minimal set covering the time range
      * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
      * @param kernelList vector<string> vector of additional kernels to load 
      *
@@ -218,7 +218,7 @@ namespace SpiceQL {
      * @param ckQualities vector of string describing the quality of cks to try and obtain
      * @param searchKernels bool Whether to search the kernels for the user
      * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
-     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all, -2 for the minimal set covering the time range
      * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
      * @param kernelList vector<string> vector of additional kernels to load 
      *
@@ -327,6 +327,93 @@ namespace SpiceQL {
         std::vector<std::string> kernelList={});
 
 
+    /**
+     * @brief Converts a list of string spacecraft clock times to ephemeris times
+     *
+     * Batch version of strSclkToEt. Kernels are searched for and furnished once
+     * for the whole list.
+     *
+     * @param frameCode int Frame id to use
+     * @param sclks vector<string> Spacecraft clock times as strings
+     * @param mission string Mission name as it relates to the config files
+     * @param useWeb bool Whether to use web SpiceQL
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     * @return vector<double> ephemeris times in the same order as sclks
+     */
+    std::pair<std::vector<double>, nlohmann::json> strSclkToEtBatch(
+        int frameCode,
+        std::vector<std::string> sclks,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1, 
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Converts a list of double spacecraft clock times to ephemeris times
+     *
+     * Batch version of doubleSclkToEt. Kernels are searched for and furnished once
+     * for the whole list.
+     *
+     * @param frameCode int Frame id to use
+     * @param sclks vector<double> Spacecraft clock times in ticks
+     * @param mission string Mission name as it relates to the config files
+     * @param useWeb bool Whether to use web SpiceQL
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     * @return vector<double> ephemeris times in the same order as sclks
+     */
+    std::pair<std::vector<double>, nlohmann::json> doubleSclkToEtBatch(
+        int frameCode,
+        std::vector<double> sclks,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1, 
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Converts a list of ephemeris times to spacecraft clock strings
+     *
+     * Batch version of doubleEtToSclk. Kernels are searched for and furnished once
+     * for the whole list.
+     *
+     * @param frameCode int Frame id to use
+     * @param ets vector<double> Ephemeris times to convert
+     * @param mission string Mission name as it relates to the config files
+     * @param useWeb bool Whether to use web SpiceQL
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     * @return vector<string> spacecraft clock strings in the same order as ets
+     */
+    std::pair<std::vector<std::string>, nlohmann::json> doubleEtToSclkBatch(
+        int frameCode,
+        std::vector<double> ets,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1, 
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
     /**
      * @brief convert a UTC string to an ephemeris time
      *
@@ -376,11 +463,68 @@ namespace SpiceQL {
         int limitSpk=1,
         std::vector<std::string> kernelList={});
 
+
+    /**
+     * @brief convert a list of UTC strings to ephemeris times
+     *
+     * Batch version of utcToEt. The LSK is searched for and furnished once for the whole list,
+     * without kernels the strings are converted by the thread-safe utcet engine.
+     *
+     * @param utcs vector<string> UTC strings, e.g. "1988 June 13, 12:29:48 TDB"
+     * @param useWeb bool Whether to use web SpiceQL
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     * @returns vector<double> ephemeris times in the same order as utcs
+     **/
+    std::pair<std::vector<double>, nlohmann::json> utcToEtBatch(
+        std::vector<std::string> utcs,
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1, 
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief convert a list of ephemeris times to UTC strings
+     *
+     * Batch version of etToUtc. The LSK is searched for and furnished once for the whole list,
+     * without kernels the times are converted by the thread-safe utcet engine.
+     *
+     * @param ets vector<double> ephemeris times
+     * @param format string output format, see et2utc_c
+     * @param precision number of decimal places for the seconds
+     * @param useWeb bool Whether to use web SpiceQL
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     * @returns vector<string> UTC strings in the same order as ets
+     **/
+    std::pair<std::vector<std::string>, nlohmann::json> etToUtcBatch(
+        std::vector<double> ets,
+        std::string format="",
+        double precision=0,
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1, 
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
     /**
      * @brief Switch between NAIF frame string name to integer frame code
      *
      * See <a href="https://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/req/naif_ids.html">NAIF's Docs on frame codes</a> for more information
      *
+     * Answered from the frame cache in the DB when possible. Frame kernels are
+     * only furnished when the cache misses or kernelList is given.
+     *
      * @param frame String frame name to translate to a NAIF code
      * @param mission Mission name as it relates to the config files
      * @param searchKernels bool Whether to search the kernels for the user
@@ -401,11 +545,41 @@ namespace SpiceQL {
         int limitSpk=1, 
         std::vector<std::string> kernelList={});
 
+    /**
+     * @brief Translate many NAIF frame or body names to codes at once
+     *
+     * Names are answered from the frame cache in the DB when possible. Frame
+     * kernels are furnished once for the names that are not in it, or for all
+     * of them when kernelList is given.
+     *
+     * @param frames String frame names to translate to NAIF codes
+     * @param mission Mission name as it relates to the config files, inferred from the names when empty
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     * 
+     * @return NAIF codes in the same order as frames
+     **/
+    std::pair<std::vector<int>, nlohmann::json> translateNameToCodeBatch(
+        std::vector<std::string> frames, 
+        std::string mission="", 
+        bool useWeb=false, 
+        bool searchKernels=true, 
+        bool fullKernelPath=false, 
+        int limitCk=-1, 
+        int limitSpk=1, 
+        std::vector<std::string> kernelList={});
+
     /**
      * @brief Switch between NAIF frame integer code to string frame name
      *
      * See <a href="https://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/req/naif_ids.html">NAIF's Docs on frame codes</a> for more information
      *
+     * Answered from the frame cache in the DB when possible. Frame kernels are
+     * only furnished when the cache misses or kernelList is given.
+     *
      * @param frame int NAIF frame code to translate
      * @param searchKernels bool Whether to search the kernels for the user
      * @param mission Mission name as it relates to the config files
@@ -426,11 +600,41 @@ namespace SpiceQL {
         int limitSpk=1,
         std::vector<std::string> kernelList={});
 
+    /**
+     * @brief Translate many NAIF frame or body codes to names at once
+     *
+     * Codes are answered from the frame cache in the DB when possible. Frame
+     * kernels are furnished once for the codes that are not in it, or for all
+     * of them when kernelList is given.
+     *
+     * @param frames int NAIF frame codes to translate
+     * @param mission Mission name as it relates to the config files, inferred from the codes when empty
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     *
+     * @return NAIF names in the same order as frames
+     **/
+    std::pair<std::vector<std::string>, nlohmann::json> translateCodeToNameBatch(
+        std::vector<int> frames, 
+        std::string mission="", 
+        bool useWeb=false, 
+        bool searchKernels=true, 
+        bool fullKernelPath=false, 
+        int limitCk=-1, 
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
     /**
      * @brief Get the center, class id, and class of a given frame
      *
      * See <a href="https://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/req/naif_ids.html">NAIF's Docs on frame codes</a> for more information
      *
+     * Answered from the frame info cached in the DB when possible. FKs are
+     * only furnished when the cache misses or kernelList is given.
+     *
      * @param frame String frame name to translate to a NAIF code
      * @param mission Mission name as it relates to the config files
      * @param searchKernels bool Whether to search the kernels for the user
@@ -451,10 +655,40 @@ namespace SpiceQL {
         int limitSpk=1,
         std::vector<std::string> kernelList={});
 
+    /**
+     * @brief Get the center, class id, and class of many frames at once
+     *
+     * Frames are answered from the frame info cached in the DB when possible.
+     * FKs are furnished once for the frames that are not in it, or for all of
+     * them when kernelList is given.
+     *
+     * @param frames int NAIF frame codes
+     * @param mission Mission name as it relates to the config files, inferred from the codes when empty
+     * @param searchKernels bool Whether to search the kernels for the user
+     * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
+     * @param kernelList vector<string> vector of additional kernels to load 
+     *
+     * @return 3 element vector of center, class and class id per frame, in the same order as frames
+     **/
+    std::pair<std::vector<std::vector<int>>, nlohmann::json> getFrameInfoBatch(
+        std::vector<int> frames, 
+        std::string mission="", 
+        bool useWeb=false, 
+        bool searchKernels=true, 
+        bool fullKernelPath=false, 
+        int limitCk=-1, 
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
     /**
     * @brief returns frame name and frame code associated to the target ID.
     *
     *  Takes in a target id and returns the frame name and frame code in json format
+    *
+    *  Answered from the body to frame associations cached in the DB when the
+    *  mission is known and kernels are searched, without furnishing FKs.
     * 
     * @param targetId target ID
     * @param mission mission name as it relates to the config files
@@ -482,6 +716,8 @@ namespace SpiceQL {
     *
     *  Takes in a kernel key from iaks, iks, and fks and returns the value associated with the input mission (e.g. LRO, MRO, sun etc) as json. 
     *  findMissionKeywords is a aggregation of cspice's gnpool_c, gcpool_c, gdpool_c, and gipool_c. Input key supports wildcards, e.g. "LRO_*", "*_BORESIGHT_SAMPLE", or "*-8600*". 
+    *  The kernels are read with the native text kernel parser rather than furnished, see findTextKernelKeywords.
+    *  When searching a mission's kernels without a kernelList, the keywords come from the DB's snapshot of the mission's keyword pool.
     *  
     * @param key kernel text keyword to look for 
     * @param mission spiceql name to search for (e.g. LRO, MRO, sun etc)
@@ -510,6 +746,7 @@ namespace SpiceQL {
     *  Takes in a target and key and returns the value associated in the form of vector from PCKs.
     *  findTargetKeywords is a aggregation of cspice's gnpool_c, gcpool_c, gdpool_c, and gipool_c. Input key supports wildcards, e.g. "*_RADII" or "*-8600*".
     *  Note: This function is mainly for obtaining target keywords. For obtaining other values, use findMissionKeywords.
+    *  The kernels are read with the native text kernel parser rather than furnished, see findTextKernelKeywords.
     * 
     * @param key keyword for desired values
     * @param mission mission name as it relates to the config files
@@ -538,6 +775,10 @@ namespace SpiceQL {
      * This function uses NAIF routines and builds a path from the initalframe to J2000 making
      * note of all the in between frames
      *
+     * Inertial, PCK and TK links are taken from the frame tables in the DB, so
+     * kernels are only furnished once a CK or dynamic link, or a frame missing
+     * from the DB, is reached. kernelList disables the DB tables.
+     *
      * @param et ephemeris times at which you want to optain the frame trace
      * @param initialFrame the initial frame's NAIF code.
      * @param mission Config subset as it relates to the mission
@@ -545,7 +786,7 @@ namespace SpiceQL {
      * @param spkQualities vector of strings describing the quality of spks to try and obtain
      * @param searchKernels bool Whether to search the kernels for the user
      * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
-     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all, -2 for the minimal set covering the time range
      * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
      * @param kernelList vector<string> vector of additional kernels to load 
      *
@@ -579,7 +820,7 @@ namespace SpiceQL {
      * @param targetFrame Target reference frame to get ephemeris data in
      * @param ckQualities vector of string describing the quality of cks to try and obtain
      * @param fullKernelPath bool if true returns full kernel paths, default returns relative paths
-     * @param limitCk int number of cks to limit to, default is -1 to retrieve all
+     * @param limitCk int number of cks to limit to, default is -1 to retrieve all, -2 for the minimal set covering the time range
      * @param limitSpk int number of spks to limit to, default is 1 to retrieve only one
      * @param kernelList vector<string> vector of additional kernels to load 
      *
@@ -666,4 +907,31 @@ namespace SpiceQL {
         int limitCk=-1, 
         int limitSpk=1, 
         bool overwrite=false);
+
+    /**
+     * @brief Get the coverage windows and gaps of a mission's CKs or SPKs.
+     *
+     * Answered from the kernel database without furnishing any kernels. Each
+     * quality is reported separately as merged coverage windows and the gaps
+     * between them inside [startTime, stopTime]. Without explicit bounds, gaps
+     * are only reported between coverage windows.
+     *
+     * @param mission mission name
+     * @param type kernel type, "ck" or "spk"
+     * @param qualities vector of string describing the qualities to report on
+     * @param startTime Ephemeris time to start reporting at
+     * @param stopTime Ephemeris time to stop reporting at
+     * @param naifCode only report coverage of this NAIF code, default is 0 for all codes
+     * @param useWeb whether to use web SpiceQL
+     *
+     * @returns {"<quality>": {"windows": [[start, stop], ...], "gaps": [[start, stop], ...]}, ...} and an empty list of kernels
+     **/
+    std::pair<nlohmann::json, nlohmann::json> getKernelCoverage(
+        std::string mission, 
+        std::string type="ck", 
+        std::vector<std::string> qualities={"smithed", "reconstructed"}, 
+        double startTime=-std::numeric_limits<double>::max(), 
+        double stopTime=std::numeric_limits<double>::max(), 
+        int naifCode=0, 
+        bool useWeb=false);
 }
@@ -0,0 +1,515 @@
+#pragma once
+/**
+ * @file
+ *
+ * Asynchronous variants of the API functions in api.h
+ *
+ * Each function takes the same arguments as its blocking counterpart and
+ * returns a future of its result. Calls run in parallel on the worker pool,
+ * so hosts can issue them from any number of threads. Calls that use CSPICE
+ * only take a CspiceGuard from furnishing their kernels until they are
+ * unloaded, their kernel searches, DB lookups and JSON work run alongside
+ * other calls.
+ *
+ **/
+
+#include <future>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "SpiceQL/api.h"
+
+namespace SpiceQL {
+
+    /**
+     * @brief Asynchronous getTargetStates, see getTargetStates for the parameters
+     *
+     * @return future of getTargetStates's result
+     **/
+    std::future<std::pair<std::vector<std::vector<double>>, nlohmann::json>> getTargetStatesAsync(
+        std::vector<double> ets,
+        std::string target,
+        std::string observer,
+        std::string frame,
+        std::string abcorr,
+        std::string mission="",
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        std::vector<std::string> spkQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous getTargetStatesRanged, see getTargetStatesRanged for the parameters
+     *
+     * @return future of getTargetStatesRanged's result
+     **/
+    std::future<std::pair<std::vector<std::vector<double>>, nlohmann::json>> getTargetStatesRangedAsync(
+        double startEt,
+        double stopEt,
+        int numRecords,
+        std::string target,
+        std::string observer,
+        std::string frame,
+        std::string abcorr,
+        std::string mission="",
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        std::vector<std::string> spkQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous getTargetOrientations, see getTargetOrientations for the parameters
+     *
+     * @return future of getTargetOrientations's result
+     **/
+    std::future<std::pair<std::vector<std::vector<double>>, nlohmann::json>> getTargetOrientationsAsync(
+        std::vector<double> ets,
+        int toFrame,
+        int refFrame,
+        std::string mission="",
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous getTargetOrientationsRanged, see getTargetOrientationsRanged for the parameters
+     *
+     * @return future of getTargetOrientationsRanged's result
+     **/
+    std::future<std::pair<std::vector<std::vector<double>>, nlohmann::json>> getTargetOrientationsRangedAsync(
+        double startEt,
+        double stopEt,
+        int numRecords,
+        int toFrame,
+        int refFrame,
+        std::string mission="",
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous strSclkToEt, see strSclkToEt for the parameters
+     *
+     * @return future of strSclkToEt's result
+     **/
+    std::future<std::pair<double, nlohmann::json>> strSclkToEtAsync(
+        int frameCode,
+        std::string sclk,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous doubleSclkToEt, see doubleSclkToEt for the parameters
+     *
+     * @return future of doubleSclkToEt's result
+     **/
+    std::future<std::pair<double, nlohmann::json>> doubleSclkToEtAsync(
+        int frameCode,
+        double sclk,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous doubleEtToSclk, see doubleEtToSclk for the parameters
+     *
+     * @return future of doubleEtToSclk's result
+     **/
+    std::future<std::pair<std::string, nlohmann::json>> doubleEtToSclkAsync(
+        int frameCode,
+        double et,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous strSclkToEtBatch, see strSclkToEtBatch for the parameters
+     *
+     * @return future of strSclkToEtBatch's result
+     **/
+    std::future<std::pair<std::vector<double>, nlohmann::json>> strSclkToEtBatchAsync(
+        int frameCode,
+        std::vector<std::string> sclks,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous doubleSclkToEtBatch, see doubleSclkToEtBatch for the parameters
+     *
+     * @return future of doubleSclkToEtBatch's result
+     **/
+    std::future<std::pair<std::vector<double>, nlohmann::json>> doubleSclkToEtBatchAsync(
+        int frameCode,
+        std::vector<double> sclks,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous doubleEtToSclkBatch, see doubleEtToSclkBatch for the parameters
+     *
+     * @return future of doubleEtToSclkBatch's result
+     **/
+    std::future<std::pair<std::vector<std::string>, nlohmann::json>> doubleEtToSclkBatchAsync(
+        int frameCode,
+        std::vector<double> ets,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous utcToEt, see utcToEt for the parameters
+     *
+     * @return future of utcToEt's result
+     **/
+    std::future<std::pair<double, nlohmann::json>> utcToEtAsync(
+        std::string utc,
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous etToUtc, see etToUtc for the parameters
+     *
+     * @return future of etToUtc's result
+     **/
+    std::future<std::pair<std::string, nlohmann::json>> etToUtcAsync(
+        double et,
+        std::string format="",
+        double precision=0,
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous utcToEtBatch, see utcToEtBatch for the parameters
+     *
+     * @return future of utcToEtBatch's result
+     **/
+    std::future<std::pair<std::vector<double>, nlohmann::json>> utcToEtBatchAsync(
+        std::vector<std::string> utcs,
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous etToUtcBatch, see etToUtcBatch for the parameters
+     *
+     * @return future of etToUtcBatch's result
+     **/
+    std::future<std::pair<std::vector<std::string>, nlohmann::json>> etToUtcBatchAsync(
+        std::vector<double> ets,
+        std::string format="",
+        double precision=0,
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous translateNameToCode, see translateNameToCode for the parameters
+     *
+     * @return future of translateNameToCode's result
+     **/
+    std::future<std::pair<int, nlohmann::json>> translateNameToCodeAsync(
+        std::string frame,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous translateNameToCodeBatch, see translateNameToCodeBatch for the parameters
+     *
+     * @return future of translateNameToCodeBatch's result
+     **/
+    std::future<std::pair<std::vector<int>, nlohmann::json>> translateNameToCodeBatchAsync(
+        std::vector<std::string> frames,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous translateCodeToName, see translateCodeToName for the parameters
+     *
+     * @return future of translateCodeToName's result
+     **/
+    std::future<std::pair<std::string, nlohmann::json>> translateCodeToNameAsync(
+        int frame,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous translateCodeToNameBatch, see translateCodeToNameBatch for the parameters
+     *
+     * @return future of translateCodeToNameBatch's result
+     **/
+    std::future<std::pair<std::vector<std::string>, nlohmann::json>> translateCodeToNameBatchAsync(
+        std::vector<int> frames,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous getFrameInfo, see getFrameInfo for the parameters
+     *
+     * @return future of getFrameInfo's result
+     **/
+    std::future<std::pair<std::vector<int>, nlohmann::json>> getFrameInfoAsync(
+        int frame,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous getFrameInfoBatch, see getFrameInfoBatch for the parameters
+     *
+     * @return future of getFrameInfoBatch's result
+     **/
+    std::future<std::pair<std::vector<std::vector<int>>, nlohmann::json>> getFrameInfoBatchAsync(
+        std::vector<int> frames,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous getTargetFrameInfo, see getTargetFrameInfo for the parameters
+     *
+     * @return future of getTargetFrameInfo's result
+     **/
+    std::future<std::pair<nlohmann::json, nlohmann::json>> getTargetFrameInfoAsync(
+        int targetId,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous findMissionKeywords, see findMissionKeywords for the parameters
+     *
+     * @return future of findMissionKeywords's result
+     **/
+    std::future<std::pair<nlohmann::json, nlohmann::json>> findMissionKeywordsAsync(
+        std::string key,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous findTargetKeywords, see findTargetKeywords for the parameters
+     *
+     * @return future of findTargetKeywords's result
+     **/
+    std::future<std::pair<nlohmann::json, nlohmann::json>> findTargetKeywordsAsync(
+        std::string key,
+        std::string mission="",
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous frameTrace, see frameTrace for the parameters
+     *
+     * @return future of frameTrace's result
+     **/
+    std::future<std::pair<std::vector<std::vector<int>>, nlohmann::json>> frameTraceAsync(
+        double et,
+        int initialFrame,
+        std::string mission="",
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        std::vector<std::string> spkQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous extractExactCkTimes, see extractExactCkTimes for the parameters
+     *
+     * @return future of extractExactCkTimes's result
+     **/
+    std::future<std::pair<std::vector<double>, nlohmann::json>> extractExactCkTimesAsync(
+        double observStart,
+        double observEnd,
+        int targetFrame,
+        std::string mission="",
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous getExactTargetOrientations, see getExactTargetOrientations for the parameters
+     *
+     * @return future of getExactTargetOrientations's result
+     **/
+    std::future<std::pair<std::vector<std::vector<double>>, nlohmann::json>> getExactTargetOrientationsAsync(
+        double startEt,
+        double stopEt,
+        int toFrame,
+        int refFrame,
+        int exactCkFrame,
+        std::string mission="",
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool searchKernels=true,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        std::vector<std::string> kernelList={});
+
+
+    /**
+     * @brief Asynchronous searchForKernelsets, see searchForKernelsets for the parameters
+     *
+     * @return future of searchForKernelsets's result
+     **/
+    std::future<std::pair<std::string, nlohmann::json>> searchForKernelsetsAsync(
+        std::vector<std::string> spiceqlNames,
+        std::vector<std::string> types={"ck", "spk", "tspk", "lsk", "mk", "sclk", "iak", "ik", "fk", "dsk", "pck", "ek"},
+        double startTime=-std::numeric_limits<double>::max(),
+        double stopTime=std::numeric_limits<double>::max(),
+        std::vector<std::string> ckQualities={"smithed", "reconstructed"},
+        std::vector<std::string> spkQualities={"smithed", "reconstructed"},
+        bool useWeb=false,
+        bool fullKernelPath=false,
+        int limitCk=-1,
+        int limitSpk=1,
+        bool overwrite=false);
+
+
+    /**
+     * @brief Asynchronous getKernelCoverage, see getKernelCoverage for the parameters
+     *
+     * @return future of getKernelCoverage's result
+     **/
+    std::future<std::pair<nlohmann::json, nlohmann::json>> getKernelCoverageAsync(
+        std::string mission,
+        std::string type="ck",
+        std::vector<std::string> qualities={"smithed", "reconstructed"},
+        double startTime=-std::numeric_limits<double>::max(),
+        double stopTime=std::numeric_limits<double>::max(),
+        int naifCode=0,
+        bool useWeb=false);
+}
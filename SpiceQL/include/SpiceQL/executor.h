@@ -0,0 +1,130 @@
+#pragma once
+/**
+ * @file
+ *
+ * Task queues that run SpiceQL work off the calling thread
+ *
+ **/
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace SpiceQL {
+
+  /**
+   * @brief A fixed set of threads running tasks in the order they are submitted
+   *
+   * Destroying a queue waits for the tasks already submitted to finish.
+   */
+  class TaskQueue {
+    public:
+      /**
+       * @brief Start a queue
+       *
+       * @param threads number of threads running tasks, at least 1
+       * @param name name used in log messages
+       */
+      TaskQueue(size_t threads, std::string name);
+
+      ~TaskQueue();
+
+      TaskQueue(const TaskQueue &) = delete;
+      TaskQueue &operator=(const TaskQueue &) = delete;
+
+      /**
+       * @brief Queue a task
+       *
+       * @param fn callable taking no arguments
+       * @return future of fn's result, exceptions thrown by fn are rethrown by get()
+       */
+      template <typename Fn>
+      std::future<std::invoke_result_t<Fn>> submit(Fn fn) {
+        using Result = std::invoke_result_t<Fn>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+        std::future<Result> result = task->get_future();
+        post([task]() { (*task)(); });
+        return result;
+      }
+
+      /**
+       * @brief Run a task on the queue and wait for it
+       *
+       * Runs fn directly when called from one of the queue's own threads, so
+       * tasks can call code that uses the queue without deadlocking.
+       *
+       * @param fn callable taking no arguments
+       * @return fn's result
+       */
+      template <typename Fn>
+      std::invoke_result_t<Fn> run(Fn fn) {
+        if (onQueueThread()) {
+          return fn();
+        }
+        return submit(std::move(fn)).get();
+      }
+
+      /**
+       * @brief Check if the calling thread is one of the queue's threads
+       *
+       * @return true if called from a task of this queue
+       */
+      bool onQueueThread() const;
+
+      /**
+       * @brief Get the number of threads running tasks
+       *
+       * @return the number of threads
+       */
+      size_t threadCount() const { return m_threads.size(); }
+
+    private:
+      void post(std::function<void()> task);
+      void work();
+
+      std::string m_name;
+      std::vector<std::thread> m_threads;
+      std::mutex m_mutex;
+      std::condition_variable m_ready;
+      std::deque<std::function<void()>> m_tasks;
+      bool m_stopping = false;
+  };
+
+
+  /**
+   * @brief Exclusive use of CSPICE for the lifetime of the guard
+   *
+   * CSPICE keeps the kernel pool and error state in globals, so everything
+   * that calls it holds a guard: API functions from furnishing their kernels
+   * until they are unloaded, and lower level functions around their own calls.
+   * Guards are recursive, a thread that holds one can take more. Searches,
+   * DB lookups and JSON work run outside of guards, in parallel.
+   */
+  class CspiceGuard {
+    public:
+      CspiceGuard();
+      ~CspiceGuard();
+
+      CspiceGuard(const CspiceGuard &) = delete;
+      CspiceGuard &operator=(const CspiceGuard &) = delete;
+  };
+
+
+  /**
+   * @brief The queue running asynchronous API calls
+   *
+   * Runs tasks in parallel on one thread per core. Tasks that use CSPICE
+   * take a CspiceGuard around those spans only.
+   *
+   * @return A reference to the global worker queue
+   */
+  TaskQueue &workerPool();
+}
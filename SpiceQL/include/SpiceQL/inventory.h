@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <tuple>
+#include <utility>
 #include <limits>
 
 #include <nlohmann/json.hpp>
@@ -17,6 +18,19 @@
 
 namespace SpiceQL {
     namespace Inventory { 
+        /**
+         * @brief Kernel limit that selects the minimal covering set.
+         *
+         * Passing this as limit_ck or limit_spk walks the overlapping kernels from
+         * highest to lowest load priority and keeps only the ones that add coverage
+         * of the requested time range not already provided by a higher priority
+         * kernel. Any part of the range left uncovered is reported under
+         * "<spiceql_name>_ck_coverage" / "<spiceql_name>_spk_coverage" as
+         * {"gaps": [[start, stop], ...]}. When no kernel overlaps the range,
+         * the whole range is reported as the only gap.
+         */
+        const int LIMIT_MINIMAL_COVER = -2;
+
         nlohmann::json search_for_kernelset(std::string spiceql_name, std::vector<std::string> types=KERNEL_TYPES, double start_time=-std::numeric_limits<double>::max(), double stop_time=std::numeric_limits<double>::max(), 
                                       std::vector<std::string> ckQualities={"smithed", "reconstructed"}, std::vector<std::string> spkQualities={"smithed", "reconstructed"}, bool full_kernel_path=false, int limit_ck=-1, int limit_spk=1);
         nlohmann::json search_for_kernelsets(std::vector<std::string> spiceql_names, std::vector<std::string> types=KERNEL_TYPES, double start_time=-std::numeric_limits<double>::max(), double stop_time=std::numeric_limits<double>::max(), 
@@ -24,6 +38,25 @@ namespace SpiceQL {
                                       bool overwrite=false);    
         nlohmann::json search_for_kernelset_from_regex(std::vector<std::string> list, bool full_kernel_path=false);
 
+        /**
+         * @brief Get the merged coverage windows and gaps of a mission's CKs or SPKs.
+         *
+         * Computed from the time index in the database, no kernels are furnished.
+         * Each quality is reported separately; qualities without kernels are omitted.
+         * Without explicit bounds, gaps are only reported between coverage windows.
+         *
+         * @param spiceql_name mission name
+         * @param type "ck" or "spk"
+         * @param qualities kernel qualities to report
+         * @param start_time start of the range to report on
+         * @param stop_time stop of the range to report on
+         * @param naif_code only report coverage of this NAIF code, 0 for all codes
+         * @return {"<quality>": {"windows": [[start, stop], ...], "gaps": [[start, stop], ...]}, ...}
+         */
+        nlohmann::json getCoverage(std::string spiceql_name, std::string type="ck", std::vector<std::string> qualities={"smithed", "reconstructed"},
+                                   double start_time=-std::numeric_limits<double>::max(), double stop_time=std::numeric_limits<double>::max(),
+                                   int naif_code=0);
+
         std::string getDbFilePath();
         void setDbFilePath(std::string db_file_path, bool override=false);
 
@@ -54,5 +87,82 @@ namespace SpiceQL {
          * @return the code, or 0 if not in the cache
          */
         int getFrameCodeFromCache(std::string name);
+
+        /**
+         * @brief Get a counter that changes whenever the cached frame tables are reloaded.
+         *
+         * Cheap enough to call per lookup; it does not read the database unless
+         * the cache is due for revalidation.
+         *
+         * @return the generation of the frame cache
+         */
+        unsigned long long getFrameCacheGeneration();
+
+        /**
+         * @brief Get every code<->name pair of the cached frame map.
+         *
+         * @return (code, name) pairs sorted by code
+         */
+        std::vector<std::pair<int, std::string>> getFrameCodeNamesFromCache();
+
+        /**
+         * @brief Get the center, class and class ID of a frame from the cached frame info.
+         *
+         * Same values as frinfo_c with the mission's and the base FKs and IKs
+         * furnished, without furnishing any kernels.
+         *
+         * @param code NAIF frame code
+         * @param mission mission whose kernels define the frame
+         * @return {center, class, class ID}, or empty if the frame is not in the
+         *         cache or missions define it differently and none of them is given
+         */
+        std::vector<int> getFrameInfoFromCache(int code, std::string mission);
+
+        /**
+         * @brief Get the frame info of many frames from the cached frame info.
+         *
+         * @param codes NAIF frame codes
+         * @param mission mission whose kernels define the frames
+         * @return {center, class, class ID} per code, empty for codes not in the cache
+         */
+        std::vector<std::vector<int>> getFrameInfoFromCache(std::vector<int> codes, std::string mission);
+
+        /**
+         * @brief Get the frame associated with a body from the cache.
+         *
+         * Same result as cidfrm_c with the mission's and the base FKs furnished.
+         *
+         * @param body NAIF body code
+         * @param mission mission whose kernels may change the association
+         * @return the frame code and name, or {0, ""} if the body is not in the cache
+         */
+        std::pair<int, std::string> getTargetFrameFromCache(int body, std::string mission);
+
+        /**
+         * @brief Get the parent frame and constant rotation of a TK frame from the cache.
+         *
+         * Same values as tkfram_ with the mission's and the base FKs and IKs
+         * furnished, without furnishing any kernels.
+         *
+         * @param code NAIF frame code of a TK frame
+         * @param mission mission whose kernels define the frame
+         * @return the parent frame code and the 9 elements of the rotation to
+         *         it in column major order, or {0, {}} if the frame is not cached
+         */
+        std::pair<int, std::vector<double>> getTkFrameFromCache(int code, std::string mission);
+
+
+        /**
+         * @brief Find keywords of a mission's IK, FK and IAK keyword pool stored in the DB.
+         *
+         * Same keywords and values as findMissionKeywords, without reading or
+         * furnishing any kernels.
+         *
+         * @param keytpl name template, e.g. "INS-85600_*"
+         * @param mission mission whose pool to search
+         * @return json object of the matching keywords, or null if the DB has no
+         *         pool for the mission
+         */
+        nlohmann::json findMissionKeywordsFromCache(std::string keytpl, std::string mission);
     }
 }
@@ -6,9 +6,11 @@
  *
  **/
 
+#include <map>
 #include <string>
 #include <vector>
 #include <tuple>
+#include <utility>
 #include <limits>
 
 // The BTree submodule's disk_fixed_alloc.h only defines the stdpmr namespace
@@ -33,12 +35,56 @@ namespace SpiceQL {
   extern std::string DB_TIME_FILES_KEY;
   extern std::string DB_SS_TIME_INDICES_KEY;
   extern std::string DB_SPICE_ROOT_KEY;
+  // Per-kernel coverage windows, flattened across all files of a key. The
+  // windows of file i are [offsets[i], offsets[i+1]) in the start/stop arrays.
+  extern std::string DB_COVERAGE_START_KEY;
+  extern std::string DB_COVERAGE_STOP_KEY;
+  extern std::string DB_COVERAGE_OFFSETS_KEY;
+  // Merged coverage windows of each NAIF code across all files of a key, laid
+  // out the same way with one offset range per entry of the codes array.
+  extern std::string DB_BODY_CODES_KEY;
+  extern std::string DB_BODY_COVERAGE_START_KEY;
+  extern std::string DB_BODY_COVERAGE_STOP_KEY;
+  extern std::string DB_BODY_COVERAGE_OFFSETS_KEY;
   // Precomputed frame caches (built during create_database) so runtime
   // resolution never needs to furnish slow FKs. Stored under one group.
   extern std::string DB_FRAME_CACHE_KEY;
   extern std::string DB_FRAME_LIST_KEY;
   extern std::string DB_FRAME_CODES_KEY;
   extern std::string DB_FRAME_NAMES_KEY;
+  // frinfo_c of every enumerated frame as aligned arrays. Mission "" holds
+  // the codes every mission's kernels agree on, "base" and other missions
+  // only the codes they disagree on.
+  extern std::string DB_FRAME_INFO_MISSIONS_KEY;
+  extern std::string DB_FRAME_INFO_CODES_KEY;
+  extern std::string DB_FRAME_INFO_CENTERS_KEY;
+  extern std::string DB_FRAME_INFO_CLASSES_KEY;
+  extern std::string DB_FRAME_INFO_CLASS_IDS_KEY;
+  // cidfrm_c body -> frame associations as aligned arrays. Mission "" holds
+  // NAIF's built-in association, other missions only where their kernels
+  // change it.
+  extern std::string DB_BODY_FRAME_MISSIONS_KEY;
+  extern std::string DB_BODY_FRAME_BODIES_KEY;
+  extern std::string DB_BODY_FRAME_CODES_KEY;
+  extern std::string DB_BODY_FRAME_NAMES_KEY;
+  // Parent frame and constant rotation (9 doubles per frame, in the column
+  // major order tkfram_ returns them) of every TK frame, as aligned arrays
+  // with missions as in DB_FRAME_INFO_MISSIONS_KEY.
+  extern std::string DB_TK_FRAME_MISSIONS_KEY;
+  extern std::string DB_TK_FRAME_CODES_KEY;
+  extern std::string DB_TK_FRAME_PARENTS_KEY;
+  extern std::string DB_TK_FRAME_ROTATIONS_KEY;
+  // Keyword pool of each mission's latest IK, FK and IAK, in one group per
+  // mission under DB_MISSION_KEYWORDS_KEY. Names are sorted; keyword i has
+  // counts[i] values starting at starts[i] in numbers (kind 0) or strings
+  // (kind 1).
+  extern std::string DB_MISSION_KEYWORDS_KEY;
+  extern std::string DB_KEYWORD_NAMES_KEY;
+  extern std::string DB_KEYWORD_KINDS_KEY;
+  extern std::string DB_KEYWORD_STARTS_KEY;
+  extern std::string DB_KEYWORD_COUNTS_KEY;
+  extern std::string DB_KEYWORD_NUMBERS_KEY;
+  extern std::string DB_KEYWORD_STRINGS_KEY;
 
   std::string getCacheDir();
   void setCacheDir(std::string cache_dir, bool override=false);
@@ -49,6 +95,59 @@ namespace SpiceQL {
     frozenca::BTreeMap<double, size_t> start_times; 
     frozenca::BTreeMap<double, size_t> stop_times; 
     std::vector<std::string> file_paths; 
+
+    // Merged coverage windows of every file, flattened. The windows of
+    // file_paths[i] are coverage_starts/coverage_stops in the index range
+    // [coverage_offsets[i], coverage_offsets[i+1]).
+    std::vector<double> coverage_starts;
+    std::vector<double> coverage_stops;
+    std::vector<size_t> coverage_offsets;
+
+    // Merged coverage windows of each NAIF code across all files.
+    std::map<int, std::vector<std::pair<double, double>>> body_coverage;
+
+    /**
+     * @brief Append the coverage windows of the next file.
+     *
+     * Must be called once per file, in the same order as file_paths.
+     */
+    void addCoverage(const std::vector<std::pair<double, double>> &intervals);
+
+    /**
+     * @brief True when per-file coverage windows are available for every file.
+     *
+     * Databases written before coverage windows were stored only have the
+     * min/max bounds.
+     */
+    bool hasCoverage() const;
+
+    /**
+     * @brief Check whether file index has data anywhere in [start, stop].
+     *
+     * Falls back to true when no windows are known for the file, so callers
+     * keep the min/max bounds behavior.
+     */
+    bool covers(size_t index, double start, double stop) const;
+
+    /**
+     * @brief Get the merged coverage windows of file index.
+     *
+     * @return the windows, or an empty vector when none are known
+     */
+    std::vector<std::pair<double, double>> getCoverage(size_t index) const;
+  };
+
+
+  /**
+   * @brief One mission's keyword pool as aligned arrays, see DB_MISSION_KEYWORDS_KEY.
+   */
+  struct MissionKeywordTable {
+    std::vector<std::string> names;
+    std::vector<int> kinds;
+    std::vector<size_t> starts;
+    std::vector<size_t> counts;
+    std::vector<double> numbers;
+    std::vector<std::string> strings;
   };
 
 
@@ -68,15 +167,97 @@ namespace SpiceQL {
 
     /**
      * @brief Resolve a frame/body code to its name using the cached map.
+     *
+     * Reads an immutable snapshot of the DB's frame tables without locking.
+     * The DB file is checked for changes at most once a second.
+     *
      * @return the name, or "" if the code is not in the cache.
      */
-    std::string getFrameName(int code);
+    static std::string getFrameName(int code);
 
     /**
      * @brief Resolve a frame/body name to its code using the cached map.
+     *
+     * Reads an immutable snapshot of the DB's frame tables without locking.
+     * The DB file is checked for changes at most once a second.
+     *
      * @return the code, or 0 if the name is not in the cache.
      */
-    int getFrameCode(std::string name);
+    static int getFrameCode(std::string name);
+
+    /**
+     * @brief Get the generation of the frame cache snapshot.
+     *
+     * Changes whenever the snapshot is reloaded because the DB changed, so
+     * callers deriving their own tables from the DB know when to rebuild them.
+     */
+    static unsigned long long getFrameCacheGeneration();
+
+    /**
+     * @brief Get every code<->name pair of the frame cache, sorted by code.
+     */
+    static std::vector<std::pair<int, std::string>> getFrameCodeNames();
+
+    /**
+     * @brief Get the center, class and class ID of a frame from the cache, like frinfo_c.
+     *
+     * Uses the info of the mission's kernels, then of the base kernels, then
+     * the one every mission agrees on.
+     *
+     * @return {center, class, class ID}, or empty if the frame is not in the cache.
+     */
+    static std::vector<int> getFrameInfo(int code, std::string mission);
+
+    /**
+     * @brief Get the frame associated with a body from the cache, like cidfrm_c.
+     *
+     * Uses the association of the mission's kernels, then of the base
+     * kernels, then NAIF's built-in one.
+     *
+     * @return the frame code and name, or {0, ""} if the body is not in the cache.
+     */
+    static std::pair<int, std::string> getBodyFrame(int body, std::string mission);
+
+    /**
+     * @brief Get the parent frame and constant rotation of a TK frame from the cache, like tkfram_.
+     *
+     * Looks the mission up the same way as getFrameInfo.
+     *
+     * @return the parent frame code and the 9 rotation elements in column major
+     *         order, or {0, {}} if the frame is not a cached TK frame.
+     */
+    static std::pair<int, std::vector<double>> getTkFrame(int code, std::string mission);
+
+    /**
+     * @brief Find keywords of a mission's IK, FK and IAK pool stored in the DB.
+     *
+     * Each mission's pool is read from the DB once and indexed by name, so a
+     * template with a literal prefix (e.g. "INS-85600_*") only checks the
+     * names sharing that prefix. Reread when the DB changes.
+     *
+     * @param keytpl name template, see matchesKeywordTemplate
+     * @param mission mission whose pool to search
+     * @return json object of the matching keywords formatted like findKeywords,
+     *         or null if the DB has no pool for the mission
+     */
+    static nlohmann::json findMissionKeywords(std::string keytpl, std::string mission);
+
+    /**
+     * @brief Get the merged coverage windows and gaps of a mission's kernels.
+     *
+     * Answered from the time index in the DB, no kernels are furnished.
+     *
+     * @param spiceql_name mission name
+     * @param type CK or SPK
+     * @param qualities kernel qualities to report, each reported separately
+     * @param start_time start of the range to report on
+     * @param stop_time stop of the range to report on
+     * @param naif_code only report coverage of this NAIF code, 0 for all codes
+     * @return {"<quality>": {"windows": [[start, stop], ...], "gaps": [[start, stop], ...]}, ...}
+     */
+    nlohmann::json getCoverage(std::string spiceql_name, Kernel::Type type, std::vector<Kernel::Quality> qualities,
+                               double start_time=-std::numeric_limits<double>::max(), double stop_time=std::numeric_limits<double>::max(),
+                               int naif_code=0);
     nlohmann::json search_for_kernelset(std::string spiceql_name, std::vector<Kernel::Type> types, double start_time=-std::numeric_limits<double>::max(), double stop_time=std::numeric_limits<double>::max(),
                                             std::vector<Kernel::Quality> ckQualities={Kernel::Quality::SMITHED, Kernel::Quality::RECONSTRUCTED}, std::vector<Kernel::Quality> spkQualities={Kernel::Quality::SMITHED, Kernel::Quality::RECONSTRUCTED},
                                             bool full_kernel_path=false, int limit_ck=-1, int limit_spk=1);
@@ -95,16 +276,49 @@ namespace SpiceQL {
     // the data twice.
     std::vector<int> m_frame_codes;
     std::vector<std::string> m_frame_names;
-
-    // Kernels that always need to be furnished
-    KernelSet m_required_kernels;
+    // Center, class and class ID of each frame in m_frame_info_codes, see
+    // DB_FRAME_INFO_MISSIONS_KEY.
+    std::vector<std::string> m_frame_info_missions;
+    std::vector<int> m_frame_info_codes;
+    std::vector<int> m_frame_info_centers;
+    std::vector<int> m_frame_info_classes;
+    std::vector<int> m_frame_info_class_ids;
+    // Body -> frame associations, see DB_BODY_FRAME_MISSIONS_KEY.
+    std::vector<std::string> m_body_frame_missions;
+    std::vector<int> m_body_frame_bodies;
+    std::vector<int> m_body_frame_codes;
+    std::vector<std::string> m_body_frame_names;
+    // TK frame edges, see DB_TK_FRAME_MISSIONS_KEY.
+    std::vector<std::string> m_tk_frame_missions;
+    std::vector<int> m_tk_frame_codes;
+    std::vector<int> m_tk_frame_parents;
+    std::vector<double> m_tk_frame_rotations;
+    // Keyword pools by mission, see DB_MISSION_KEYWORDS_KEY.
+    std::map<std::string, MissionKeywordTable> m_mission_keywords;
 
     private:
     /**
      * @brief Enumerate frame/body code<->name pairs and the frame list into the
      * member caches. Furnishes each mission's text kernels, reads the
      * NAIF_BODY_CODE/NAIF_BODY_NAME pools, and records the config frame list.
+     * Also records frinfo_c of every frame, cidfrm_c of every body seen and
+     * tkfram_ of every TK frame.
      */
     void collectFrameInfo();
+
+    /**
+     * @brief Snapshot the keyword pool of each mission's latest IK, FK and IAK
+     * into m_mission_keywords. The kernels are parsed natively, not furnished.
+     */
+    void collectMissionKeywords();
+
+    /**
+     * @brief Read the time index of key (mission/type/quality) from the DB.
+     *
+     * @param key DB key of the time index
+     * @param with_bodies also read the per NAIF code coverage windows
+     * @return the index owned by the caller, or nullptr if the key is not in the DB
+     */
+    TimeIndexedKernels *loadTimeIndexedKernels(std::string key, bool with_bodies=false);
   };
 }
@@ -0,0 +1,145 @@
+#pragma once
+/**
+ * @file
+ *
+ * Worker processes that run local queries on several cores
+ *
+ **/
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace SpiceQL {
+
+  /**
+   * @brief A supervisor for worker processes, each with its own CSPICE
+   *
+   * CSPICE keeps one kernel pool per process, so one process can only run one
+   * query at a time. The engine starts workers that each run queries with their
+   * own CSPICE, and while an engine is active the API functions send their
+   * local (not useWeb) queries to it with the same arguments a useWeb query
+   * sends to the REST service. Callers do not change.
+   *
+   * Requests and responses are MessagePack. They are passed through a shared
+   * memory region of each worker and only the size goes through the worker's
+   * Unix socket, payloads larger than the region are sent over the socket.
+   *
+   * Workers run the spiceql-worker executable. They are not copies of the
+   * host, so no lock another thread of the host holds ends up in a worker,
+   * and the engine can start and replace workers at any time from any
+   * thread. Workers get the host's environment, cache directory and aliases
+   * when they start and keep their own caches warm across queries. A worker
+   * that exits or does not answer within the timeout is killed and replaced.
+   * Not available on Windows.
+   */
+  class LocalEngine {
+    public:
+      /**
+       * @brief Start the workers
+       *
+       * The worker executable is SPICEQL_LOCAL_ENGINE_WORKER if set, else
+       * spiceql-worker next to the SpiceQL library, in the bin directory next
+       * to its lib directory, or on the PATH.
+       *
+       * @param workers number of worker processes, at least 1
+       * @param sharedMemorySize bytes of shared memory per worker
+       * @param timeout how long a worker may take to answer before it is replaced
+       * @throws runtime_error if the executable is not found or a worker does not start
+       */
+      LocalEngine(size_t workers, size_t sharedMemorySize=64 * 1024 * 1024,
+                  std::chrono::seconds timeout=std::chrono::seconds(600));
+
+      /**
+       * @brief Wait for running queries, then stop the workers
+       */
+      ~LocalEngine();
+
+      LocalEngine(const LocalEngine &) = delete;
+      LocalEngine &operator=(const LocalEngine &) = delete;
+
+      /**
+       * @brief Run a query on an idle worker, waiting for one if all are busy
+       *
+       * @param functionName API function name, as used by the REST service
+       * @param args the function's arguments by parameter name, useWeb excluded
+       * @return the response, {"statusCode": 200, "body": {"return": ..., "kernels": ...}} like a useWeb query
+       * @throws invalid_argument, out_of_range or runtime_error as thrown by the function in the worker,
+       *         runtime_error if the worker exited or timed out
+       */
+      nlohmann::json query(const std::string &functionName, const nlohmann::json &args);
+
+      /**
+       * @brief Get the number of worker processes
+       *
+       * @return the number of workers
+       */
+      size_t workerCount() const { return m_workers.size(); }
+
+      /**
+       * @brief Start the engine that API functions use
+       *
+       * Replaces an engine that was already started.
+       *
+       * @param workers number of worker processes, at least 1
+       * @param sharedMemorySize bytes of shared memory per worker
+       * @param timeout how long a worker may take to answer before it is replaced
+       */
+      static void start(size_t workers, size_t sharedMemorySize=64 * 1024 * 1024,
+                        std::chrono::seconds timeout=std::chrono::seconds(600));
+
+      /**
+       * @brief Stop the engine that API functions use, queries run in process again
+       */
+      static void stop();
+
+      /**
+       * @brief Get the engine that API functions use
+       *
+       * The first call starts an engine when SPICEQL_LOCAL_ENGINE_WORKERS is
+       * set to the number of workers, with SPICEQL_LOCAL_ENGINE_SHM_MB
+       * megabytes of shared memory per worker (64 by default) and a timeout of
+       * SPICEQL_LOCAL_ENGINE_TIMEOUT seconds (600 by default).
+       *
+       * @return the engine, nullptr if none was started or if called in a worker
+       */
+      static std::shared_ptr<LocalEngine> active();
+
+      /**
+       * @brief Run a worker until the engine closes its socket, the main of spiceql-worker
+       *
+       * @param argc argument count
+       * @param argv the worker's socket, shared memory descriptor and shared memory size, as passed by the engine
+       * @return the exit status
+       */
+      static int runWorker(int argc, char **argv);
+
+    private:
+      struct Worker {
+        int pid = -1;
+        int socket = -1;
+        int sharedMemoryFd = -1;
+        unsigned char *sharedMemory = nullptr;
+        bool busy = false;
+      };
+
+      void spawn(Worker &worker);
+      bool receive(Worker &worker, std::vector<uint8_t> &bytes);
+      void reap(Worker &worker);
+      void unmap(Worker &worker);
+
+      std::vector<Worker> m_workers;
+      std::string m_executable;
+      size_t m_sharedMemorySize;
+      std::chrono::seconds m_timeout;
+      std::mutex m_mutex;
+      std::condition_variable m_idle;
+  };
+}
@@ -15,6 +15,7 @@
 #include <string>
 #include <chrono>
 #include <iomanip>
+#include <mutex>
 
 #include <ghc/fs_std.hpp>
 #include <SpiceQL/spiceql_logging.h>
@@ -96,9 +97,8 @@ namespace Memo {
 
 
     inline std::string getCacheDir() { 
-        static std::string  CACHE_DIRECTORY = "";
-	// return "/home/ec2-user/efs_prod/spiceql_cache/";
-        if (CACHE_DIRECTORY == "") { 
+        // initialized once, even when first called from several threads
+        static const std::string CACHE_DIRECTORY = []() {
             const char* cache_dir_char = getenv("SPICEQL_CACHE_DIR");
         
             std::string cache_dir;
@@ -116,13 +116,11 @@ namespace Memo {
                 fs::create_directories(cache_dir); 
             }
         
-            CACHE_DIRECTORY = cache_dir;
-            SPDLOG_DEBUG("Setting cache directory to: {}", CACHE_DIRECTORY);  
-        } 
-        else { 
-            SPDLOG_TRACE("Cache Directory Already Set: {}", CACHE_DIRECTORY);  
-        }
+            SPDLOG_DEBUG("Setting cache directory to: {}", cache_dir);  
+            return cache_dir;
+        }();
 
+        SPDLOG_TRACE("Cache Directory Already Set: {}", CACHE_DIRECTORY);  
         return CACHE_DIRECTORY;
     }
 
@@ -203,6 +201,13 @@ namespace Memo {
         public: 
         mutable std::map<std::size_t, std::any> m_data;
 
+        Memory() = default;
+
+        Memory(const Memory &other) {
+            std::lock_guard<std::mutex> lock(other.m_mutex);
+            m_data = other.m_data;
+        }
+
         template<typename Func, typename... Params>
             auto operator()(const Func& f, Params&&... params) -> decltype(f(params...)) const {
                 return (*this)("anonymous", f, std::forward<Params>(params)...);
@@ -221,16 +226,24 @@ namespace Memo {
         template<typename Func, typename... Params>
             auto operator()(std::size_t seed, const Func& f, Params&&... params) -> decltype(f(params...)) const {
                 typedef decltype(f(params...)) retval_t;
-                auto it = m_data.find(seed);
-                if(it != m_data.end()){
-                    SPDLOG_TRACE("Cached access from memory");
-                    return std::any_cast<retval_t>(it->second);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto it = m_data.find(seed);
+                    if(it != m_data.end()){
+                        SPDLOG_TRACE("Cached access from memory");
+                        return std::any_cast<retval_t>(it->second);
+                    }
                 }
+                // not locked while f runs, threads missing the same seed both compute it
                 retval_t ret = f(std::forward<Params>(params)...);
                 SPDLOG_TRACE("Non-cached access");
+                std::lock_guard<std::mutex> lock(m_mutex);
                 m_data[seed] = ret;
                 return ret;
             }
+
+        private:
+        mutable std::mutex m_mutex;
     };
 
 
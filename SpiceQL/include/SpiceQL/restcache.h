@@ -0,0 +1,157 @@
+#pragma once
+/**
+ * @file
+ *
+ * Opt-in cache of useWeb responses, kept in memory and optionally on disk
+ *
+ **/
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+namespace SpiceQL {
+
+  /**
+   * @brief Bounded cache of REST API responses keyed by function name and arguments
+   *
+   * Entries are kept in memory with least recently used eviction and, when a
+   * directory is given, also written to disk so later sessions can reuse them.
+   * Both copies are bounded by the size of the entries in MessagePack bytes.
+   * Each entry stores the ETag the server sent with it. The server tags
+   * responses with the version of its kernel DB, so an entry is only fresh
+   * while it is younger than the time to live and its ETag matches the newest
+   * one the server has sent. Stale entries of GET requests are revalidated with
+   * If-None-Match instead of being dropped, those of POST requests are fetched
+   * again.
+   */
+  class RestCache {
+    public:
+      /**
+       * @brief A cached response
+       */
+      struct Entry {
+        //! the full response, including statusCode and body
+        nlohmann::json response;
+        //! ETag the server sent with the response, empty if none
+        std::string etag;
+        //! false if the entry has to be revalidated before it is used
+        bool fresh = false;
+      };
+
+      /**
+       * @brief Create a cache
+       *
+       * Responses larger than maxBytes are not cached.
+       *
+       * @param maxBytes most bytes kept in memory and on disk, 0 disables the cache
+       * @param directory directory for the on-disk copy, empty to only cache in memory
+       * @param ttl how long an entry is used without asking the server
+       */
+      RestCache(size_t maxBytes, std::string directory="", std::chrono::seconds ttl=std::chrono::seconds(600));
+
+      /**
+       * @brief Accessor for the cache used by useWeb requests
+       *
+       * Configured once from SPICEQL_REST_CACHE_SIZE (bytes, 0 by default
+       * so the cache is off), SPICEQL_REST_CACHE_DIR (on-disk copy, none by
+       * default) and SPICEQL_REST_CACHE_TTL (seconds, 600 by default).
+       *
+       * @return A reference to the global RestCache instance
+       */
+      static RestCache &instance();
+
+      /**
+       * @brief Build the key of a request
+       *
+       * json objects keep their keys sorted, so equal arguments give equal keys
+       * no matter what order they were set in.
+       *
+       * @param functionName REST function name
+       * @param args request arguments
+       * @return the cache key
+       */
+      static std::string makeKey(const std::string &functionName, const nlohmann::json &args);
+
+      /**
+       * @brief Check if the cache stores anything
+       *
+       * @return false if the cache was created with 0 bytes
+       */
+      bool enabled() const { return m_maxBytes > 0; }
+
+      /**
+       * @brief Look up a response, loading it from disk if it is not in memory
+       *
+       * @param key key from makeKey
+       * @return the cached response, or nothing if there is none
+       */
+      std::optional<Entry> get(const std::string &key);
+
+      /**
+       * @brief Store or refresh a response
+       *
+       * Also records etag as the server's current ETag, so entries stored with
+       * a different one are no longer fresh.
+       *
+       * @param key key from makeKey
+       * @param response the full response
+       * @param etag ETag the server sent with the response, empty if none
+       */
+      void put(const std::string &key, const nlohmann::json &response, const std::string &etag);
+
+      /**
+       * @brief Drop every entry, in memory and on disk
+       */
+      void clear();
+
+      /**
+       * @brief Get the number of entries in memory
+       *
+       * @return the number of entries in memory
+       */
+      size_t size();
+
+      /**
+       * @brief Get the size of the entries in memory
+       *
+       * @return the MessagePack bytes of the entries in memory
+       */
+      size_t bytes();
+
+    private:
+      struct Stored {
+        nlohmann::json response;
+        std::string etag;
+        std::chrono::system_clock::time_point stored;
+        size_t bytes;
+        std::list<std::string>::iterator lru;
+      };
+
+      // insert and pruneDirectory expect m_mutex to be held
+      Stored &insert(const std::string &key, nlohmann::json response, std::string etag,
+                     std::chrono::system_clock::time_point stored, size_t bytes);
+      std::string pathFor(const std::string &key) const;
+      void pruneDirectory();
+
+      size_t m_maxBytes;
+      std::string m_directory;
+      std::chrono::seconds m_ttl;
+
+      std::mutex m_mutex;
+      //! most recently used key first
+      std::list<std::string> m_lru;
+      std::unordered_map<std::string, Stored> m_entries;
+      size_t m_bytes = 0;
+      //! bytes in the directory as of the last scan plus what this process wrote since
+      size_t m_directoryBytes = 0;
+      //! newest ETag the server has sent
+      std::string m_serverEtag;
+  };
+}
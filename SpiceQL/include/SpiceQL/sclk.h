@@ -0,0 +1,145 @@
+#pragma once
+/**
+ * @file
+ *
+ * Native spacecraft clock (SCLK) conversions that do not use the CSPICE kernel pool
+ *
+ **/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "SpiceQL/textkernel.h"
+
+namespace SpiceQL {
+
+  /**
+   * @brief Immutable model of a type 1 spacecraft clock.
+   *
+   * Built by parsing the partition table, field moduli and offsets, and the
+   * coefficient records of one clock out of SCLK kernels. Conversions are const,
+   * allocation free for the numeric forms, and never touch the CSPICE kernel
+   * pool, so one model can be shared by any number of threads.
+   *
+   * Conversions follow NAIF's SCLK type 1 definition and match sct2e_c,
+   * sce2c_c, scs2e_c and sce2s_c.
+   */
+  class SclkModel {
+    public:
+      //! most models, or kernel lists without the clock, kept by load()
+      static const size_t MODEL_CACHE_SIZE = 64;
+
+      /**
+       * @brief Get the model of a clock from a list of SCLK kernels.
+       *
+       * Kernels are read in order and later kernels override keywords set by
+       * earlier ones, as if they were furnished in that order. Models are cached
+       * per kernel list, clock and LSK, and rebuilt when one of the files changes.
+       * Kernels that do not define the clock are cached too, so asking again
+       * rethrows without re-reading them. The cache keeps the most recently
+       * used MODEL_CACHE_SIZE entries.
+       *
+       * @param sclkPaths SCLK kernels to read the clock from
+       * @param clockId NAIF spacecraft clock ID, e.g. -85 for LRO
+       * @param lskPath LSK to read the TDT to TDB constants from, NAIF's standard
+       *                values are used when empty
+       * @return shared, immutable model of the clock
+       * @throws invalid_argument if the kernels do not define a supported clock
+       */
+      static std::shared_ptr<const SclkModel> load(std::vector<std::string> sclkPaths, int clockId, std::string lskPath="");
+
+      /**
+       * @brief Convert continuous encoded SCLK ticks to ephemeris time, like sct2e_c.
+       */
+      double ticksToEt(double ticks) const;
+
+      /**
+       * @brief Convert ephemeris time to continuous encoded SCLK ticks, like sce2c_c.
+       */
+      double etToTicks(double et) const;
+
+      /**
+       * @brief Convert n tick values to ephemeris times.
+       */
+      void ticksToEt(const double *ticks, double *ets, size_t n) const;
+
+      /**
+       * @brief Convert n ephemeris times to tick values.
+       */
+      void etToTicks(const double *ets, double *ticks, size_t n) const;
+
+      /**
+       * @brief Encode an SCLK string such as "1/281199081:48971" to ticks, like scencd_c.
+       */
+      double sclkToTicks(std::string sclk) const;
+
+      /**
+       * @brief Decode ticks to an SCLK string, like scdecd_c.
+       */
+      std::string ticksToSclk(double ticks) const;
+
+      /**
+       * @brief Convert an SCLK string to ephemeris time, like scs2e_c.
+       */
+      double sclkToEt(std::string sclk) const;
+
+      /**
+       * @brief Convert ephemeris time to an SCLK string, like sce2s_c.
+       */
+      std::string etToSclk(double et) const;
+
+      /**
+       * @return the NAIF spacecraft clock ID of the model
+       */
+      int getClockId() const;
+
+    private:
+      SclkModel() = default;
+
+      /**
+       * @brief Read the model of a clock from the kernels, without caching.
+       */
+      static std::shared_ptr<const SclkModel> build(const std::vector<std::string> &sclkPaths, int clockId, const std::string &lskPath);
+
+      /**
+       * @brief Convert parallel time (the clock's time system) to TDB.
+       */
+      double parallelToEt(double parallel) const;
+
+      /**
+       * @brief Convert TDB to parallel time (the clock's time system).
+       */
+      double etToParallel(double et) const;
+
+      int m_clock_id = 0;
+      // 1 = TDB, 2 = TDT
+      int m_time_system = 1;
+      char m_delimiter = '.';
+
+      // Field moduli and offsets, most significant field first, and the number
+      // of ticks in one count of each field.
+      std::vector<double> m_moduli;
+      std::vector<double> m_offsets;
+      std::vector<double> m_field_ticks;
+
+      // Partition start/stop counts and the tick value each partition starts at.
+      std::vector<double> m_partition_starts;
+      std::vector<double> m_partition_ends;
+      std::vector<double> m_partition_ticks;
+
+      // Coefficient records as three aligned arrays: encoded ticks, parallel time
+      // and rate in parallel seconds per most significant count.
+      std::vector<double> m_coeff_ticks;
+      std::vector<double> m_coeff_parallel;
+      std::vector<double> m_coeff_rates;
+
+      // TDT <-> TDB periodic term constants (DELTET/K, DELTET/EB, DELTET/M).
+      double m_k = 1.657e-3;
+      double m_eb = 1.671e-2;
+      double m_m0 = 6.239996;
+      double m_m1 = 1.99096871e-7;
+  };
+}
@@ -0,0 +1,152 @@
+#pragma once
+/**
+ * @file
+ *
+ * Coalescing of identical concurrent API calls
+ *
+ **/
+
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+namespace SpiceQL {
+
+  /**
+   * @brief Runs one computation for identical calls that are in flight at the same time
+   *
+   * The first call with a key computes the result. Calls with the same key
+   * that arrive before it finishes wait for it and get a copy of its result,
+   * or its exception. A waiting call gives up after the maximum wait and
+   * computes the result itself. Nothing is cached, once the computation
+   * finishes the next call with the key computes again.
+   */
+  class SingleFlight {
+    public:
+      /**
+       * @brief Counters of a key, or of all keys
+       */
+      struct Stats {
+        //! calls that computed the result
+        uint64_t computed = 0;
+        //! calls that shared the result of a call in flight
+        uint64_t shared = 0;
+        //! calls that waited the maximum time and then computed the result themselves
+        uint64_t timedOut = 0;
+      };
+
+      /**
+       * @brief Create a coalescer
+       *
+       * @param enabled false to run every call by itself
+       * @param maxWait longest a call waits for the call in flight with its key
+       * @param maxTrackedKeys most keys with their own Stats, later keys only count in the totals
+       */
+      SingleFlight(bool enabled, std::chrono::milliseconds maxWait=std::chrono::seconds(30), size_t maxTrackedKeys=1024);
+
+      /**
+       * @brief Accessor for the coalescer used by the API
+       *
+       * Configured once from SPICEQL_SINGLE_FLIGHT ("true" to coalesce, off
+       * by default) and SPICEQL_SINGLE_FLIGHT_WAIT_MS (30000 by default).
+       *
+       * @return A reference to the global SingleFlight instance
+       */
+      static SingleFlight &instance();
+
+      /**
+       * @brief Build the key of a call
+       *
+       * json objects keep their keys sorted, so equal arguments give equal keys
+       * no matter what order they were set in. The arguments are kept as a
+       * SHA-256 digest of their JSON, so keys stay small however many ETs a
+       * call has.
+       *
+       * @param functionName API function name
+       * @param args all of the call's arguments
+       * @return the function name and the digest, "<functionName>?<hex digest>"
+       */
+      static std::string makeKey(const std::string &functionName, const nlohmann::json &args);
+
+      /**
+       * @brief Turn coalescing on or off
+       *
+       * Calls already waiting on a call in flight still get its result.
+       *
+       * @param enabled false to run every call by itself
+       */
+      void setEnabled(bool enabled);
+
+      /**
+       * @brief Check if calls made by the current thread should be coalesced
+       *
+       * False while the thread computes a result for run(), so the function
+       * being coalesced can call itself to do the work.
+       *
+       * @return true if enabled and not computing a result
+       */
+      bool shouldCoalesce() const;
+
+      /**
+       * @brief Run fn, or wait for the call in flight with the same key
+       *
+       * @param key the call's key, see makeKey
+       * @param fn computes the result
+       * @return fn's result, possibly computed by another call
+       */
+      template <typename T>
+      T run(const std::string &key, const std::function<T()> &fn) {
+        return std::any_cast<T>(runAny(key, [&fn]() { return std::any(fn()); }));
+      }
+
+      /**
+       * @brief Get the counters of a key
+       *
+       * @param key the key, see makeKey
+       * @return the key's counters, all 0 if it was never seen or is not tracked
+       */
+      Stats stats(const std::string &key);
+
+      /**
+       * @brief Get the counters of all keys together
+       *
+       * @return the total counters
+       */
+      Stats totalStats();
+
+      /**
+       * @brief Get the counters of every tracked key
+       *
+       * @return the counters by key
+       */
+      std::map<std::string, Stats> allStats();
+
+      /**
+       * @brief Reset all counters
+       */
+      void resetStats();
+
+    private:
+      std::any runAny(const std::string &key, const std::function<std::any()> &fn);
+      void count(const std::string &key, uint64_t Stats::*counter);
+
+      std::atomic<bool> m_enabled;
+      std::chrono::milliseconds m_maxWait;
+      size_t m_maxTrackedKeys;
+      std::mutex m_mutex;
+      std::unordered_map<std::string, std::shared_future<std::any>> m_inFlight;
+      std::map<std::string, Stats> m_stats;
+      Stats m_total;
+  };
+}
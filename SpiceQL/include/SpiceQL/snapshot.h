@@ -0,0 +1,116 @@
+#pragma once
+/**
+ * @file
+ *
+ * Immutable tables that readers use without locking while writers replace them
+ *
+ **/
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace SpiceQL {
+
+  /**
+   * @brief Keeps the snapshots the calling thread loads alive until it goes out of scope
+   *
+   * Announces the current epoch in a slot of the calling thread, so entering
+   * and leaving take no lock and allocate nothing after a thread's first
+   * guard. Guards nest, the outermost one of a thread announces the epoch.
+   */
+  class SnapshotReadGuard {
+    public:
+      SnapshotReadGuard();
+      ~SnapshotReadGuard();
+
+      SnapshotReadGuard(const SnapshotReadGuard &) = delete;
+      SnapshotReadGuard &operator=(const SnapshotReadGuard &) = delete;
+  };
+
+
+  /**
+   * @brief Advance the snapshot epoch
+   *
+   * @return the epoch a snapshot replaced now is retired in
+   */
+  unsigned long long retireSnapshotEpoch();
+
+
+  /**
+   * @brief Get the oldest epoch a SnapshotReadGuard is still in
+   *
+   * Snapshots retired in a later epoch than the returned one are no longer
+   * used by any reader.
+   *
+   * @return the oldest announced epoch, or the current one if no guard is active
+   */
+  unsigned long long oldestSnapshotEpoch();
+
+
+  /**
+   * @brief An immutable value replaced as a whole
+   *
+   * Readers load the value inside a SnapshotReadGuard without locking.
+   * Writers must be serialized by the caller. A replaced value is retired and
+   * freed by a later publish once no guard that may have loaded it is left.
+   */
+  template <typename T>
+  class Snapshot {
+    public:
+      Snapshot() = default;
+
+      /**
+       * @brief Free the current and retired values, no reader may be left
+       */
+      ~Snapshot() {
+        delete m_current.load(std::memory_order_relaxed);
+      }
+
+      Snapshot(const Snapshot &) = delete;
+      Snapshot &operator=(const Snapshot &) = delete;
+
+      /**
+       * @brief Get the current value, only valid inside a SnapshotReadGuard or while holding the writers' lock
+       *
+       * @return the value, nullptr if none was published yet
+       */
+      const T *load() const {
+        return m_current.load(std::memory_order_seq_cst);
+      }
+
+      /**
+       * @brief Replace the value and free the retired values no reader uses anymore
+       *
+       * @param value the new value
+       * @return the published value
+       */
+      const T *publish(std::unique_ptr<const T> value) {
+        const T *published = value.release();
+        const T *replaced = m_current.exchange(published, std::memory_order_seq_cst);
+        if (replaced) {
+          m_retired.emplace_back(retireSnapshotEpoch(), std::unique_ptr<const T>(replaced));
+        }
+
+        unsigned long long oldest = oldestSnapshotEpoch();
+        m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(),
+                                       [oldest](const auto &retired) { return retired.first <= oldest; }),
+                        m_retired.end());
+        return published;
+      }
+
+      /**
+       * @brief Get the number of replaced values still kept for readers
+       *
+       * @return the number of retired values, the writers' lock must be held
+       */
+      size_t retiredCount() const { return m_retired.size(); }
+
+    private:
+      std::atomic<const T *> m_current{nullptr};
+      // (epoch it was retired in, value)
+      std::vector<std::pair<unsigned long long, std::unique_ptr<const T>>> m_retired;
+  };
+}
@@ -13,3 +13,10 @@
 #include <SpiceQL/query.h>
 #include <SpiceQL/api.h>
 #include <SpiceQL/inventory.h>
+#include <SpiceQL/sclk.h>
+#include <SpiceQL/textkernel.h>
+#include <SpiceQL/restcache.h>
+#include <SpiceQL/executor.h>
+#include <SpiceQL/api_async.h>
+#include <SpiceQL/localengine.h>
+#include <SpiceQL/singleflight.h>
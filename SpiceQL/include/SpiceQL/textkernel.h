@@ -0,0 +1,146 @@
+#pragma once
+/**
+ * @file
+ *
+ * Native NAIF text kernel parsing and keyword queries that do not use the CSPICE kernel pool
+ *
+ **/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace SpiceQL {
+
+  /**
+   * @brief One keyword assignment in a text kernel
+   */
+  struct TextKernelAssignment {
+    //! keyword name, case sensitive as in the kernel pool
+    std::string name;
+    //! true for "+=", which appends to the keyword's current values
+    bool append = false;
+    //! json array of the assigned values
+    nlohmann::json values;
+  };
+
+
+  /**
+   * @brief Read the keyword assignments in the \begindata sections of a NAIF text kernel.
+   *
+   * Assignments are returned in file order and "+=" assignments are kept as
+   * appends, so a caller replaying several kernels gets the same result as
+   * furnishing them in that order. Numbers are returned as doubles (Fortran "D"
+   * exponents are accepted), quoted strings as strings ('' is an escaped quote),
+   * and @dates as strings that keep their leading '@'. Continued strings
+   * (e.g. 'a long value //' 'continued') are separate values, as gcpool_c
+   * returns them.
+   *
+   * @param path path to the text kernel
+   * @return the assignments in file order
+   */
+  std::vector<TextKernelAssignment> parseTextKernelAssignments(std::string path);
+
+
+  /**
+   * @brief Read the \begindata sections of a NAIF text kernel.
+   *
+   * Returns every keyword assignment in the file as a json array, in the order
+   * the file defines them. "+=" appends to an earlier assignment. Numbers are
+   * returned as doubles (Fortran "D" exponents are accepted), quoted strings as
+   * strings, and @dates as strings that keep their leading '@'.
+   *
+   * @param path path to the text kernel
+   * @return json object of keyword name to array of values
+   */
+  nlohmann::json parseTextKernel(std::string path);
+
+
+  /**
+   * @brief Get the parsed assignments of a text kernel, parsing it only if needed.
+   *
+   * Parsed kernels are cached by path and re-read when the file's modification
+   * time changes. Safe to call from any number of threads.
+   *
+   * @param path path to the text kernel
+   * @return shared, immutable assignments of the kernel
+   */
+  std::shared_ptr<const std::vector<TextKernelAssignment>> loadTextKernel(std::string path);
+
+
+  /**
+   * @brief Check a keyword name against a kernel pool name template.
+   *
+   * Uses gnpool_c's rules: '*' matches any run of characters (including none),
+   * '%' matches exactly one character and everything else matches itself.
+   *
+   * @param keytpl name template, e.g. "INS-85600_*"
+   * @param name keyword name
+   * @return true if name matches the template
+   */
+  bool matchesKeywordTemplate(const std::string &keytpl, const std::string &name);
+
+
+  /**
+   * @brief Convert a text kernel @date to seconds past J2000.
+   *
+   * Like the kernel pool, the date is read as a calendar date with no time
+   * system and no leap seconds. Accepts year-month-day dates with numeric or
+   * named months, year-day of year dates and an optional time of day after a
+   * '/', 'T' or space, e.g. @2020-JUL-02/04:12:13.51 or @2020-184T04:12.
+   *
+   * @param date the date, with or without its leading '@'
+   * @param seconds set to the seconds past J2000 when the date is valid
+   * @return false if the date could not be read
+   */
+  bool textKernelDateToSeconds(std::string date, double &seconds);
+
+
+  /**
+   * @brief Build the keyword pool a list of kernels would produce, without furnishing them.
+   *
+   * The kernels are replayed in order as if they were furnished, so later
+   * assignments replace earlier ones and "+=" appends. Binary kernels in the
+   * list are skipped and @dates that can be read are converted to seconds past
+   * J2000, as the kernel pool stores them. Meta-kernels are replaced by the
+   * kernels their KERNELS_TO_LOAD lists, with PATH_SYMBOLS resolved, and their
+   * KERNELS_TO_LOAD, PATH_SYMBOLS and PATH_VALUES are dropped like furnsh does.
+   *
+   * @param kernelPaths kernels to read, in load order
+   * @param keytpl only keep keywords matching this template, see matchesKeywordTemplate
+   * @return json object of keyword name to array of values
+   */
+  nlohmann::json replayTextKernels(std::vector<std::string> kernelPaths, std::string keytpl="*");
+
+
+  /**
+   * @brief Format a keyword's pool values the way findKeywords returns them.
+   *
+   * A single value becomes a scalar and the strings "true", "false" and "null"
+   * are converted to their json values.
+   *
+   * @param values json array of the keyword's values
+   * @return the formatted value or array of values
+   */
+  nlohmann::json formatKeywordValues(const nlohmann::json &values);
+
+
+  /**
+   * @brief Find keywords matching a template in a list of kernels without furnishing them.
+   *
+   * The kernels are replayed in order as if they were furnished, so later
+   * assignments replace earlier ones and "+=" appends. Binary kernels in the
+   * list are skipped and meta-kernels are expanded, see replayTextKernels. The
+   * result has the same form as findKeywords: single values are scalars,
+   * @dates are seconds past J2000, and the strings "true", "false" and "null"
+   * are converted. There is no limit on the number of keywords, values or the
+   * length of string values.
+   *
+   * @param keytpl name template to search for, see matchesKeywordTemplate
+   * @param kernelPaths kernels to search, in load order
+   * @return json object of the matching keywords and their values, null if none match
+   */
+  nlohmann::json findTextKernelKeywords(std::string keytpl, std::vector<std::string> kernelPaths);
+}
@@ -11,6 +11,7 @@
 #include <regex>
 #include <optional>
 #include <array>
+#include <map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
@@ -142,8 +143,33 @@ namespace SpiceQL {
   std::vector<std::pair<double, double>> getTimeIntervals(std::string kpath);
 
 
+  /**
+    * @brief Get start and stop times of a kernel for each body.
+    *
+    * Same as getTimeIntervals but keeps the coverage of each negative NAIF code
+    * (spacecraft and instruments) separate.
+    *
+    * @param kpath Path to the kernel
+    * @returns map of NAIF code to its start and stop times
+    **/
+  std::map<int, std::vector<std::pair<double, double>>> getBodyTimeIntervals(std::string kpath);
+
+
   std::pair<double, double> getKernelStartStopTimes(std::string kpath);
 
+
+  /**
+    * @brief Sort and coalesce a list of time intervals.
+    *
+    * Overlapping or touching intervals are merged so the result is sorted by
+    * start time with strictly increasing, non-overlapping windows. Intervals
+    * whose start is after their stop are dropped.
+    *
+    * @param intervals start and stop time pairs in any order
+    * @returns merged intervals sorted by start time
+    **/
+  std::vector<std::pair<double, double>> mergeTimeIntervals(std::vector<std::pair<double, double>> intervals);
+
   std::string globKernelStartStopTimes(std::string mission);
 
   /**
@@ -200,7 +226,9 @@ namespace SpiceQL {
     * @brief finds key:values in kernel pool
     *
     * Given a key template, returns matching key:values from the kernel pool
-    *   by using gnpool, gcpool, gdpool, and gipool
+    *   by using gnpool, gcpool, and gdpool. Names and values are read in pages,
+    *   so any number of keywords and values are returned. To search kernels
+    *   without furnishing them, use findTextKernelKeywords.
     *
     * @param keytpl input key template to search for
     *
@@ -321,6 +349,46 @@ namespace SpiceQL {
   std::string getRestUrl();
 
 
+  /**
+    * @brief Returns how many REST requests may be in flight at once
+    *
+    * Read from the SPICEQL_REST_MAX_CONNECTIONS environment variable, 8 by
+    * default. Also the number of kept-alive connections that are pooled.
+    *
+    * @returns the maximum number of concurrent REST requests, at least 1
+    **/
+  int getRestMaxConnections();
+
+
+  /**
+    * @brief Split a list of ETs into consecutive batches for concurrent REST requests
+    *
+    * Batches hold at least minBatchSize ETs and there are at most maxBatches
+    * of them, so a list no longer than minBatchSize stays in one batch.
+    * Concatenating the batches gives back the input.
+    *
+    * @param ets the ephemeris times to split
+    * @param minBatchSize the smallest batch worth a request of its own
+    * @param maxBatches the most batches to return
+    *
+    * @returns the batches in order
+    **/
+  std::vector<std::vector<double>> splitEtBatches(const std::vector<double> &ets, size_t minBatchSize, size_t maxBatches);
+
+
+  /**
+    * @brief Merge the kernels of one ET batch's response into those of the batches before it
+    *
+    * Kernel lists are merged without duplicates like merge_json. The coverage
+    * gaps of LIMIT_MINIMAL_COVER searches ("<mission>_<type>_coverage") are
+    * joined, so the result lists the gaps found by every batch.
+    *
+    * @param kernels kernels of the earlier batches, merged in place
+    * @param batchKernels kernels of the next batch
+    **/
+  void mergeBatchKernels(nlohmann::json &kernels, nlohmann::json batchKernels);
+
+
   /**
     * @brief resolve the dependencies in a config in place
     *
@@ -520,10 +588,12 @@ namespace SpiceQL {
    *
    * Used to make the @c mission parameter of the API optional. String
    * candidates (e.g. frame/instrument/target names) are resolved via the alias
-   * map. Integer candidates (NAIF frame/body codes) are resolved to a name
-   * without furnishing kernels (via the precomputed frame cache, then NAIF's
-   * built-in mappings), trying both the code and its bus code (code / 1000),
-   * then mapped via the alias map.
+   * map. Integer candidates (NAIF frame/body codes) are looked up in a code to
+   * mission table derived from the frame cache and the alias map, trying both
+   * the code and its bus code (code / 1000). The table is rebuilt in memory
+   * when the DB or the alias map changes. Codes that are not in the frame
+   * cache fall back to NAIF's built-in mappings. Code candidates are tried in
+   * order, so the first one that resolves either way wins.
    *
    * @param nameCandidates Ordered string candidates to resolve.
    * @param codeCandidates Ordered NAIF code candidates to resolve.
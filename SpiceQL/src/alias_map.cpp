@@ -1,6 +1,9 @@
 #include <SpiceQL/alias_map.h>
 #include <SpiceQL/config.h>
+#include <SpiceQL/inventory.h>
 #include <SpiceQL/utils.h>
+#include <algorithm>
+#include <cctype>
 #include <mutex>
 #include <unordered_map>
 #include <fstream>
@@ -16,20 +19,31 @@ namespace SpiceQL {
     return inst;
   }
 
-  void AliasMap::ensure_init() {
-    if (!m_initialized) {
-      SPDLOG_DEBUG("Loading default aliases.");
-      load_internal(""); 
+  const AliasMap::Index *AliasMap::ensure_init() {
+    const Index *current = m_index.load();
+    if (current) {
+      return current;
     }
+
+    lock_guard<mutex> lock(m_mutex);
+    current = m_index.load();
+    if (current) {
+      return current;
+    }
+
+    SPDLOG_DEBUG("Loading default aliases.");
+    auto index = make_unique<Index>();
+    index->aliases = load_internal("");
+    return publish(move(index));
   }
 
   void load_aliases(string path) {
     AliasMap::instance().load(path);
   }
 
-  void AliasMap::load_internal(string path) {    
+  unordered_map<string, string> AliasMap::load_internal(string path) {
     if (path.empty()) {
-      path = getAliasMapJsonFile(); 
+      path = getAliasMapJsonFile();
     }
 
     SPDLOG_INFO("Loading aliases from {}", path);
@@ -41,83 +55,150 @@ namespace SpiceQL {
     nlohmann::json j;
     file >> j;
 
-    m_lookupTable.clear();
+    unordered_map<string, string> lookupTable;
     for (auto& [mission, aliases] : j.items()) {
       for (const string& alias : aliases) {
-        m_lookupTable[toUpper(alias)] = mission;
+        lookupTable[toUpper(alias)] = mission;
       }
     }
-    
-    m_initialized = true;
+    return lookupTable;
   }
 
-  void AliasMap::load(string path) {
+  const AliasMap::Index *AliasMap::refresh_frames(unsigned long long generation) {
+    // read outside of the lock, it may have to open or generate the DB
+    vector<string> frames = frameList();
+
     lock_guard<mutex> lock(m_mutex);
-    load_internal(path);
+    const Index *current = m_index.load();
+    if (current->framesLoaded && current->framesGeneration == generation) {
+      return current;  // another thread got here first
+    }
+
+    SPDLOG_DEBUG("Indexing {} frame list names for alias lookups.", frames.size());
+    auto index = make_unique<Index>(*current);
+    index->frames = move(frames);
+    index->framesLoaded = true;
+    index->framesGeneration = generation;
+    return publish(move(index));
   }
 
-  string AliasMap::getSpiceqlName(const string& name) {
+  const AliasMap::Index *AliasMap::publish(unique_ptr<Index> index) {
+    // Match frameList() case-insensitively, returning the canonical config key
+    // (e.g. NAIF's "LRO" -> "lro"). The first frame wins among frames that
+    // only differ by case, and aliases win over frames.
+    unordered_map<string, string> merged = index->aliases;
+    for (const auto& frame : index->frames) {
+      merged.emplace(toUpper(frame), frame);
+    }
+
+    index->entries.assign(merged.begin(), merged.end());
+    sort(index->entries.begin(), index->entries.end());
+
+    index->generation = ++m_generations;
+    return m_index.publish(move(index));
+  }
+
+  const string *AliasMap::find(const Index &index, string_view name) {
+    // keys are upper-cased, so upper-case the probe one character at a time
+    auto keyLess = [](const pair<string, string> &entry, string_view probe) {
+      return lexicographical_compare(entry.first.begin(), entry.first.end(), probe.begin(), probe.end(),
+                                     [](char key, char c) {
+                                       return static_cast<unsigned char>(key) < static_cast<unsigned char>(toupper(static_cast<unsigned char>(c)));
+                                     });
+    };
+    auto keyEqual = [](const string &key, string_view probe) {
+      return equal(key.begin(), key.end(), probe.begin(), probe.end(),
+                   [](char key, char c) { return key == static_cast<char>(toupper(static_cast<unsigned char>(c))); });
+    };
+
+    auto it = lower_bound(index.entries.begin(), index.entries.end(), name, keyLess);
+    if (it != index.entries.end() && keyEqual(it->first, name)) {
+      return &it->second;
+    }
+    return nullptr;
+  }
+
+  void AliasMap::load(string path) {
+    unordered_map<string, string> aliases = load_internal(path);
+
     lock_guard<mutex> lock(m_mutex);
-    ensure_init();
+    const Index *current = m_index.load();
+    auto index = current ? make_unique<Index>(*current) : make_unique<Index>();
+    index->aliases = move(aliases);
+    publish(move(index));
+  }
 
-    string upperAlias = toUpper(name);
-    auto it = m_lookupTable.find(upperAlias);
-    if (it != m_lookupTable.end()) {
-        return it->second;
+  string AliasMap::getSpiceqlName(const string& name) {
+    SnapshotReadGuard guard;
+    const Index *index = ensure_init();
+    if (const string *hit = find(*index, name)) {
+      return *hit;
     }
 
-    // Fallback: match frameList() case-insensitively, returning the canonical
-    // config key (e.g. NAIF's "LRO" -> "lro"). Indexed by uppercased key for
-    // O(1) lookup.
-    unordered_map<string, string> frames;
-    for (const auto& frame : frameList()) {
-        frames.emplace(toUpper(frame), frame);
+    // Miss: only rebuild the frame part if it was never loaded or the
+    // inventory DB has changed since.
+    unsigned long long generation = Inventory::getFrameCacheGeneration();
+    if (index->framesLoaded && index->framesGeneration == generation) {
+      return "";
     }
-    auto fit = frames.find(upperAlias);
-    if (fit != frames.end()) return fit->second;
 
+    index = refresh_frames(generation);
+    if (const string *hit = find(*index, name)) {
+      return *hit;
+    }
     return "";
   }
 
   void AliasMap::addAliasKey(const std::string &alias, const std::string &spiceqlName) {
-    lock_guard<mutex> lock(m_mutex);
     ensure_init();
-    m_lookupTable[toUpper(alias)] = spiceqlName;
+
+    lock_guard<mutex> lock(m_mutex);
+    auto index = make_unique<Index>(*m_index.load());
+    index->aliases[toUpper(alias)] = spiceqlName;
+    publish(move(index));
+  }
+
+  unsigned long long AliasMap::getGeneration() {
+    SnapshotReadGuard guard;
+    return ensure_init()->generation;
   }
 
   nlohmann::json AliasMap::getAliasMap() {
-    lock_guard<mutex> lock(m_mutex);
-    ensure_init();
+    SnapshotReadGuard guard;
+    const Index *index = ensure_init();
 
     // Unflatten and reformat as original JSON formatting
     nlohmann::json aliasMapJson;
-    for (auto const& [alias, key] : m_lookupTable) {
+    for (auto const& [alias, key] : index->aliases) {
       aliasMapJson[key].push_back(alias);
     }
     return aliasMapJson;
   }
 
   void AliasMap::setAliasMap(const nlohmann::json& newAliasMap) {
-    lock_guard<mutex> lock(m_mutex);
-    
-    m_lookupTable.clear();
-
     if (!newAliasMap.is_object()) {
       throw runtime_error("Provided alias map must be a JSON object.");
     }
 
-    for (auto& [mission, aliases] : newAliasMap.items()) {
-      if (aliases.is_array()) {
-        for (const auto& alias_val : aliases) {
+    unordered_map<string, string> aliases;
+    for (auto& [mission, aliases_val] : newAliasMap.items()) {
+      if (aliases_val.is_array()) {
+        for (const auto& alias_val : aliases_val) {
           if (alias_val.is_string()) {
-            m_lookupTable[toUpper(alias_val.get<string>())] = mission;
+            aliases[toUpper(alias_val.get<string>())] = mission;
           }
         }
       }
     }
-    
-    m_initialized = true; 
-    SPDLOG_INFO("Alias map manually updated with {} entries.", m_lookupTable.size());
+
+    size_t count = aliases.size();
+
+    lock_guard<mutex> lock(m_mutex);
+    const Index *current = m_index.load();
+    auto index = current ? make_unique<Index>(*current) : make_unique<Index>();
+    index->aliases = move(aliases);
+    publish(move(index));
+    SPDLOG_INFO("Alias map manually updated with {} entries.", count);
   }
 
 }
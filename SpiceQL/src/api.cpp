@@ -1,8 +1,16 @@
+#include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <exception>
 #include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <cmath>
 #include <cstring>
+#include <unordered_map>
 
 #include <SpiceUsr.h>
 #include <SpiceZfc.h>
@@ -29,6 +37,12 @@
 #endif
 #include <SpiceQL/config.h>
 #include <SpiceQL/alias_map.h>
+#include <SpiceQL/sclk.h>
+#include <SpiceQL/textkernel.h>
+#include <SpiceQL/restcache.h>
+#include <SpiceQL/executor.h>
+#include <SpiceQL/localengine.h>
+#include <SpiceQL/singleflight.h>
 
 #include "utcet.h"
 
@@ -84,6 +98,131 @@ namespace SpiceQL {
         return escaped.str();
     }
 
+#ifndef _WIN32
+    namespace {
+        // Process wide state of the useWeb requests. One long lived client and a
+        // curl share handle pooling connections, DNS lookups and TLS sessions, so
+        // consecutive calls reuse a kept-alive connection instead of paying for
+        // a new TCP and TLS handshake. Requests are executed synchronously on the
+        // calling thread, at most getRestMaxConnections() at a time.
+        class RestSession {
+            public:
+                static RestSession &instance() {
+                    // never destroyed, requests may still run during static destruction
+                    static RestSession *session = new RestSession();
+                    return *session;
+                }
+
+                restincurl::Client &client() { return m_client; }
+                CURLSH *share() { return m_share; }
+                long maxConnections() { return m_maxConnections; }
+
+                // Blocks until a request slot is free, the slot is released when the result goes out of scope
+                shared_ptr<void> acquire() {
+                    unique_lock<mutex> lock(m_slotMutex);
+                    m_slotFree.wait(lock, [this] { return m_active < m_maxConnections; });
+                    m_active++;
+                    return shared_ptr<void>(nullptr, [this](void *) {
+                        {
+                            lock_guard<mutex> lock(m_slotMutex);
+                            m_active--;
+                        }
+                        m_slotFree.notify_one();
+                    });
+                }
+
+            private:
+                RestSession() : m_maxConnections(getRestMaxConnections()) {
+                    // the client initializes libcurl, which has to happen before curl_share_init
+                    m_share = curl_share_init();
+                    curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, lockShare);
+                    curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+                    curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+                    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+                    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+                    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+                    SPDLOG_DEBUG("REST session created, up to {} concurrent requests", m_maxConnections);
+                }
+
+                static void lockShare(CURL *, curl_lock_data data, curl_lock_access, void *session) {
+                    static_cast<RestSession *>(session)->m_shareLocks[data % CURL_LOCK_DATA_LAST].lock();
+                }
+
+                static void unlockShare(CURL *, curl_lock_data data, void *session) {
+                    static_cast<RestSession *>(session)->m_shareLocks[data % CURL_LOCK_DATA_LAST].unlock();
+                }
+
+                restincurl::Client m_client;
+                CURLSH *m_share = nullptr;
+                array<mutex, CURL_LOCK_DATA_LAST> m_shareLocks;
+
+                long m_maxConnections;
+                long m_active = 0;
+                mutex m_slotMutex;
+                condition_variable m_slotFree;
+        };
+
+        // Response headers spiceAPIQuery reads
+        struct ResponseHeaders {
+            std::string etag;
+            std::string contentType;
+        };
+
+        // CURLOPT_HEADERFUNCTION callback keeping the values of the response's ETag and Content-Type headers
+        size_t storeResponseHeader(char *buffer, size_t size, size_t nitems, void *headers) {
+            size_t length = size * nitems;
+            std::string line(buffer, length);
+            ResponseHeaders *response = static_cast<ResponseHeaders *>(headers);
+            // a status line starts the headers of the next response when redirects are followed
+            if (line.rfind("HTTP/", 0) == 0) {
+                *response = {};
+                return length;
+            }
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                return length;
+            }
+
+            std::string name = line.substr(0, colon);
+            transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return tolower(c); });
+            std::string value = line.substr(colon + 1);
+            size_t first = value.find_first_not_of(" \t");
+            size_t last = value.find_last_not_of(" \t\r\n");
+            value = first == std::string::npos ? "" : value.substr(first, last - first + 1);
+
+            if (name == "etag") {
+                response->etag = value;
+            }
+            else if (name == "content-type") {
+                response->contentType = value;
+            }
+            return length;
+        }
+
+        // Responses are requested as MessagePack and fall back to JSON, so either may come back.
+        // The Content-Type says which one it is.
+        json parseAPIResponse(const restincurl::Result &result, std::string contentType) {
+            if (result.http_response_code != 200) {
+                SPDLOG_DEBUG("[Failed HTTP request] HTTP Code: {}, Message: {}, Payload size: {}", result.http_response_code, result.msg, result.body.size());
+            }
+            SPDLOG_DEBUG("Response body size = {}, Content-Type = {}", result.body.size(), contentType);
+            contentType = contentType.substr(0, contentType.find(';'));
+            contentType.erase(contentType.find_last_not_of(" \t") + 1);
+            transform(contentType.begin(), contentType.end(), contentType.begin(), [](unsigned char c) { return tolower(c); });
+            try {
+                if (contentType == "application/msgpack") {
+                    return json::from_msgpack(result.body);
+                }
+                return json::parse(result.body);
+            } catch (const json::exception& e) {
+                SPDLOG_ERROR("Error parsing REST API response: {}", e.what());
+                throw runtime_error("Got invalid JSON response from API");
+            }
+        }
+    }
+#endif
+
+
     json spiceAPIQuery(std::string functionName, json args, std::string method){
 #ifdef _WIN32
         // The remote REST web-service mode relies on restincurl, which is not
@@ -93,14 +232,28 @@ namespace SpiceQL {
         (void) functionName; (void) args; (void) method;
         throw runtime_error("SpiceQL remote REST mode (useWeb) is not yet supported on Windows.");
 #else
-        restincurl::Client client;
         // Need to be able to set URL externally
-        std::string queryString = getRestUrl() + functionName + "?";
+        std::string url = getRestUrl() + functionName;
+
+        RestCache &cache = RestCache::instance();
+        std::string cacheKey;
+        optional<RestCache::Entry> cached;
+        if (cache.enabled()) {
+            cacheKey = RestCache::makeKey(url, args);
+            cached = cache.get(cacheKey);
+            if (cached && cached->fresh) {
+                SPDLOG_DEBUG("{} answered from the REST cache", functionName);
+                return cached->response;
+            }
+        }
 
-        json j;
+        RestSession &session = RestSession::instance();
+        shared_ptr<void> slot = session.acquire();
+        unique_ptr<restincurl::RequestBuilder> request = session.client().Build();
 
         if (method == "GET"){
             SPDLOG_TRACE("spiceAPIQuery GET");
+            std::string queryString = url + "?";
             for (auto x : args.items()) {
                 if (x.value().is_null()) {
                     continue;
@@ -113,66 +266,158 @@ namespace SpiceQL {
             SPDLOG_DEBUG("queryString = {}", queryString);
             std::string encodedString = url_encode(queryString);
             SPDLOG_DEBUG("encodedString = {}", encodedString);
-            client.Build()->Get(encodedString)
-                    .Option(CURLOPT_FOLLOWLOCATION, 1L)
-                    .Option(CURLOPT_SSL_VERIFYPEER, 0L)
-                    .Option(CURLOPT_TIMEOUT, 180)
-                    .AcceptJson()
-                    .WithCompletion([&](const restincurl::Result& result) {
-                if (result.http_response_code != 200) {
-                    SPDLOG_DEBUG("[Failed HTTP request] HTTP Code: {}, Message: {}, Payload: {}", result.http_response_code, result.msg, result.body);
-                }
-                SPDLOG_DEBUG("GET result body = {}", result.body);
-                try { 
-                    j = json::parse(result.body);
-                } catch (const json::parse_error& e) {
-                    SPDLOG_ERROR("Error parsing JSON: {}", e.what());
-                    throw runtime_error("Got invalid JSON response from API");
-                }
-            }).ExecuteSynchronous();
+            request->Get(encodedString);
         } else {
             SPDLOG_TRACE("POST");
-            client.Build()->Post(queryString)
-                    .Option(CURLOPT_FOLLOWLOCATION, 1L)
-                    .Option(CURLOPT_SSL_VERIFYPEER, 0L)
-                    .Option(CURLOPT_TIMEOUT, 180)
-                    .AcceptJson()
-                    .WithJson(args.dump())
-                    .WithCompletion([&](const restincurl::Result& result) {
-                if (result.http_response_code != 200) {
-                    SPDLOG_DEBUG("[Failed HTTP request] HTTP Code: {}, Message: {}, Payload: {}", result.http_response_code, result.msg, result.body);
-                }
-                SPDLOG_DEBUG("POST result = {}", result.body);
-                j = json::parse(result.body);
-            }).ExecuteSynchronous();
+            request->Post(url + "?").WithJson(args.dump());
         }
-        
-        client.CloseWhenFinished();
-        client.WaitForFinish();
 
-        // Check is JSON is valid
-        if (j.is_null() || !json::accept(j.dump())) {
-            throw runtime_error("REST API Response is not a valid JSON.");
+        // a stale cache entry is sent back as a 304 if the server's DB has not changed since,
+        // only GETs can be revalidated, the server answers other methods with 412
+        if (cached && !cached->etag.empty() && method == "GET") {
+            request->Header("If-None-Match", cached->etag);
+        }
+
+        json j;
+        ResponseHeaders headers;
+        bool notModified = false;
+        // MessagePack keeps doubles binary and is several times smaller than their decimal text,
+        // CURLOPT_ACCEPT_ENCODING also lets the server gzip large responses such as kernel lists
+        request->Option(CURLOPT_SHARE, session.share())
+                .Option(CURLOPT_TCP_KEEPALIVE, 1L)
+                .Option(CURLOPT_MAXCONNECTS, session.maxConnections())
+                .Option(CURLOPT_FOLLOWLOCATION, 1L)
+                .Option(CURLOPT_SSL_VERIFYPEER, 0L)
+                .Option(CURLOPT_TIMEOUT, 180)
+                .Option(CURLOPT_ACCEPT_ENCODING, "")
+                .Option(CURLOPT_HEADERFUNCTION, storeResponseHeader)
+                .Option(CURLOPT_HEADERDATA, &headers)
+                .Header("Accept: application/msgpack, application/json;q=0.9")
+                .WithCompletion([&](const restincurl::Result& result) {
+            if (result.http_response_code == 304 && cached) {
+                notModified = true;
+                return;
+            }
+            j = parseAPIResponse(result, headers.contentType);
+        }).ExecuteSynchronous();
+
+        if (notModified) {
+            SPDLOG_DEBUG("{} revalidated the REST cache", functionName);
+            cache.put(cacheKey, cached->response, headers.etag.empty() ? cached->etag : headers.etag);
+            return cached->response;
         }
 
-        SPDLOG_DEBUG("Response: ", j.dump());
+        // A parsed response is already valid, it only has to be an object
+        if (!j.is_object()) {
+            throw runtime_error("REST API Response is not a valid JSON.");
+        }
         
         // Check for successful call
         if (!(j["statusCode"] == 200)) {
             throw runtime_error("REST API Error Response: [" + j.dump() + "]");
         }
 
+        if (cache.enabled()) {
+            cache.put(cacheKey, j, headers.etag);
+        }
+
         return j;
 #endif
     }
 
 
+    // Sends a query to the REST service for useWeb calls, and to the local
+    // engine's workers for local calls while an engine is active.
+    static json remoteQuery(std::string functionName, json args, bool useWeb, std::string method="GET") {
+        if (useWeb) {
+            return spiceAPIQuery(functionName, args, method);
+        }
+        shared_ptr<LocalEngine> engine = LocalEngine::active();
+        if (!engine) {
+            throw runtime_error("The local engine was stopped while running " + functionName);
+        }
+        return engine->query(functionName, args);
+    }
+
+
+    // Testing on Safari with the Cassini Notebook, 
+    // up to 180 ets could be sent, with a character limit slightly above 4000.
+    // To be safe, setting a more conservative 150 ET limit on GET requests.
+    static const size_t numEtsGetLimit = 150;
+
+    // Each local engine batch searches and furnishes its own kernels, which
+    // costs as much as evaluating thousands of ETs.
+    static const size_t numEtsEngineBatch = 5000;
+
+    // Sends a query whose "ets" argument may be large. For useWeb, up to
+    // numEtsGetLimit ETs go in one GET request, longer lists are split into at
+    // most getRestMaxConnections() batches that are requested concurrently. On
+    // the local engine, lists are split into batches of at least
+    // numEtsEngineBatch ETs, at most one per worker. The batch results are
+    // concatenated in ET order, and the kernels and coverage gaps are merged.
+    static json remoteQueryEts(std::string functionName, json args, const vector<double> &ets, bool useWeb) {
+        size_t minBatchSize = numEtsGetLimit;
+        size_t maxBatches = getRestMaxConnections();
+        if (!useWeb) {
+            shared_ptr<LocalEngine> engine = LocalEngine::active();
+            minBatchSize = numEtsEngineBatch;
+            maxBatches = engine ? engine->workerCount() : 1;
+        }
+
+        if (ets.size() <= minBatchSize) {
+            return remoteQuery(functionName, args, useWeb, "GET");
+        }
+
+        vector<vector<double>> batches = splitEtBatches(ets, minBatchSize, maxBatches);
+        if (batches.size() == 1) {
+            return remoteQuery(functionName, args, useWeb, "POST");
+        }
+        SPDLOG_DEBUG("Splitting {} ets into {} {} requests", ets.size(), batches.size(), functionName);
+
+        vector<future<json>> responses;
+        for (auto &batch : batches) {
+            json batchArgs = args;
+            batchArgs["ets"] = batch;
+            std::string requestMethod = batch.size() <= numEtsGetLimit ? "GET" : "POST";
+            responses.push_back(async(launch::async, remoteQuery, functionName, std::move(batchArgs), useWeb, requestMethod));
+        }
+
+        // wait for every batch before rethrowing the first error so none outlive the call
+        for (auto &response : responses) {
+            response.wait();
+        }
+
+        json out = responses.front().get();
+        json &values = out["body"]["return"];
+        json &kernels = out["body"]["kernels"];
+        for (size_t i = 1; i < responses.size(); i++) {
+            json batchOut = responses[i].get();
+            for (auto &value : batchOut["body"]["return"]) {
+                values.push_back(std::move(value));
+            }
+            mergeBatchKernels(kernels, std::move(batchOut["body"]["kernels"]));
+        }
+        return out;
+    }
+
+
     pair<vector<vector<double>>, json> getTargetStates(vector<double> ets, string target, string observer, string frame, string abcorr, string mission, 
                                                        vector<string> ckQualities, vector<string> spkQualities, bool useWeb, bool searchKernels, bool fullKernelPath, 
                                                        int limitCk, int limitSpk, vector<string> kernelList) {
         SPDLOG_TRACE("Calling getTargetStates with {}, {}, {}, {}, {}, {}, {}, {}, {}, {}", ets.size(), target, observer, frame, abcorr, mission, ckQualities.size(), spkQualities.size(), useWeb, searchKernels, kernelList.size());
         SPDLOG_TRACE("ets: [{}]", fmt::join(ets, ", "));
-        if (useWeb) {
+        SingleFlight &flights = SingleFlight::instance();
+        if (flights.shouldCoalesce()) {
+            json call = {{"ets", ets}, {"target", target}, {"observer", observer}, {"frame", frame}, {"abcorr", abcorr},
+                         {"mission", mission}, {"ckQualities", ckQualities}, {"spkQualities", spkQualities}, {"useWeb", useWeb},
+                         {"searchKernels", searchKernels}, {"fullKernelPath", fullKernelPath}, {"limitCk", limitCk},
+                         {"limitSpk", limitSpk}, {"kernelList", kernelList}};
+            return flights.run<pair<vector<vector<double>>, json>>(SingleFlight::makeKey("getTargetStates", call), [&]() {
+                return getTargetStates(ets, target, observer, frame, abcorr, mission, ckQualities, spkQualities, useWeb,
+                                       searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+            });
+        }
+        if (useWeb || LocalEngine::active()) {
             // @TODO validity checks
             json args = json::object({
                 {"target", target},
@@ -190,13 +435,7 @@ namespace SpiceQL {
                 {"kernelList", kernelList}
                 });
             // @TODO check that json exists / contains what we're looking for
-
-            // Testing on Safari with the Cassini Notebook, 
-            // up to 180 ets could be sent, with a character limit slightly above 4000.
-            // To be safe, setting a more conservative 150 ET limit here.
-            const int numEtsGetLimit = 150;
-            std::string requestMethod = ets.size() <= numEtsGetLimit ? "GET" : "POST";
-            json out = spiceAPIQuery("getTargetStates", args, requestMethod);
+            json out = remoteQueryEts("getTargetStates", args, ets, useWeb);
             vector<vector<double>> kvect = json2DFloatArrayTo2DVector(out["body"]["return"]);
             return make_pair(kvect, out["body"]["kernels"]);
         }
@@ -221,6 +460,7 @@ namespace SpiceQL {
         }
 
         auto start = std::chrono::high_resolution_clock::now();
+        CspiceGuard cspice;
         KernelSet ephemSet(ephemKernels);
 
         auto stop = std::chrono::high_resolution_clock::now();
@@ -259,7 +499,7 @@ namespace SpiceQL {
                                                              vector<string> kernelList) 
     {
         SPDLOG_TRACE("Calling getTargetStatesRanged with {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}", startEt, stopEt, numRecords, target, observer, frame, abcorr, mission, ckQualities.size(), spkQualities.size(), useWeb, searchKernels, kernelList.size());
-        if (useWeb) {
+        if (useWeb || LocalEngine::active()) {
             // @TODO validity checks
             json args = json::object({
                 {"target", target},
@@ -279,7 +519,7 @@ namespace SpiceQL {
                 {"kernelList", kernelList}
                 });
             // @TODO check that json exists / contains what we're looking for
-            json out = spiceAPIQuery("getTargetStatesRanged", args);
+            json out = remoteQuery("getTargetStatesRanged", args, useWeb);
             vector<vector<double>> kvect = json2DFloatArrayTo2DVector(out["body"]["return"]);
             return make_pair(kvect, out["body"]["kernels"]);
         }
@@ -328,7 +568,18 @@ namespace SpiceQL {
                                                              int limitCk, int limitSpk, vector<string> kernelList) {
         SPDLOG_TRACE("Calling getTargetOrientations with {}, {}, {}, {}, {}, {}, {}, {}", ets.size(), toFrame, refFrame, mission, ckQualities.size(), useWeb, searchKernels, kernelList.size());
         SPDLOG_TRACE("ets: [{}]", fmt::join(ets, ", "));
-        if (useWeb){
+        SingleFlight &flights = SingleFlight::instance();
+        if (flights.shouldCoalesce()) {
+            json call = {{"ets", ets}, {"toFrame", toFrame}, {"refFrame", refFrame}, {"mission", mission},
+                         {"ckQualities", ckQualities}, {"useWeb", useWeb}, {"searchKernels", searchKernels},
+                         {"fullKernelPath", fullKernelPath}, {"limitCk", limitCk}, {"limitSpk", limitSpk},
+                         {"kernelList", kernelList}};
+            return flights.run<pair<vector<vector<double>>, json>>(SingleFlight::makeKey("getTargetOrientations", call), [&]() {
+                return getTargetOrientations(ets, toFrame, refFrame, mission, ckQualities, useWeb, searchKernels,
+                                             fullKernelPath, limitCk, limitSpk, kernelList);
+            });
+        }
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"ets", ets},
                 {"toFrame", toFrame},
@@ -341,9 +592,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            const int numEtsGetLimit = 150;
-            std::string requestMethod = ets.size() <= numEtsGetLimit ? "GET" : "POST";
-            json out = spiceAPIQuery("getTargetOrientations", args, requestMethod);
+            json out = remoteQueryEts("getTargetOrientations", args, ets, useWeb);
             vector<vector<double>> kvect = json2DFloatArrayTo2DVector(out["body"]["return"]);
             return make_pair(kvect, out["body"]["kernels"]);
         }
@@ -367,6 +616,7 @@ namespace SpiceQL {
         }
 
         auto start = std::chrono::high_resolution_clock::now();
+        CspiceGuard cspice;
         KernelSet ephemSet(ephemKernels);
         auto stop = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
@@ -411,7 +661,7 @@ namespace SpiceQL {
                                                                                                         searchKernels, 
                                                                                                         kernelList.size());
 
-        if (useWeb) {
+        if (useWeb || LocalEngine::active()) {
             // @TODO validity checks
             json args = json::object({
                 {"startEt", startEt},
@@ -428,7 +678,7 @@ namespace SpiceQL {
                 {"kernelList", kernelList}
             });
             // @TODO check that json exists / contains what we're looking for
-            json out = spiceAPIQuery("getTargetOrientationsRanged", args);
+            json out = remoteQuery("getTargetOrientationsRanged", args, useWeb);
             vector<vector<double>> kvect = json2DFloatArrayTo2DVector(out["body"]["return"]);
             return make_pair(kvect, out["body"]["kernels"]);
         }
@@ -471,7 +721,7 @@ namespace SpiceQL {
         SPDLOG_TRACE("Calling getExactTargetOrientations with startEt={}, stopEt={}, toFrame={}, refFrame={}, exactCkFrame={}, mission={}, ckQualities.size()={}, useWeb={}, searchKernels={}, kernelList.size()={}", 
             startEt, stopEt, toFrame, refFrame, exactCkFrame, mission, ckQualities.size(), useWeb, searchKernels, kernelList.size());
         
-        if (useWeb){
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"startEt", startEt},
                 {"stopEt", stopEt},
@@ -486,7 +736,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("getExactTargetOrientations", args);
+            json out = remoteQuery("getExactTargetOrientations", args, useWeb);
             vector<vector<double>> kvect = json2DFloatArrayTo2DVector(out["body"]["return"]);
             return make_pair(kvect, out["body"]["kernels"]);
         }
@@ -522,7 +772,7 @@ namespace SpiceQL {
     pair<double, json> strSclkToEt(int frameCode, string sclk, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
         SPDLOG_TRACE("calling strSclkToEt({}, {}, {}, {}, {}, {})", frameCode, sclk, mission, useWeb, searchKernels, kernelList.size());
 
-        if (useWeb) {
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"frameCode", frameCode},
                 {"sclk", sclk},
@@ -533,7 +783,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("strSclkToEt", args);
+            json out = remoteQuery("strSclkToEt", args, useWeb);
             double result = out["body"]["return"].get<double>();
             return make_pair(result, out["body"]["kernels"]);
         }
@@ -551,6 +801,7 @@ namespace SpiceQL {
             merge_json(ephemKernels, regexk);
         }
 
+        CspiceGuard cspice;
         KernelSet kSet(ephemKernels);
         
         SpiceDouble et;
@@ -576,7 +827,7 @@ namespace SpiceQL {
 
         json ephemKernels;
 
-        if (useWeb) {
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"frameCode", frameCode},
                 {"et", et},
@@ -587,7 +838,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("doubleEtToSclk", args);
+            json out = remoteQuery("doubleEtToSclk", args, useWeb);
             string result = out["body"]["return"].get<string>();
             return make_pair(result, out["body"]["kernels"]);
         }
@@ -604,6 +855,7 @@ namespace SpiceQL {
             merge_json(ephemKernels, regexk);
         }
 
+        CspiceGuard cspice;
         KernelSet sclkSet(ephemKernels);
 
         SpiceChar sclk[100];
@@ -618,7 +870,7 @@ namespace SpiceQL {
 
     pair<double, json> doubleSclkToEt(int frameCode, double sclk, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
 
-        if (useWeb){
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"frameCode", frameCode},
                 {"sclk", sclk},
@@ -629,7 +881,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("doubleSclkToEt", args);
+            json out = remoteQuery("doubleSclkToEt", args, useWeb);
             double result = out["body"]["return"].get<double>();
             return make_pair(result, out["body"]["kernels"]);
         }
@@ -648,6 +900,7 @@ namespace SpiceQL {
             merge_json(sclks, regexk);
         }
 
+        CspiceGuard cspice;
         KernelSet sclkSet(sclks);
         
         // we want the platforms code, if they passs in an instrument code (e.g. -85600), truncate it to (-85)
@@ -663,112 +916,96 @@ namespace SpiceQL {
     }
 
 
-    pair<double, json> utcToEt(string utc, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
-
-        if (useWeb){
-            json args = json::object({
-                {"utc", utc},
-                {"searchKernels", searchKernels},
-                {"fullKernelPath", fullKernelPath},
-                {"limitCk", limitCk},
-                {"limitSpk", limitSpk},
-                {"kernelList", kernelList}
-            });
-            json out = spiceAPIQuery("utcToEt", args);
-            double result = out["body"]["return"].get<double>();
-            return make_pair(result, out["body"]["kernels"]);
-        }
+    // Kernels needed by the SCLK conversions, searched for once per batch.
+    static json searchSclkKernels(int frameCode, string &mission, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        json sclks;
 
-        json lsks = {};
+        if (mission.empty()) mission = inferMission({}, {frameCode});
 
-        // get lsk kernel
         if (searchKernels) {
-            lsks = Inventory::search_for_kernelset("base", {"lsk"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
+            sclks = Inventory::search_for_kernelsets({"base", mission}, {"lsk", "fk", "sclk"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
         }
 
         if (!kernelList.empty()) {
             json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
             // merge them into the ephem kernels overwriting anything found in the query
-            merge_json(lsks, regexk);
+            merge_json(sclks, regexk);
         }
+        return sclks;
+    }
 
-        double et;
 
-        // Use LSK kernel if available, otherwise fall back to utcet
-        if(searchKernels || !kernelList.empty()) {
-            SPDLOG_TRACE("Using LSK kernel for UTC to ET conversion");
-            KernelSet lsk(lsks);
-            checkNaifErrors();
-            str2et_c(utc.c_str(), &et);
-            checkNaifErrors();
-        } else {
-            SPDLOG_TRACE("No kernels provided, using utcet for UTC to ET conversion");
-            et = calendarTimeToEphemTime(utc);
+    // Paths of the kernels in a kernel set, relative paths are resolved against the data directory.
+    static vector<string> resolveKernelPaths(json kernels) {
+        vector<string> paths;
+        for (string path : getKernelsAsVector(kernels)) {
+            if (!fs::exists(path)) {
+                path = (fs::path(getDataDirectory()) / path).string();
+            }
+            paths.push_back(path);
         }
-
-        return {et, lsks};
+        return paths;
     }
 
 
-    pair<string, json> etToUtc(double et, string format, double precision, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+    // Native model of the clock for frameCode (or its platform) built from the SCLK
+    // kernels in the kernel set, nullptr if the kernels do not define a type 1 clock for it.
+    static shared_ptr<const SclkModel> loadSclkModel(int frameCode, json sclkKernels) {
+        vector<string> sclkPaths;
+        string lskPath;
+        for (string path : resolveKernelPaths(sclkKernels)) {
+            string ext = toLower(fs::path(path).extension().string());
+            if (ext == ".tsc") {
+                sclkPaths.push_back(path);
+            }
+            else if (ext == ".tls") {
+                lskPath = path;
+            }
+        }
 
-        if (useWeb){
-            json args = json::object({
-                {"et", et},
-                {"format", format},
-                {"precision", precision},
-                {"searchKernels", searchKernels},
-                {"fullKernelPath", fullKernelPath},
-                {"limitCk", limitCk},
-                {"limitSpk", limitSpk},
-                {"kernelList", kernelList}
-            });
-            json out = spiceAPIQuery("etToUtc", args);
-            string result = out["body"]["return"].get<string>();
-            return make_pair(result, out["body"]["kernels"]);
+        if (sclkPaths.empty()) {
+            return nullptr;
         }
 
-        json lsks = {};
+        // the clock that defined frameCode last time is tried first
+        static mutex clocksMutex;
+        static unordered_map<int, int> resolvedClocks;
 
-        // get lsk kernel
-        if (searchKernels) {
-            lsks = Inventory::search_for_kernelset("base", {"lsk"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
+        vector<int> clockIds = {frameCode};
+        if (abs(frameCode / 1000) > 0) {
+            clockIds.push_back(frameCode / 1000);
         }
-        if (!kernelList.empty()) {
-            json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
-            // merge them into the ephem kernels overwriting anything found in the query
-            merge_json(lsks, regexk);
+        {
+            lock_guard<mutex> lock(clocksMutex);
+            auto it = resolvedClocks.find(frameCode);
+            if (it != resolvedClocks.end() && it->second != clockIds.front()) {
+                swap(clockIds.front(), clockIds.back());
+            }
         }
 
-        string utc_string;
-
-        // Use LSK kernel if available, otherwise fall back to utcet
-        if(searchKernels || !kernelList.empty()) {
-            SPDLOG_TRACE("Using LSK kernel for ET to UTC conversion");
-            KernelSet lsk(lsks);
-            SpiceChar utc_spice[100];
-            checkNaifErrors();
-            et2utc_c(et, format.c_str(), precision, 100, utc_spice);
-            checkNaifErrors();
-            utc_string = string(utc_spice);
-        } else {
-            SPDLOG_TRACE("No kernels provided, using utcet for ET to UTC conversion");
-            // Note: format and precision parameters are used with utcet
-            // utcet always returns ISO 8601 format with Z suffix
-            int prec = static_cast<int>(precision);
-            int utclen = 19 + prec + 3;  // Fixed format size
-            utc_string = ephemTimeToCalendarTime(et, format, prec, utclen);
+        for (int clockId : clockIds) {
+            try {
+                shared_ptr<const SclkModel> model = SclkModel::load(sclkPaths, clockId, lskPath);
+                lock_guard<mutex> lock(clocksMutex);
+                resolvedClocks[frameCode] = clockId;
+                return model;
+            }
+            catch (invalid_argument &e) {
+                SPDLOG_TRACE("No native SCLK model for clock {}: {}", clockId, e.what());
+            }
         }
-
-        return {utc_string, lsks};
+        SPDLOG_DEBUG("Falling back to CSPICE for SCLK conversions of {}", frameCode);
+        return nullptr;
     }
 
 
-    pair<int, json> translateNameToCode(string frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {    
-        
-        if (useWeb){
+    pair<vector<double>, json> strSclkToEtBatch(int frameCode, vector<string> sclks, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling strSclkToEtBatch({}, {} sclks, {}, {}, {}, {})", frameCode, sclks.size(), mission, useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
-                {"frame", frame},
+                {"frameCode", frameCode},
+                {"sclks", sclks},
                 {"mission", mission},
                 {"searchKernels", searchKernels},
                 {"fullKernelPath", fullKernelPath},
@@ -776,51 +1013,58 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("translateNameToCode", args);
-            int result = out["body"]["return"].get<int>();
+            json out = remoteQuery("strSclkToEtBatch", args, useWeb, "POST");
+            vector<double> result = jsonDoubleArrayToVector(out["body"]["return"]);
             return make_pair(result, out["body"]["kernels"]);
         }
-        
-        SpiceInt code;
-        SpiceBoolean found;
-        json kernelsToLoad = {};
-
-        if (mission.empty()) mission = inferMission({frame}, {});
 
-        if (mission != "" && searchKernels) {
-            kernelsToLoad = Inventory::search_for_kernelset(mission, {"fk", "ik", "iak"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
+        if (sclks.empty()) {
+            return {{}, {}};
         }
 
-        if (!kernelList.empty()) {
-            json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
-            // merge them into the ephem kernels overwriting anything found in the query
-            merge_json(kernelsToLoad, regexk);
-        }
+        json ephemKernels = searchSclkKernels(frameCode, mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+        vector<double> ets(sclks.size());
 
-        KernelSet kset(kernelsToLoad);
+        shared_ptr<const SclkModel> model = loadSclkModel(frameCode, ephemKernels);
+        if (model) {
+            for (size_t i = 0; i < sclks.size(); i++) {
+                ets[i] = model->sclkToEt(sclks[i]);
+            }
+            SPDLOG_DEBUG("strSclkToEtBatch({}, {}) converted {} sclks natively", frameCode, mission, ets.size());
+            return {ets, ephemKernels};
+        }
 
+        CspiceGuard cspice;
+        KernelSet kSet(ephemKernels);
         checkNaifErrors();
-        bodn2c_c(frame.c_str(), &code, &found);
-        checkNaifErrors();
-
-        if (!found) {
-            namfrm_c(frame.c_str(), &code);
+        try {
+            scs2e_c(frameCode, sclks[0].c_str(), &ets[0]);
+            checkNaifErrors();
+        }
+        catch(exception &e) { 
+            // we want the platforms code, if they passs in an instrument code (e.g. -85600), truncate it to (-85)
+            frameCode = (abs(frameCode / 1000) > 0) ? frameCode/1000 : frameCode;
+            scs2e_c(frameCode, sclks[0].c_str(), &ets[0]);
             checkNaifErrors();
         }
 
-        if (code == 0) {
-            throw invalid_argument(fmt::format("Frame code for frame name [{}] not found.", frame));
+        for (size_t i = 1; i < sclks.size(); i++) {
+            scs2e_c(frameCode, sclks[i].c_str(), &ets[i]);
+            checkNaifErrors();
         }
+        SPDLOG_DEBUG("strSclkToEtBatch({}, {}) converted {} sclks", frameCode, mission, ets.size());
 
-        return {code, kernelsToLoad};
+        return {ets, ephemKernels};
     }
 
 
-    pair<string, json> translateCodeToName(int frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
-        
-        if (useWeb){
+    pair<vector<double>, json> doubleSclkToEtBatch(int frameCode, vector<double> sclks, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling doubleSclkToEtBatch({}, {} sclks, {}, {}, {}, {})", frameCode, sclks.size(), mission, useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
-                {"frame", frame},
+                {"frameCode", frameCode},
+                {"sclks", sclks},
                 {"mission", mission},
                 {"searchKernels", searchKernels},
                 {"fullKernelPath", fullKernelPath},
@@ -828,50 +1072,49 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("translateCodeToName", args);
-            string result = out["body"]["return"].get<string>();
+            json out = remoteQuery("doubleSclkToEtBatch", args, useWeb, "POST");
+            vector<double> result = jsonDoubleArrayToVector(out["body"]["return"]);
             return make_pair(result, out["body"]["kernels"]);
         }
 
-        SpiceChar name[128];
-        SpiceBoolean found;
-        json kernelsToLoad = {};
-
-        if (mission.empty()) mission = inferMission({}, {frame});
-
-        if (mission != "" && searchKernels){
-            kernelsToLoad = Inventory::search_for_kernelset(mission, {"fk", "ik", "iak"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
-        }
-        if (!kernelList.empty()) {
-            json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
-            // merge them into the ephem kernels overwriting anything found in the query
-            merge_json(kernelsToLoad, regexk);
+        if (sclks.empty()) {
+            return {{}, {}};
         }
 
-        KernelSet kset(kernelsToLoad);
+        json ephemKernels = searchSclkKernels(frameCode, mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
 
-        checkNaifErrors();
-        bodc2n_c(frame, 128, name, &found);
-        checkNaifErrors();
+        // we want the platforms code, if they passs in an instrument code (e.g. -85600), truncate it to (-85)
+        frameCode = (abs(frameCode / 1000) > 0) ? frameCode/1000 : frameCode; 
 
-        if(!found) {  
-            frmnam_c(frame, 128, name);
-            checkNaifErrors();
+        vector<double> ets(sclks.size());
+
+        shared_ptr<const SclkModel> model = loadSclkModel(frameCode, ephemKernels);
+        if (model) {
+            model->ticksToEt(sclks.data(), ets.data(), sclks.size());
+            SPDLOG_DEBUG("doubleSclkToEtBatch({}, {}) converted {} sclks natively", frameCode, mission, ets.size());
+            return {ets, ephemKernels};
         }
 
-        if(strlen(name) == 0) {
-            throw invalid_argument(fmt::format("Frame name for code {} not found.", frame));
+        CspiceGuard cspice;
+        KernelSet sclkSet(ephemKernels);
+        checkNaifErrors();
+        for (size_t i = 0; i < sclks.size(); i++) {
+            sct2e_c(frameCode, sclks[i], &ets[i]);
+            checkNaifErrors();
         }
+        SPDLOG_DEBUG("doubleSclkToEtBatch({}, {}) converted {} sclks", frameCode, mission, ets.size());
 
-        return {string(name), kernelsToLoad};
+        return {ets, ephemKernels};
     }
 
 
-    pair<vector<int>, json> getFrameInfo(int frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
-        
-        if (useWeb){
+    pair<vector<string>, json> doubleEtToSclkBatch(int frameCode, vector<double> ets, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling doubleEtToSclkBatch({}, {} ets, {}, {}, {}, {})", frameCode, ets.size(), mission, useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
-                {"frame", frame},
+                {"frameCode", frameCode},
+                {"ets", ets},
                 {"mission", mission},
                 {"searchKernels", searchKernels},
                 {"fullKernelPath", fullKernelPath},
@@ -879,47 +1122,731 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("getFrameInfo", args);
-            vector<int> result = jsonIntArrayToVector(out["body"]["return"]);
+            json out = remoteQuery("doubleEtToSclkBatch", args, useWeb, "POST");
+            vector<string> result = jsonArrayToVector(out["body"]["return"]);
             return make_pair(result, out["body"]["kernels"]);
         }
 
-        SpiceInt cent;
-        SpiceInt frclss;
-        SpiceInt clssid;
-        SpiceBoolean found;
+        if (ets.empty()) {
+            return {{}, {}};
+        }
 
-        json kernelsToLoad = {};
+        json ephemKernels = searchSclkKernels(frameCode, mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
 
-        if (mission.empty()) mission = inferMission({}, {frame});
+        vector<string> sclks;
+        sclks.reserve(ets.size());
 
-        if (mission != "" && searchKernels) {
-            // Load only the FKs
-            kernelsToLoad = Inventory::search_for_kernelset(mission, {"fk"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
-        }
-        if (!kernelList.empty()) {
-            json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
-            // merge them into the ephem kernels overwriting anything found in the query
-            merge_json(kernelsToLoad, regexk);
+        shared_ptr<const SclkModel> model = loadSclkModel(frameCode, ephemKernels);
+        if (model) {
+            for (double et : ets) {
+                sclks.push_back(model->etToSclk(et));
+            }
+            SPDLOG_DEBUG("doubleEtToSclkBatch({}, {}) converted {} ets natively", frameCode, mission, sclks.size());
+            return make_pair(sclks, ephemKernels);
         }
-        KernelSet kset(kernelsToLoad);
 
+        CspiceGuard cspice;
+        KernelSet sclkSet(ephemKernels);
+        SpiceChar sclk[100];
+        checkNaifErrors();
+        for (double et : ets) {
+            sce2s_c(frameCode, et, 100, sclk);
+            checkNaifErrors();
+            sclks.emplace_back(sclk);
+        }
+        SPDLOG_DEBUG("doubleEtToSclkBatch({}, {}) converted {} ets", frameCode, mission, sclks.size());
+
+        return make_pair(sclks, ephemKernels);
+    }
+
+
+    // LSK kernels for the UTC/ET conversions
+    static json searchLskKernels(bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        json lsks = {};
+
+        if (searchKernels) {
+            lsks = Inventory::search_for_kernelset("base", {"lsk"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
+        }
+        if (!kernelList.empty()) {
+            json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
+            // merge them into the ephem kernels overwriting anything found in the query
+            merge_json(lsks, regexk);
+        }
+        return lsks;
+    }
+
+
+    // Leap-second table of the last LSK in a kernel set, nullptr if the set has
+    // none or its LSK cannot be read. Each LSK is parsed once and the table
+    // shared until the file changes.
+    static shared_ptr<const LeapSecondTable> loadLeapSecondTable(json lsks) {
+        static mutex cacheMutex;
+        static unordered_map<string, shared_ptr<const LeapSecondTable>> cache;
+
+        string lskPath;
+        for (string path : resolveKernelPaths(lsks)) {
+            if (toLower(fs::path(path).extension().string()) == ".tls") {
+                lskPath = path;
+            }
+        }
+        if (lskPath.empty() || !fs::exists(lskPath)) {
+            return nullptr;
+        }
+
+        string key = lskPath + "@" + to_string(fs::last_write_time(lskPath).time_since_epoch().count());
+        {
+            lock_guard<mutex> lock(cacheMutex);
+            auto it = cache.find(key);
+            if (it != cache.end()) {
+                return it->second;
+            }
+        }
+
+        // LSKs this cannot read are left to CSPICE, which may still handle them
+        shared_ptr<const LeapSecondTable> table;
+        try {
+            json pool = parseTextKernel(lskPath);
+            vector<double> taiUtc;
+            vector<string> dates;
+            json deltaAt = pool.value("DELTET/DELTA_AT", json::array());
+            for (size_t i = 0; i + 1 < deltaAt.size(); i += 2) {
+                if (!deltaAt[i].is_number() || !deltaAt[i+1].is_string()) {
+                    throw runtime_error("DELTET/DELTA_AT in [" + lskPath + "] is not a list of value, @date pairs");
+                }
+                taiUtc.push_back(deltaAt[i].get<double>());
+                dates.push_back(deltaAt[i+1].get<string>());
+            }
+
+            for (string keyword : {"DELTET/DELTA_T_A", "DELTET/K", "DELTET/EB", "DELTET/M"}) {
+                if (!pool.contains(keyword) || pool[keyword].empty()) {
+                    throw runtime_error("Keyword [" + keyword + "] was not found in LSK [" + lskPath + "]");
+                }
+            }
+            if (pool["DELTET/M"].size() < 2) {
+                throw runtime_error("DELTET/M in [" + lskPath + "] must have two values");
+            }
+
+            table = make_shared<const LeapSecondTable>(makeLeapSecondTable(taiUtc, dates,
+                                                                           pool["DELTET/DELTA_T_A"][0].get<double>(),
+                                                                           pool["DELTET/K"][0].get<double>(),
+                                                                           pool["DELTET/EB"][0].get<double>(),
+                                                                           pool["DELTET/M"][0].get<double>(),
+                                                                           pool["DELTET/M"][1].get<double>()));
+            SPDLOG_DEBUG("Loaded {} leap seconds from {}", taiUtc.size(), lskPath);
+        }
+        catch (exception &e) {
+            SPDLOG_DEBUG("Could not read the leap seconds of {}, the LSK will be furnished: {}", lskPath, e.what());
+        }
+
+        lock_guard<mutex> lock(cacheMutex);
+        cache[key] = table;
+        return table;
+    }
+
+
+    // Whether utcet formats ET like et2utc_c for the given format and precision.
+    static bool utcetSupportsFormat(string format, double precision) {
+        static const vector<string> formats = {"C", "D", "J", "ISOC", "ISOD"};
+        format = toUpper(format);
+        return find(formats.begin(), formats.end(), format) != formats.end() && precision >= 0 && precision <= 14;
+    }
+
+
+    pair<double, json> utcToEt(string utc, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"utc", utc},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("utcToEt", args, useWeb);
+            double result = out["body"]["return"].get<double>();
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        json lsks = searchLskKernels(searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        // Use the leap seconds of the LSK without furnishing it when utcet can parse the string
+        shared_ptr<const LeapSecondTable> leapSeconds = loadLeapSecondTable(lsks);
+        if (leapSeconds) {
+            try {
+                SPDLOG_TRACE("Using utcet with the LSK leap seconds for UTC to ET conversion");
+                return {calendarTimeToEphemTime(utc, *leapSeconds), lsks};
+            }
+            catch (exception &e) {
+                SPDLOG_DEBUG("utcet could not convert {}, falling back to the LSK kernel: {}", utc, e.what());
+            }
+        }
+
+        double et;
+
+        // Use LSK kernel if available, otherwise fall back to utcet
+        if(searchKernels || !kernelList.empty()) {
+            SPDLOG_TRACE("Using LSK kernel for UTC to ET conversion");
+            CspiceGuard cspice;
+            KernelSet lsk(lsks);
+            checkNaifErrors();
+            str2et_c(utc.c_str(), &et);
+            checkNaifErrors();
+        } else {
+            SPDLOG_TRACE("No kernels provided, using utcet for UTC to ET conversion");
+            et = calendarTimeToEphemTime(utc);
+        }
+
+        return {et, lsks};
+    }
+
+
+    pair<string, json> etToUtc(double et, string format, double precision, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"et", et},
+                {"format", format},
+                {"precision", precision},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("etToUtc", args, useWeb);
+            string result = out["body"]["return"].get<string>();
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        json lsks = searchLskKernels(searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        // Use the leap seconds of the LSK without furnishing it when utcet supports the format
+        shared_ptr<const LeapSecondTable> leapSeconds = loadLeapSecondTable(lsks);
+        if (leapSeconds && utcetSupportsFormat(format, precision)) {
+            SPDLOG_TRACE("Using utcet with the LSK leap seconds for ET to UTC conversion");
+            int prec = static_cast<int>(precision);
+            return {ephemTimeToCalendarTime(et, format, prec, 100, *leapSeconds), lsks};
+        }
+
+        string utc_string;
+
+        // Use LSK kernel if available, otherwise fall back to utcet
+        if(searchKernels || !kernelList.empty()) {
+            SPDLOG_TRACE("Using LSK kernel for ET to UTC conversion");
+            CspiceGuard cspice;
+            KernelSet lsk(lsks);
+            SpiceChar utc_spice[100];
+            checkNaifErrors();
+            et2utc_c(et, format.c_str(), precision, 100, utc_spice);
+            checkNaifErrors();
+            utc_string = string(utc_spice);
+        } else {
+            SPDLOG_TRACE("No kernels provided, using utcet for ET to UTC conversion");
+            // Note: format and precision parameters are used with utcet
+            // utcet always returns ISO 8601 format with Z suffix
+            int prec = static_cast<int>(precision);
+            int utclen = 19 + prec + 3;  // Fixed format size
+            utc_string = ephemTimeToCalendarTime(et, format, prec, utclen);
+        }
+
+        return {utc_string, lsks};
+    }
+
+
+    pair<vector<double>, json> utcToEtBatch(vector<string> utcs, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling utcToEtBatch({} utcs, {}, {}, {})", utcs.size(), useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"utcs", utcs},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("utcToEtBatch", args, useWeb, "POST");
+            vector<double> result = jsonDoubleArrayToVector(out["body"]["return"]);
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        if (utcs.empty()) {
+            return {{}, {}};
+        }
+
+        json lsks = searchLskKernels(searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+        vector<double> ets(utcs.size());
+
+        // Use the leap seconds of the LSK without furnishing it when utcet can parse the strings
+        shared_ptr<const LeapSecondTable> leapSeconds = loadLeapSecondTable(lsks);
+        if (leapSeconds) {
+            try {
+                SPDLOG_TRACE("Using utcet with the LSK leap seconds for UTC to ET conversion");
+                calendarTimesToEphemTimes(utcs.data(), ets.data(), utcs.size(), *leapSeconds);
+                SPDLOG_DEBUG("utcToEtBatch converted {} utcs", ets.size());
+                return {ets, lsks};
+            }
+            catch (exception &e) {
+                SPDLOG_DEBUG("utcet could not convert the utcs, falling back to the LSK kernel: {}", e.what());
+            }
+        }
+
+        // Use LSK kernel if available, otherwise fall back to utcet
+        if (searchKernels || !kernelList.empty()) {
+            SPDLOG_TRACE("Using LSK kernel for UTC to ET conversion");
+            CspiceGuard cspice;
+            KernelSet lsk(lsks);
+            checkNaifErrors();
+            for (size_t i = 0; i < utcs.size(); i++) {
+                str2et_c(utcs[i].c_str(), &ets[i]);
+                checkNaifErrors();
+            }
+        }
+        else {
+            SPDLOG_TRACE("No kernels provided, using utcet for UTC to ET conversion");
+            calendarTimesToEphemTimes(utcs.data(), ets.data(), utcs.size());
+        }
+        SPDLOG_DEBUG("utcToEtBatch converted {} utcs", ets.size());
+
+        return {ets, lsks};
+    }
+
+
+    pair<vector<string>, json> etToUtcBatch(vector<double> ets, string format, double precision, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling etToUtcBatch({} ets, {}, {}, {}, {}, {})", ets.size(), format, precision, useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"ets", ets},
+                {"format", format},
+                {"precision", precision},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("etToUtcBatch", args, useWeb, "POST");
+            vector<string> result = jsonArrayToVector(out["body"]["return"]);
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        if (ets.empty()) {
+            return {{}, {}};
+        }
+
+        json lsks = searchLskKernels(searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+        vector<string> utcs(ets.size());
+
+        // Use the leap seconds of the LSK without furnishing it when utcet supports the format
+        shared_ptr<const LeapSecondTable> leapSeconds = loadLeapSecondTable(lsks);
+        if (leapSeconds && utcetSupportsFormat(format, precision)) {
+            SPDLOG_TRACE("Using utcet with the LSK leap seconds for ET to UTC conversion");
+            ephemTimesToCalendarTimes(ets.data(), utcs.data(), ets.size(), format, static_cast<int>(precision), 100, *leapSeconds);
+            SPDLOG_DEBUG("etToUtcBatch converted {} ets", utcs.size());
+            return {utcs, lsks};
+        }
+
+        // Use LSK kernel if available, otherwise fall back to utcet
+        if (searchKernels || !kernelList.empty()) {
+            SPDLOG_TRACE("Using LSK kernel for ET to UTC conversion");
+            CspiceGuard cspice;
+            KernelSet lsk(lsks);
+            SpiceChar utc_spice[100];
+            checkNaifErrors();
+            for (size_t i = 0; i < ets.size(); i++) {
+                et2utc_c(ets[i], format.c_str(), precision, 100, utc_spice);
+                checkNaifErrors();
+                utcs[i] = utc_spice;
+            }
+        }
+        else {
+            SPDLOG_TRACE("No kernels provided, using utcet for ET to UTC conversion");
+            int prec = static_cast<int>(precision);
+            int utclen = 19 + prec + 3;  // Fixed format size
+            ephemTimesToCalendarTimes(ets.data(), utcs.data(), ets.size(), format, prec, utclen);
+        }
+        SPDLOG_DEBUG("etToUtcBatch converted {} ets", utcs.size());
+
+        return {utcs, lsks};
+    }
+
+
+    /**
+     * Search the frame defining kernels (fk, ik, iak) of a mission plus any
+     * kernels the user asked for, as translateNameToCode and translateCodeToName do.
+     */
+    static json searchFrameKernels(string mission, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        json kernelsToLoad = {};
+
+        if (mission != "" && searchKernels) {
+            kernelsToLoad = Inventory::search_for_kernelset(mission, {"fk", "ik", "iak"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
+        }
+
+        if (!kernelList.empty()) {
+            json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
+            // merge them into the ephem kernels overwriting anything found in the query
+            merge_json(kernelsToLoad, regexk);
+        }
+        return kernelsToLoad;
+    }
+
+
+    /**
+     * NAIF name to code with the frame kernels already furnished, bodies first like NAIF. 0 if not found.
+     */
+    static int furnishedNameToCode(const string &frame) {
+        SpiceInt code = 0;
+        SpiceBoolean found;
+
+        checkNaifErrors();
+        bodn2c_c(frame.c_str(), &code, &found);
         checkNaifErrors();
-        frinfo_c(frame, &cent, &frclss, &clssid, &found);
-        checkNaifErrors();
-        SPDLOG_TRACE("RETURN FROM FRINFO: {}, {}, {}, {}", cent, frclss, clssid, found);
 
         if (!found) {
+            namfrm_c(frame.c_str(), &code);
+            checkNaifErrors();
+        }
+        return code;
+    }
+
+
+    /**
+     * NAIF code to name with the frame kernels already furnished, bodies first like NAIF. "" if not found.
+     */
+    static string furnishedCodeToName(int frame) {
+        SpiceChar name[128];
+        SpiceBoolean found;
+
+        checkNaifErrors();
+        bodc2n_c(frame, 128, name, &found);
+        checkNaifErrors();
+
+        if(!found) {  
+            frmnam_c(frame, 128, name);
+            checkNaifErrors();
+        }
+        return string(name);
+    }
+
+
+    pair<int, json> translateNameToCode(string frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {    
+        
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"frame", frame},
+                {"mission", mission},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("translateNameToCode", args, useWeb);
+            int result = out["body"]["return"].get<int>();
+            return make_pair(result, out["body"]["kernels"]);
+        }
+        
+        if (mission.empty()) mission = inferMission({frame}, {});
+
+        json kernelsToLoad = searchFrameKernels(mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        // The DB frame cache holds every body and frame of the mission kernels,
+        // user kernels could redefine them so those are always furnished
+        int code = kernelList.empty() ? Inventory::getFrameCodeFromCache(frame) : 0;
+        if (code != 0) {
+            SPDLOG_DEBUG("Resolved frame name {} to {} from the frame cache", frame, code);
+            return {code, kernelsToLoad};
+        }
+
+        CspiceGuard cspice;
+        KernelSet kset(kernelsToLoad);
+        code = furnishedNameToCode(frame);
+
+        if (code == 0) {
+            throw invalid_argument(fmt::format("Frame code for frame name [{}] not found.", frame));
+        }
+
+        return {code, kernelsToLoad};
+    }
+
+
+    pair<vector<int>, json> translateNameToCodeBatch(vector<string> frames, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling translateNameToCodeBatch({} frames, {}, {}, {}, {})", frames.size(), mission, useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"frames", frames},
+                {"mission", mission},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("translateNameToCodeBatch", args, useWeb, "POST");
+            vector<int> result = out["body"]["return"].get<vector<int>>();
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        if (frames.empty()) {
+            return {{}, {}};
+        }
+
+        if (mission.empty()) mission = inferMission(frames, {});
+
+        json kernelsToLoad = searchFrameKernels(mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        vector<int> codes(frames.size(), 0);
+        vector<size_t> misses;
+        for (size_t i = 0; i < frames.size(); i++) {
+            codes[i] = kernelList.empty() ? Inventory::getFrameCodeFromCache(frames[i]) : 0;
+            if (codes[i] == 0) {
+                misses.push_back(i);
+            }
+        }
+        SPDLOG_DEBUG("translateNameToCodeBatch resolved {} of {} frames from the frame cache", frames.size() - misses.size(), frames.size());
+
+        if (!misses.empty()) {
+            CspiceGuard cspice;
+            KernelSet kset(kernelsToLoad);
+            for (size_t i : misses) {
+                codes[i] = furnishedNameToCode(frames[i]);
+                if (codes[i] == 0) {
+                    throw invalid_argument(fmt::format("Frame code for frame name [{}] not found.", frames[i]));
+                }
+            }
+        }
+
+        return {codes, kernelsToLoad};
+    }
+
+
+    pair<string, json> translateCodeToName(int frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"frame", frame},
+                {"mission", mission},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("translateCodeToName", args, useWeb);
+            string result = out["body"]["return"].get<string>();
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        if (mission.empty()) mission = inferMission({}, {frame});
+
+        json kernelsToLoad = searchFrameKernels(mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        string name = kernelList.empty() ? Inventory::getFrameNameFromCache(frame) : "";
+        if (!name.empty()) {
+            SPDLOG_DEBUG("Resolved frame code {} to {} from the frame cache", frame, name);
+            return {name, kernelsToLoad};
+        }
+
+        CspiceGuard cspice;
+        KernelSet kset(kernelsToLoad);
+        name = furnishedCodeToName(frame);
+
+        if(name.empty()) {
+            throw invalid_argument(fmt::format("Frame name for code {} not found.", frame));
+        }
+
+        return {name, kernelsToLoad};
+    }
+
+
+    pair<vector<string>, json> translateCodeToNameBatch(vector<int> frames, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling translateCodeToNameBatch({} frames, {}, {}, {}, {})", frames.size(), mission, useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"frames", frames},
+                {"mission", mission},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("translateCodeToNameBatch", args, useWeb, "POST");
+            vector<string> result = jsonArrayToVector(out["body"]["return"]);
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        if (frames.empty()) {
+            return {{}, {}};
+        }
+
+        if (mission.empty()) mission = inferMission({}, frames);
+
+        json kernelsToLoad = searchFrameKernels(mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        vector<string> names(frames.size());
+        vector<size_t> misses;
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (kernelList.empty()) {
+                names[i] = Inventory::getFrameNameFromCache(frames[i]);
+            }
+            if (names[i].empty()) {
+                misses.push_back(i);
+            }
+        }
+        SPDLOG_DEBUG("translateCodeToNameBatch resolved {} of {} codes from the frame cache", frames.size() - misses.size(), frames.size());
+
+        if (!misses.empty()) {
+            CspiceGuard cspice;
+            KernelSet kset(kernelsToLoad);
+            for (size_t i : misses) {
+                names[i] = furnishedCodeToName(frames[i]);
+                if (names[i].empty()) {
+                    throw invalid_argument(fmt::format("Frame name for code {} not found.", frames[i]));
+                }
+            }
+        }
+
+        return {names, kernelsToLoad};
+    }
+
+
+    /**
+     * Search the FKs of a mission plus any kernels the user asked for, as getFrameInfo does.
+     */
+    static json searchFrameInfoKernels(string mission, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        json kernelsToLoad = {};
+
+        if (mission != "" && searchKernels) {
+            // Load only the FKs
+            kernelsToLoad = Inventory::search_for_kernelset(mission, {"fk"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
+        }
+        if (!kernelList.empty()) {
+            json regexk = Inventory::search_for_kernelset_from_regex(kernelList, fullKernelPath);
+            // merge them into the ephem kernels overwriting anything found in the query
+            merge_json(kernelsToLoad, regexk);
+        }
+        return kernelsToLoad;
+    }
+
+
+    /**
+     * frinfo_c with the frame kernels already furnished. Empty if not found.
+     */
+    static vector<int> furnishedFrameInfo(int frame) {
+        SpiceInt cent;
+        SpiceInt frclss;
+        SpiceInt clssid;
+        SpiceBoolean found;
+
+        checkNaifErrors();
+        frinfo_c(frame, &cent, &frclss, &clssid, &found);
+        checkNaifErrors();
+        SPDLOG_TRACE("RETURN FROM FRINFO: {}, {}, {}, {}", cent, frclss, clssid, found);
+
+        if (!found) {
+            return {};
+        }
+        return {cent, frclss, clssid};
+    }
+
+
+    pair<vector<int>, json> getFrameInfo(int frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"frame", frame},
+                {"mission", mission},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("getFrameInfo", args, useWeb);
+            vector<int> result = jsonIntArrayToVector(out["body"]["return"]);
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        if (mission.empty()) mission = inferMission({}, {frame});
+
+        json kernelsToLoad = searchFrameInfoKernels(mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        vector<int> info = kernelList.empty() ? Inventory::getFrameInfoFromCache(frame, mission) : vector<int>();
+        if (!info.empty()) {
+            SPDLOG_DEBUG("Frame info of {} read from the frame cache", frame);
+            return {info, kernelsToLoad};
+        }
+
+        CspiceGuard cspice;
+        KernelSet kset(kernelsToLoad);
+        info = furnishedFrameInfo(frame);
+
+        if (info.empty()) {
             throw invalid_argument(fmt::format("Frame info for code {} not found.", frame));
         }
 
-        return {{cent, frclss, clssid}, kernelsToLoad};
+        return {info, kernelsToLoad};
+    }
+
+
+    pair<vector<vector<int>>, json> getFrameInfoBatch(vector<int> frames, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        SPDLOG_TRACE("calling getFrameInfoBatch({} frames, {}, {}, {}, {})", frames.size(), mission, useWeb, searchKernels, kernelList.size());
+
+        if (useWeb || LocalEngine::active()) {
+            json args = json::object({
+                {"frames", frames},
+                {"mission", mission},
+                {"searchKernels", searchKernels},
+                {"fullKernelPath", fullKernelPath},
+                {"limitCk", limitCk},
+                {"limitSpk", limitSpk},
+                {"kernelList", kernelList}
+            });
+            json out = remoteQuery("getFrameInfoBatch", args, useWeb, "POST");
+            vector<vector<int>> result = out["body"]["return"].get<vector<vector<int>>>();
+            return make_pair(result, out["body"]["kernels"]);
+        }
+
+        if (frames.empty()) {
+            return {{}, {}};
+        }
+
+        if (mission.empty()) mission = inferMission({}, frames);
+
+        json kernelsToLoad = searchFrameInfoKernels(mission, searchKernels, fullKernelPath, limitCk, limitSpk, kernelList);
+
+        vector<vector<int>> infos = kernelList.empty() ? Inventory::getFrameInfoFromCache(frames, mission) : vector<vector<int>>(frames.size());
+        vector<size_t> misses;
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (infos[i].empty()) {
+                misses.push_back(i);
+            }
+        }
+        SPDLOG_DEBUG("getFrameInfoBatch read {} of {} frames from the frame cache", frames.size() - misses.size(), frames.size());
+
+        if (!misses.empty()) {
+            CspiceGuard cspice;
+            KernelSet kset(kernelsToLoad);
+            for (size_t i : misses) {
+                infos[i] = furnishedFrameInfo(frames[i]);
+                if (infos[i].empty()) {
+                    throw invalid_argument(fmt::format("Frame info for code {} not found.", frames[i]));
+                }
+            }
+        }
+
+        return {infos, kernelsToLoad};
     }
 
 
     pair<json, json> getTargetFrameInfo(int targetId, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
         
-        if (useWeb){
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"targetId", targetId},
                 {"mission", mission},
@@ -929,7 +1856,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("getTargetFrameInfo", args);
+            json out = remoteQuery("getTargetFrameInfo", args, useWeb);
             json result = out["body"]["return"];
             return make_pair(result, out["body"]["kernels"]);
         }
@@ -953,6 +1880,18 @@ namespace SpiceQL {
             merge_json(kernelsToLoad, regexk);
         }
 
+        // The cached association assumes the mission and base FKs are what is furnished
+        if (mission != "" && searchKernels && kernelList.empty()) {
+            auto [cachedCode, cachedName] = Inventory::getTargetFrameFromCache(targetId, mission);
+            if (cachedCode != 0) {
+                SPDLOG_DEBUG("Target frame of {} read from the frame cache", targetId);
+                frameInfo["frameCode"] = cachedCode;
+                frameInfo["frameName"] = cachedName;
+                return {frameInfo, kernelsToLoad};
+            }
+        }
+
+        CspiceGuard cspice;
         KernelSet kSet(kernelsToLoad);
 
         checkNaifErrors();
@@ -970,9 +1909,20 @@ namespace SpiceQL {
     }
 
 
+    // Keywords matching key in a kernel set, read with the text kernel parser instead
+    // of furnishing the set. Without kernels this falls back to the pool as before.
+    static json findKernelSetKeywords(string key, json kernels) {
+        vector<string> paths = resolveKernelPaths(kernels);
+        if (paths.empty()) {
+            return findKeywords(key);
+        }
+        return findTextKernelKeywords(key, paths);
+    }
+
+
     pair<json, json> findMissionKeywords(string key, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
         
-        if (useWeb){
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"key", key},
                 {"mission", mission},
@@ -982,7 +1932,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("findMissionKeywords", args);
+            json out = remoteQuery("findMissionKeywords", args, useWeb);
             json result = out["body"]["return"];
             return make_pair(result, out["body"]["kernels"]);
         }
@@ -991,6 +1941,14 @@ namespace SpiceQL {
 
         if (mission != "" && searchKernels) {
             translationKernels = Inventory::search_for_kernelset(mission, {"iak", "fk", "ik", "iak"}, default_StartTime, default_StopTime, default_KernelQualities, default_KernelQualities, fullKernelPath, limitCk, limitSpk);
+
+            // the DB holds the keyword pool of exactly these kernels
+            if (kernelList.empty()) {
+                json keywords = Inventory::findMissionKeywordsFromCache(key, mission);
+                if (!keywords.is_null()) {
+                    return {keywords.empty() ? json(nullptr) : keywords, translationKernels};
+                }
+            }
         }
 
         if (!kernelList.empty()) {
@@ -999,15 +1957,13 @@ namespace SpiceQL {
             merge_json(translationKernels, regexk);
         }
 
-        KernelSet kset(translationKernels);
-
-        return {findKeywords(key), translationKernels};
+        return {findKernelSetKeywords(key, translationKernels), translationKernels};
     }
 
 
     pair<json, json> findTargetKeywords(string key, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
         
-        if (useWeb){
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"key", key},
                 {"mission", mission},
@@ -1017,7 +1973,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("findTargetKeywords", args);
+            json out = remoteQuery("findTargetKeywords", args, useWeb);
             json result = out["body"]["return"];
             return make_pair(result, out["body"]["kernels"]);
         }
@@ -1034,27 +1990,27 @@ namespace SpiceQL {
             merge_json(kernelsToLoad, regexk);
         }
 
-        KernelSet kSet(kernelsToLoad);
-        return {findKeywords(key), kernelsToLoad};
+        return {findKernelSetKeywords(key, kernelsToLoad), kernelsToLoad};
     }
 
 
     pair<vector<vector<int>>, json> frameTrace(double et, int initialFrame, string mission, vector<string> ckQualities, vector<string> spkQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
         checkNaifErrors();
 
-        if (useWeb){
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"et", et},
                 {"initialFrame", initialFrame},
                 {"mission", mission},
                 {"ckQualities", ckQualities},
+                {"spkQualities", spkQualities},
                 {"searchKernels", searchKernels},
                 {"fullKernelPath", fullKernelPath},
                 {"limitCk", limitCk},
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("frameTrace", args);
+            json out = remoteQuery("frameTrace", args, useWeb);
             vector<vector<int>> kvect = json2DIntArrayTo2DVector(out["body"]["return"], true);
             return make_pair(kvect, out["body"]["kernels"]);
         }
@@ -1072,14 +2028,48 @@ namespace SpiceQL {
             // merge them into the ephem kernels overwriting anything found in the query
             merge_json(ephemKernels, regexk);
         }
-        KernelSet ephemSet(ephemKernels);
+        // Kernels are only furnished once a link needs them: a CK or dynamic
+        // frame, or a frame that is not in the DB frame cache. Chains of TK,
+        // inertial and PCK frames resolve from the cache alone.
+        bool useCache = kernelList.empty();
+        // declared first so the guard is released after the kernels are unloaded
+        unique_ptr<CspiceGuard> cspice;
+        unique_ptr<KernelSet> ephemSet;
+        auto furnish = [&]() {
+            if (!ephemSet) {
+                SPDLOG_TRACE("frameTrace furnishing kernels for a time dependent link");
+                cspice = make_unique<CspiceGuard>();
+                ephemSet = make_unique<KernelSet>(ephemKernels);
+                checkNaifErrors();
+            }
+        };
+
+        // frinfo_c, answered from the frame cache when possible
+        auto frameInfo = [&](int code, int &center, int &type, int &typid) -> bool {
+            if (useCache) {
+                vector<int> info = Inventory::getFrameInfoFromCache(code, mission);
+                if (!info.empty()) {
+                    center = info[0];
+                    type = info[1];
+                    typid = info[2];
+                    return true;
+                }
+            }
+            furnish();
+            SpiceBoolean found;
+            frinfo_c((SpiceInt)code,
+                        (SpiceInt *)&center,
+                        (SpiceInt *)&type,
+                        (SpiceInt *)&typid, &found);
+            return found;
+        };
 
         checkNaifErrors();
         // The code for this method was extracted from the Naif routine rotget written by N.J. Bachman &
         //   W.L. Taber (JPL)
-        int           center;
-        int           type;
-        int           typid;
+        int           center = 0;
+        int           type = 0;
+        int           typid = 0;
         SpiceBoolean  found;
         int           frmidx;  // Frame chain index for current frame
         SpiceInt      nextFrame;   // Naif frame code of next frame
@@ -1090,10 +2080,7 @@ namespace SpiceQL {
         vector<int> constantFrames;
         vector<int> timeFrames;
         frameCodes.push_back(initialFrame);
-        frinfo_c((SpiceInt)frameCodes[0],
-                    (SpiceInt *)&center,
-                    (SpiceInt *)&type,
-                    (SpiceInt *)&typid, &found);
+        frameInfo(frameCodes[0], center, type, typid);
         frameTypes.push_back(type);
 
         while (frameCodes[frameCodes.size() - 1] != J2000Code) {
@@ -1105,10 +2092,7 @@ namespace SpiceQL {
             // logic for FrameTypes in this method is correct for all types except type 7.  Current pck
             // do not exercise this option.  Should we ever use pck with a target body not referenced to
             // the J2000 frame and epoch, both this method and loadPCFromSpice will need to be modified.
-            frinfo_c((SpiceInt) frameCodes[frmidx],
-                    (SpiceInt *) &center,
-                    (SpiceInt *) &type,
-                    (SpiceInt *) &typid, &found);
+            found = frameInfo(frameCodes[frmidx], center, type, typid);
 
             if (!found) {
             string msg = "The frame " + to_string(frameCodes[frmidx]) + " is not supported by Naif";
@@ -1124,6 +2108,7 @@ namespace SpiceQL {
             }
             // 3 = CK
             else if (type == 3) {
+            furnish();
             ckfrot_((SpiceInt *) &typid, &et, (double *) matrix, &nextFrame, (logical *) &found);
 
             if (!found) {
@@ -1133,13 +2118,20 @@ namespace SpiceQL {
                 throw logic_error(msg);
             }
             }
-            // 4 = TK
+            // 4 = TK, the parent edge is stored in the frame cache
             else if (type == 4) {
-            tkfram_((SpiceInt *) &typid, (double *) matrix, &nextFrame, (logical *) &found);
-            if (!found) {
-                string msg = "The tk rotation from frame " + to_string(frameCodes[frmidx]) +
-                            " can not be found";
-                throw logic_error(msg);
+            int parent = useCache ? Inventory::getTkFrameFromCache(frameCodes[frmidx], mission).first : 0;
+            if (parent != 0) {
+                nextFrame = parent;
+            }
+            else {
+                furnish();
+                tkfram_((SpiceInt *) &typid, (double *) matrix, &nextFrame, (logical *) &found);
+                if (!found) {
+                    string msg = "The tk rotation from frame " + to_string(frameCodes[frmidx]) +
+                                " can not be found";
+                    throw logic_error(msg);
+                }
             }
             }
             // 5 = DYN
@@ -1150,6 +2142,7 @@ namespace SpiceQL {
             //        dynamic frame class ID. ZZDYNROT also requires the center ID
             //        we found via the FRINFO call.
 
+            furnish();
             zzdynrot_((SpiceInt *) &typid, (SpiceInt *) &center, &et, (double *) matrix, &nextFrame);
             }
 
@@ -1196,7 +2189,7 @@ namespace SpiceQL {
     pair<vector<double>, json> extractExactCkTimes(double observStart, double observEnd, int targetFrame, string mission, vector<string> ckQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
         SPDLOG_TRACE("Calling extractExactCkTimes with {}, {}, {}, {}, {}, {}, {}", observStart, observEnd, targetFrame, mission, ckQualities.size(), useWeb, searchKernels);
         
-        if (useWeb){
+        if (useWeb || LocalEngine::active()) {
             json args = json::object({
                 {"observStart", observStart},
                 {"observEnd", observEnd},
@@ -1209,7 +2202,7 @@ namespace SpiceQL {
                 {"limitSpk", limitSpk},
                 {"kernelList", kernelList}
             });
-            json out = spiceAPIQuery("extractExactCkTimes", args);
+            json out = remoteQuery("extractExactCkTimes", args, useWeb);
             vector<double> kvect = jsonDoubleArrayToVector(out["body"]["return"]);
             return make_pair(kvect, out["body"]["kernels"]);
         }
@@ -1229,6 +2222,7 @@ namespace SpiceQL {
             merge_json(ephemKernels, regexk);
         }
 
+        CspiceGuard cspice;
         KernelSet ephemSet(ephemKernels);
 
         int count = 0;
@@ -1382,6 +2376,18 @@ namespace SpiceQL {
                                                           int limitSpk,
                                                           bool overwrite) {
     SPDLOG_TRACE("Calling searchForKernelsets with {}, {}, {}, {}, {}, {}, {}", spiceqlNames, types, startTime, stopTime, ckQualities.size(), spkQualities.size(), useWeb);
+      SingleFlight &flights = SingleFlight::instance();
+      if (flights.shouldCoalesce()) {
+        json call = {{"spiceqlNames", spiceqlNames}, {"types", types}, {"startTime", startTime}, {"stopTime", stopTime},
+                     {"ckQualities", ckQualities}, {"spkQualities", spkQualities}, {"useWeb", useWeb},
+                     {"fullKernelPath", fullKernelPath}, {"limitCk", limitCk}, {"limitSpk", limitSpk},
+                     {"overwrite", overwrite}};
+        return flights.run<pair<string, json>>(SingleFlight::makeKey("searchForKernelsets", call), [&]() {
+          return searchForKernelsets(spiceqlNames, types, startTime, stopTime, ckQualities, spkQualities, useWeb,
+                                     fullKernelPath, limitCk, limitSpk, overwrite);
+        });
+      }
+
     
       if (useWeb){
         json args = json::object({
@@ -1403,4 +2409,31 @@ namespace SpiceQL {
       json kernels = Inventory::search_for_kernelsets(spiceqlNames, types, startTime, stopTime, ckQualities, spkQualities, fullKernelPath, limitCk, limitSpk, overwrite);
       return {"", kernels};
   }
+
+
+  std::pair<json, json> getKernelCoverage(string mission, 
+                                          string type, 
+                                          vector<string> qualities, 
+                                          double startTime, 
+                                          double stopTime, 
+                                          int naifCode, 
+                                          bool useWeb) {
+    SPDLOG_TRACE("Calling getKernelCoverage with {}, {}, {}, {}, {}, {}, {}", mission, type, qualities, startTime, stopTime, naifCode, useWeb);
+
+    if (useWeb) {
+      json args = json::object({
+          {"mission", mission},
+          {"type", type},
+          {"qualities", qualities},
+          {"startTime", startTime},
+          {"stopTime", stopTime},
+          {"naifCode", naifCode}
+      });
+      json out = spiceAPIQuery("getKernelCoverage", args);
+      return make_pair(out["body"]["return"], out["body"]["kernels"]);
+    }
+
+    json coverage = Inventory::getCoverage(mission, type, qualities, startTime, stopTime, naifCode);
+    return {coverage, {}};
+  }
 }
@@ -0,0 +1,221 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include "SpiceQL/api_async.h"
+#include "SpiceQL/executor.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace SpiceQL {
+
+    namespace {
+        // Calls run as a whole on the worker pool. The spans that furnish
+        // kernels, call CSPICE and unload them hold a CspiceGuard, so only
+        // those wait for each other, searches, DB lookups and JSON work of
+        // other calls run in parallel.
+        template <typename Fn>
+        auto dispatch(Fn fn) {
+            return workerPool().submit(std::move(fn));
+        }
+    }
+
+
+    future<pair<vector<vector<double>>, json>> getTargetStatesAsync(vector<double> ets, string target, string observer, string frame, string abcorr, string mission, vector<string> ckQualities, vector<string> spkQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getTargetStates(std::move(ets), std::move(target), std::move(observer), std::move(frame), std::move(abcorr), std::move(mission), std::move(ckQualities), std::move(spkQualities), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<vector<double>>, json>> getTargetStatesRangedAsync(double startEt, double stopEt, int numRecords, string target, string observer, string frame, string abcorr, string mission, vector<string> ckQualities, vector<string> spkQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getTargetStatesRanged(startEt, stopEt, numRecords, std::move(target), std::move(observer), std::move(frame), std::move(abcorr), std::move(mission), std::move(ckQualities), std::move(spkQualities), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<vector<double>>, json>> getTargetOrientationsAsync(vector<double> ets, int toFrame, int refFrame, string mission, vector<string> ckQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getTargetOrientations(std::move(ets), toFrame, refFrame, std::move(mission), std::move(ckQualities), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<vector<double>>, json>> getTargetOrientationsRangedAsync(double startEt, double stopEt, int numRecords, int toFrame, int refFrame, string mission, vector<string> ckQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getTargetOrientationsRanged(startEt, stopEt, numRecords, toFrame, refFrame, std::move(mission), std::move(ckQualities), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<double, json>> strSclkToEtAsync(int frameCode, string sclk, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return strSclkToEt(frameCode, std::move(sclk), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<double, json>> doubleSclkToEtAsync(int frameCode, double sclk, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return doubleSclkToEt(frameCode, sclk, std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<string, json>> doubleEtToSclkAsync(int frameCode, double et, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return doubleEtToSclk(frameCode, et, std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<double>, json>> strSclkToEtBatchAsync(int frameCode, vector<string> sclks, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return strSclkToEtBatch(frameCode, std::move(sclks), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<double>, json>> doubleSclkToEtBatchAsync(int frameCode, vector<double> sclks, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return doubleSclkToEtBatch(frameCode, std::move(sclks), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<string>, json>> doubleEtToSclkBatchAsync(int frameCode, vector<double> ets, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return doubleEtToSclkBatch(frameCode, std::move(ets), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<double, json>> utcToEtAsync(string utc, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return utcToEt(std::move(utc), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<string, json>> etToUtcAsync(double et, string format, double precision, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return etToUtc(et, std::move(format), precision, useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<double>, json>> utcToEtBatchAsync(vector<string> utcs, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return utcToEtBatch(std::move(utcs), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<string>, json>> etToUtcBatchAsync(vector<double> ets, string format, double precision, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return etToUtcBatch(std::move(ets), std::move(format), precision, useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<int, json>> translateNameToCodeAsync(string frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return translateNameToCode(std::move(frame), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<int>, json>> translateNameToCodeBatchAsync(vector<string> frames, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return translateNameToCodeBatch(std::move(frames), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<string, json>> translateCodeToNameAsync(int frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return translateCodeToName(frame, std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<string>, json>> translateCodeToNameBatchAsync(vector<int> frames, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return translateCodeToNameBatch(std::move(frames), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<int>, json>> getFrameInfoAsync(int frame, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getFrameInfo(frame, std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<vector<int>>, json>> getFrameInfoBatchAsync(vector<int> frames, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getFrameInfoBatch(std::move(frames), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<json, json>> getTargetFrameInfoAsync(int targetId, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getTargetFrameInfo(targetId, std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<json, json>> findMissionKeywordsAsync(string key, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return findMissionKeywords(std::move(key), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<json, json>> findTargetKeywordsAsync(string key, string mission, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return findTargetKeywords(std::move(key), std::move(mission), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<vector<int>>, json>> frameTraceAsync(double et, int initialFrame, string mission, vector<string> ckQualities, vector<string> spkQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return frameTrace(et, initialFrame, std::move(mission), std::move(ckQualities), std::move(spkQualities), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<double>, json>> extractExactCkTimesAsync(double observStart, double observEnd, int targetFrame, string mission, vector<string> ckQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return extractExactCkTimes(observStart, observEnd, targetFrame, std::move(mission), std::move(ckQualities), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<vector<vector<double>>, json>> getExactTargetOrientationsAsync(double startEt, double stopEt, int toFrame, int refFrame, int exactCkFrame, string mission, vector<string> ckQualities, bool useWeb, bool searchKernels, bool fullKernelPath, int limitCk, int limitSpk, vector<string> kernelList) {
+        return dispatch([=]() mutable {
+            return getExactTargetOrientations(startEt, stopEt, toFrame, refFrame, exactCkFrame, std::move(mission), std::move(ckQualities), useWeb, searchKernels, fullKernelPath, limitCk, limitSpk, std::move(kernelList));
+        });
+    }
+
+
+    future<pair<string, json>> searchForKernelsetsAsync(vector<string> spiceqlNames, vector<string> types, double startTime, double stopTime, vector<string> ckQualities, vector<string> spkQualities, bool useWeb, bool fullKernelPath, int limitCk, int limitSpk, bool overwrite) {
+        return dispatch([=]() mutable {
+            return searchForKernelsets(std::move(spiceqlNames), std::move(types), startTime, stopTime, std::move(ckQualities), std::move(spkQualities), useWeb, fullKernelPath, limitCk, limitSpk, overwrite);
+        });
+    }
+
+
+    future<pair<json, json>> getKernelCoverageAsync(string mission, string type, vector<string> qualities, double startTime, double stopTime, int naifCode, bool useWeb) {
+        return dispatch([=]() mutable {
+            return getKernelCoverage(std::move(mission), std::move(type), std::move(qualities), startTime, stopTime, naifCode, useWeb);
+        });
+    }
+}
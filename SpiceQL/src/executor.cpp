@@ -0,0 +1,96 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include <algorithm>
+
+#include "SpiceQL/executor.h"
+#include "SpiceQL/spiceql_logging.h"
+
+using namespace std;
+
+namespace SpiceQL {
+
+  namespace {
+    // the queue whose task the current thread is running, if any
+    thread_local const TaskQueue *currentQueue = nullptr;
+
+    recursive_mutex &cspiceMutex() {
+      static recursive_mutex *mutex = new recursive_mutex();
+      return *mutex;
+    }
+  }
+
+
+  CspiceGuard::CspiceGuard() {
+    cspiceMutex().lock();
+  }
+
+
+  CspiceGuard::~CspiceGuard() {
+    cspiceMutex().unlock();
+  }
+
+
+  TaskQueue::TaskQueue(size_t threads, string name) : m_name(name) {
+    threads = max<size_t>(threads, 1);
+    for (size_t i = 0; i < threads; i++) {
+      m_threads.emplace_back([this]() { work(); });
+    }
+    SPDLOG_DEBUG("Started {} with {} threads", m_name, threads);
+  }
+
+
+  TaskQueue::~TaskQueue() {
+    {
+      lock_guard<mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_ready.notify_all();
+    for (thread &t : m_threads) {
+      t.join();
+    }
+  }
+
+
+  bool TaskQueue::onQueueThread() const {
+    return currentQueue == this;
+  }
+
+
+  void TaskQueue::post(function<void()> task) {
+    {
+      lock_guard<mutex> lock(m_mutex);
+      m_tasks.push_back(std::move(task));
+    }
+    m_ready.notify_one();
+  }
+
+
+  void TaskQueue::work() {
+    currentQueue = this;
+    while (true) {
+      function<void()> task;
+      {
+        unique_lock<mutex> lock(m_mutex);
+        m_ready.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+      // packaged_task stores exceptions in the future, nothing escapes here
+      task();
+    }
+  }
+
+
+  TaskQueue &workerPool() {
+    // never destroyed, its threads are blocked waiting for tasks at exit
+    static TaskQueue *queue = new TaskQueue(max(thread::hardware_concurrency(), 2u), "SpiceQL worker pool");
+    return *queue;
+  }
+}
@@ -53,6 +53,13 @@ namespace SpiceQL {
 
 
 
+        json getCoverage(string spiceql_name, string type, vector<string> qualities, double start_time, double stop_time, int naif_code) { 
+            InventoryImpl impl;
+            vector<Kernel::Quality> enum_qualities = Kernel::translateQualities(qualities);
+            return impl.getCoverage(spiceql_name, Kernel::translateType(type), enum_qualities, start_time, stop_time, naif_code);
+        }
+
+
         json search_for_kernelset_from_regex(vector<string> list, bool full_kernel_path) { 
             // strings should be formatted similar to the hdf keys e.g. 
             // mro/sclk/name 
@@ -151,7 +158,7 @@ namespace SpiceQL {
          * @return string 
          */
         string getDbFilePath() { 
-            static string db_path = (fs::path(getCacheDir()) / DB_HDF_FILE).string();
+            string db_path = (fs::path(getCacheDir()) / DB_HDF_FILE).string();
             SPDLOG_TRACE("db_path: {}", db_path);
             return db_path;
         }
@@ -178,13 +185,44 @@ namespace SpiceQL {
         }
 
         string getFrameNameFromCache(int code) {
-            InventoryImpl impl;
-            return impl.getFrameName(code);
+            return InventoryImpl::getFrameName(code);
         }
 
         int getFrameCodeFromCache(string name) {
-            InventoryImpl impl;
-            return impl.getFrameCode(name);
+            return InventoryImpl::getFrameCode(name);
+        }
+
+        unsigned long long getFrameCacheGeneration() {
+            return InventoryImpl::getFrameCacheGeneration();
+        }
+
+        vector<pair<int, string>> getFrameCodeNamesFromCache() {
+            return InventoryImpl::getFrameCodeNames();
+        }
+
+        vector<int> getFrameInfoFromCache(int code, string mission) {
+            return InventoryImpl::getFrameInfo(code, mission);
+        }
+
+        vector<vector<int>> getFrameInfoFromCache(vector<int> codes, string mission) {
+            vector<vector<int>> infos;
+            infos.reserve(codes.size());
+            for (int code : codes) {
+                infos.push_back(InventoryImpl::getFrameInfo(code, mission));
+            }
+            return infos;
+        }
+
+        pair<int, string> getTargetFrameFromCache(int body, string mission) {
+            return InventoryImpl::getBodyFrame(body, mission);
+        }
+
+        pair<int, vector<double>> getTkFrameFromCache(int code, string mission) {
+            return InventoryImpl::getTkFrame(code, mission);
+        }
+
+        json findMissionKeywordsFromCache(string keytpl, string mission) {
+            return InventoryImpl::findMissionKeywords(keytpl, mission);
         }
     }
 }
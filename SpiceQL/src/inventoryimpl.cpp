@@ -1,6 +1,12 @@
 #include <iostream>
 #include <regex>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
+#include <set>
+#include <tuple>
 #include <unordered_map>
 
 // we need to include this to overwrite and other std::fs imports
@@ -30,13 +36,18 @@ namespace stdpmr = std::pmr;
 #include <highfive/highfive.hpp>
 
 #include <SpiceUsr.h>
+#include <SpiceZfc.h>
 
 #include <SpiceQL/config.h>
+#include <SpiceQL/inventory.h>
 #include <SpiceQL/inventoryimpl.h>
 #include <SpiceQL/utils.h>
 #include <SpiceQL/query.h>
+#include <SpiceQL/textkernel.h>
 #include <SpiceQL/memo.h>
 #include <SpiceQL/spiceql_version.h>
+#include <SpiceQL/executor.h>
+#include <SpiceQL/snapshot.h>
 
 using json = nlohmann::json;
 using namespace std; 
@@ -58,15 +69,45 @@ namespace SpiceQL {
   string DB_TIME_FILES_KEY = "path_index";
   string DB_START_TIME_INDICES_KEY = "start_kindex";
   string DB_STOP_TIME_INDICES_KEY = "stop_kindex";
+  string DB_COVERAGE_START_KEY = "coverage_start";
+  string DB_COVERAGE_STOP_KEY = "coverage_stop";
+  string DB_COVERAGE_OFFSETS_KEY = "coverage_offsets";
+  string DB_BODY_CODES_KEY = "body_codes";
+  string DB_BODY_COVERAGE_START_KEY = "body_coverage_start";
+  string DB_BODY_COVERAGE_STOP_KEY = "body_coverage_stop";
+  string DB_BODY_COVERAGE_OFFSETS_KEY = "body_coverage_offsets";
   string DB_FRAME_CACHE_KEY = "spql_cache";
   string DB_FRAME_LIST_KEY = "spql_cache/frame_list";
   string DB_FRAME_CODES_KEY = "spql_cache/frame_codes";
   string DB_FRAME_NAMES_KEY = "spql_cache/frame_names";
+  string DB_FRAME_INFO_MISSIONS_KEY = "spql_cache/frame_info_missions";
+  string DB_FRAME_INFO_CODES_KEY = "spql_cache/frame_info_codes";
+  string DB_FRAME_INFO_CENTERS_KEY = "spql_cache/frame_info_centers";
+  string DB_FRAME_INFO_CLASSES_KEY = "spql_cache/frame_info_classes";
+  string DB_FRAME_INFO_CLASS_IDS_KEY = "spql_cache/frame_info_class_ids";
+  string DB_BODY_FRAME_MISSIONS_KEY = "spql_cache/body_frame_missions";
+  string DB_BODY_FRAME_BODIES_KEY = "spql_cache/body_frame_bodies";
+  string DB_BODY_FRAME_CODES_KEY = "spql_cache/body_frame_codes";
+  string DB_BODY_FRAME_NAMES_KEY = "spql_cache/body_frame_names";
+  string DB_TK_FRAME_MISSIONS_KEY = "spql_cache/tk_frame_missions";
+  string DB_TK_FRAME_CODES_KEY = "spql_cache/tk_frame_codes";
+  string DB_TK_FRAME_PARENTS_KEY = "spql_cache/tk_frame_parents";
+  string DB_TK_FRAME_ROTATIONS_KEY = "spql_cache/tk_frame_rotations";
+  string DB_MISSION_KEYWORDS_KEY = "spql_cache/keywords";
+  string DB_KEYWORD_NAMES_KEY = "names";
+  string DB_KEYWORD_KINDS_KEY = "kinds";
+  string DB_KEYWORD_STARTS_KEY = "starts";
+  string DB_KEYWORD_COUNTS_KEY = "counts";
+  string DB_KEYWORD_NUMBERS_KEY = "numbers";
+  string DB_KEYWORD_STRINGS_KEY = "strings";
   string CACHE_DIR_ENV_VAR = "SPICEQL_CACHE_DIR";
   static std::string  CACHE_DIRECTORY = "";
+  // recursive, getCacheDir initializes the directory through setCacheDir
+  static std::recursive_mutex CACHE_DIRECTORY_MUTEX;
 
 
   void setCacheDir(string cache_dir, bool override) {
+    lock_guard<recursive_mutex> lock(CACHE_DIRECTORY_MUTEX);
     const char* cache_dir_char = getenv(CACHE_DIR_ENV_VAR.c_str());
 
     // Priority order: override > env var > provided cache_dir > auto-generate
@@ -98,6 +139,7 @@ namespace SpiceQL {
 
 
   string getCacheDir() {
+      lock_guard<recursive_mutex> lock(CACHE_DIRECTORY_MUTEX);
       if (CACHE_DIRECTORY == "") {
           // Auto-initialize cache directory using setCacheDir logic
           setCacheDir("");
@@ -111,11 +153,162 @@ namespace SpiceQL {
 
 
   string getHdfFile() { 
-      static std::string db_path = (fs::path(getCacheDir()) / DB_HDF_FILE).string();
-      return db_path;
+      return (fs::path(getCacheDir()) / DB_HDF_FILE).string();
   }
   
 
+  void TimeIndexedKernels::addCoverage(const vector<pair<double, double>> &intervals) {
+    if (coverage_offsets.empty()) {
+      coverage_offsets.push_back(0);
+    }
+    for (auto &interval : intervals) {
+      coverage_starts.push_back(interval.first);
+      coverage_stops.push_back(interval.second);
+    }
+    coverage_offsets.push_back(coverage_starts.size());
+  }
+
+
+  bool TimeIndexedKernels::hasCoverage() const {
+    return !file_paths.empty() && coverage_offsets.size() == file_paths.size() + 1;
+  }
+
+
+  bool TimeIndexedKernels::covers(size_t index, double start, double stop) const {
+    if (!hasCoverage() || index >= file_paths.size()) {
+      return true;
+    }
+
+    auto first = coverage_stops.begin() + coverage_offsets[index];
+    auto last = coverage_stops.begin() + coverage_offsets[index+1];
+    if (first == last) {
+      return true;
+    }
+
+    // windows are merged, so stops are sorted; find the first window that
+    // ends at or after start and check that it begins before stop
+    auto it = lower_bound(first, last, start);
+    if (it == last) {
+      return false;
+    }
+    return coverage_starts[distance(coverage_stops.begin(), it)] <= stop;
+  }
+
+
+  vector<pair<double, double>> TimeIndexedKernels::getCoverage(size_t index) const {
+    vector<pair<double, double>> windows;
+    if (!hasCoverage() || index >= file_paths.size()) {
+      return windows;
+    }
+    for (size_t i = coverage_offsets[index]; i < coverage_offsets[index+1]; i++) {
+      windows.push_back({coverage_starts[i], coverage_stops[i]});
+    }
+    return windows;
+  }
+
+
+  // Start/stop bounds of each file index, recovered from the time maps.
+  static unordered_map<size_t, pair<double, double>> fileBounds(const TimeIndexedKernels &kernels) {
+    unordered_map<size_t, pair<double, double>> bounds;
+    for (const auto &[k, v] : kernels.start_times) {
+      bounds[v].first = k;
+    }
+    for (const auto &[k, v] : kernels.stop_times) {
+      bounds[v].second = k;
+    }
+    return bounds;
+  }
+
+
+  // Clip merged windows to [start_time, stop_time] and list the parts of that
+  // range they leave uncovered. Unbounded ends are clamped to the extent of the
+  // windows so an open ended query does not report gaps out to infinity.
+  static json coverageReport(const vector<pair<double, double>> &windows, double start_time, double stop_time) {
+    bool bounded = start_time != -numeric_limits<double>::max() && stop_time != numeric_limits<double>::max();
+    if (!windows.empty()) {
+      if (start_time == -numeric_limits<double>::max()) start_time = windows.front().first;
+      if (stop_time == numeric_limits<double>::max()) stop_time = windows.back().second;
+    }
+
+    vector<pair<double, double>> clipped;
+    vector<pair<double, double>> gaps;
+    double cursor = start_time;
+    for (auto &w : windows) {
+      if (w.second < start_time) continue;
+      if (w.first > stop_time) break;
+      pair<double, double> c = {max(w.first, start_time), min(w.second, stop_time)};
+      if (c.first > cursor) {
+        gaps.push_back({cursor, c.first});
+      }
+      clipped.push_back(c);
+      cursor = max(cursor, c.second);
+    }
+
+    if (clipped.empty()) {
+      if (bounded) {
+        gaps.push_back({start_time, stop_time});
+      }
+    }
+    else if (cursor < stop_time) {
+      gaps.push_back({cursor, stop_time});
+    }
+
+    return {{"windows", clipped}, {"gaps", gaps}};
+  }
+
+
+  // Walk the candidates from highest to lowest load priority and keep a file
+  // only if it covers some part of [start_time, stop_time] that no higher
+  // priority file already covers. Whatever is still uncovered afterwards is
+  // returned in gaps. Files without known windows use their start/stop bounds.
+  static vector<int> selectMinimalCover(const TimeIndexedKernels &kernels, const vector<int> &indices,
+                                        double start_time, double stop_time, vector<pair<double, double>> &gaps) {
+    unordered_map<size_t, pair<double, double>> bounds = fileBounds(kernels);
+
+    vector<pair<double, double>> remaining = {{start_time, stop_time}};
+    vector<int> selected;
+
+    for (auto index = indices.rbegin(); index != indices.rend() && !remaining.empty(); ++index) {
+      vector<pair<double, double>> windows = kernels.getCoverage(*index);
+      if (windows.empty() && bounds.contains(*index)) {
+        windows.push_back(bounds[*index]);
+      }
+
+      vector<pair<double, double>> uncovered;
+      bool contributes = false;
+      for (auto &r : remaining) {
+        double cursor = r.first;
+        bool closed = false;
+        for (auto &w : windows) {
+          if (w.second < cursor) continue;
+          if (w.first > r.second) break;
+          contributes = true;
+          if (w.first > cursor) {
+            uncovered.push_back({cursor, w.first});
+          }
+          if (w.second >= r.second) {
+            closed = true;
+            break;
+          }
+          cursor = w.second;
+        }
+        if (!closed) {
+          uncovered.push_back({cursor, r.second});
+        }
+      }
+
+      if (contributes) {
+        selected.push_back(*index);
+        remaining = uncovered;
+      }
+    }
+
+    gaps = remaining;
+    sort(selected.begin(), selected.end());
+    return selected;
+  }
+
+
   // objs need to be passed in c-style because of a lack of copy contructor in BtreeMap
   void collectStartStopTimes(string mission, string type, string quality, TimeIndexedKernels *kernel_times) { 
     SPDLOG_TRACE("In globTimeIntervals.");
@@ -128,8 +321,20 @@ namespace SpiceQL {
     for(auto &arr : ckKernelGrp) {
       for(auto &subArr : arr) {
         for (auto &kernel : subArr) {
-          pair<double, double> sstimes = getKernelStartStopTimes(kernel);
-          SPDLOG_TRACE("{} times: {}, {}", std::string(kernel), sstimes.first, sstimes.second); 
+          // keep the real coverage windows so selection can skip files whose
+          // bounds span the request but have a gap over it
+          vector<pair<double, double>> intervals;
+          for (auto &[body, times] : getBodyTimeIntervals(kernel)) {
+            vector<pair<double, double>> &bodyWindows = kernel_times->body_coverage[body];
+            bodyWindows.insert(bodyWindows.end(), times.begin(), times.end());
+            intervals.insert(intervals.end(), times.begin(), times.end());
+          }
+          intervals = mergeTimeIntervals(intervals);
+          pair<double, double> sstimes = {0, 0};
+          if (!intervals.empty()) {
+            sstimes = {intervals.front().first, intervals.back().second};
+          }
+          SPDLOG_TRACE("{} times: {}, {} over {} windows", std::string(kernel), sstimes.first, sstimes.second, intervals.size()); 
           // use start_time as index to the majority of kernels, then use stop time in the value 
           // to get the final list
           size_t index = 0;
@@ -158,9 +363,14 @@ namespace SpiceQL {
           fs::path relative_path_kernel = fs::relative(kernel, fs::absolute(getDataDirectory()));
           SPDLOG_TRACE("Relative Kernel: {}", relative_path_kernel.generic_string()); 
           kernel_times->file_paths.push_back(relative_path_kernel.string());
+          kernel_times->addCoverage(intervals);
         }
       }
     }
+
+    for (auto &[body, windows] : kernel_times->body_coverage) {
+      windows = mergeTimeIntervals(windows);
+    }
   }
 
 
@@ -175,7 +385,46 @@ namespace SpiceQL {
   }
 
 
+  // Reduces what each mission's kernels give a code to the rows the mission ->
+  // "base" -> "" lookup needs: one "" row where every mission agrees, else a
+  // row per mission that differs from base. A code the missions disagree on
+  // has no "" row, so a mission whose kernels do not define it misses the
+  // cache and furnishes instead of getting another mission's value.
+  template <typename T>
+  static vector<tuple<string, int, T>> missionRows(const map<pair<string, int>, T> &values) {
+    map<int, map<string, const T *>> by_code;
+    for (auto &[key, value] : values) {
+      by_code[key.second][key.first] = &value;
+    }
+
+    vector<tuple<string, int, T>> rows;
+    for (auto &[code, missions] : by_code) {
+      const T *common = missions.begin()->second;
+      for (auto &[mission, value] : missions) {
+        if (!(*value == *common)) {
+          common = nullptr;
+          break;
+        }
+      }
+      if (common) {
+        rows.emplace_back("", code, *common);
+        continue;
+      }
+
+      auto base = missions.find("base");
+      for (auto &[mission, value] : missions) {
+        if (mission != "base" && base != missions.end() && *value == *base->second) {
+          continue;
+        }
+        rows.emplace_back(mission, code, *value);
+      }
+    }
+    return rows;
+  }
+
+
   void InventoryImpl::collectFrameInfo() {
+    CspiceGuard cspice;
     Config config;
 
     // Frame list = the top-level config keys (deps only merge into existing
@@ -187,6 +436,11 @@ namespace SpiceQL {
     sort(m_frame_list.begin(), m_frame_list.end());
 
     unordered_set<int> seen_codes;
+    // frinfo_c, tkfram_ and cidfrm_c with each mission's kernels furnished
+    map<pair<string, int>, array<int, 3>> mission_frame_info;
+    map<pair<string, int>, pair<int, array<double, 9>>> mission_tk_frames;
+    map<pair<string, int>, pair<int, string>> mission_body_frames;
+    set<int> bodies;
 
     // Furnish every mission's frame-defining text kernels, then read the NAIF
     // body code<->name associations and enumerate kernel-defined frames. This
@@ -209,6 +463,7 @@ namespace SpiceQL {
 
       KernelSet ks(textKernels);
       checkNaifErrors();
+      set<int> missionBodies;
 
       // NAIF_BODY_CODE / NAIF_BODY_NAME define bodies, spacecraft, and
       // instruments (e.g. -85 -> "LRO", -85600 -> "LRO_LROCNACL"). These do not
@@ -231,6 +486,9 @@ namespace SpiceQL {
               string name(&bodyNames[static_cast<size_t>(i) * LENOUT]);
               insertFramePair((int)bodyCodes[i], name, m_frame_codes, m_frame_names, seen_codes);
             }
+            for (SpiceInt i = 0; i < n; i++) {
+              missionBodies.insert((int)bodyCodes[i]);
+            }
           }
         }
       }
@@ -244,21 +502,177 @@ namespace SpiceQL {
       SpiceInt nframes = card_c(&idset);
       for (SpiceInt i = 0; i < nframes; i++) {
         SpiceInt fcode = SPICE_CELL_ELEM_I(&idset, i);
+
+        SpiceInt center, frclss, clssid;
+        SpiceBoolean hasInfo = SPICEFALSE;
+        frinfo_c(fcode, &center, &frclss, &clssid, &hasInfo);
+        if (hasInfo) {
+          missionBodies.insert((int)center);
+          mission_frame_info[{mission, (int)fcode}] = {(int)center, (int)frclss, (int)clssid};
+
+          // 4 = TK, its edge to the parent frame is constant
+          if (frclss == 4) {
+            SpiceInt tkid = clssid;
+            SpiceInt parent = 0;
+            SpiceDouble rotation[9];
+            logical tkfound = 0;
+            tkfram_(&tkid, rotation, &parent, &tkfound);
+            if (failed_c()) {
+              // its definition is incomplete in the mission's fk/ik, leave it to runtime
+              SPDLOG_TRACE("collectFrameInfo: no TK rotation for frame {} in {}", (int)fcode, mission);
+              reset_c();
+            }
+            else if (tkfound) {
+              auto &edge = mission_tk_frames[{mission, (int)fcode}];
+              edge.first = (int)parent;
+              std::copy(rotation, rotation + 9, edge.second.begin());
+            }
+          }
+        }
+
         SpiceChar fname[128];
         frmnam_c(fcode, 128, fname);
         if (strlen(fname) > 0) {
-          insertFramePair((int)fcode, string(fname), m_frame_codes, m_frame_names, seen_codes);
+          // NAIF resolves a code as a body before a frame (1 is MERCURY
+          // BARYCENTER, not J2000), so the body name comes first for the code
+          // while the frame name still maps to it
+          SpiceChar bname[128];
+          SpiceBoolean isBody = SPICEFALSE;
+          bodc2n_c(fcode, 128, bname, &isBody);
+          if (isBody && !seen_codes.count((int)fcode) && string(bname) != fname) {
+            insertFramePair((int)fcode, string(bname), m_frame_codes, m_frame_names, seen_codes);
+            m_frame_codes.push_back((int)fcode);
+            m_frame_names.push_back(string(fname));
+          }
+          else {
+            insertFramePair((int)fcode, string(fname), m_frame_codes, m_frame_names, seen_codes);
+          }
+        }
+      }
+      checkNaifErrors();
+
+      for (int body : missionBodies) {
+        SpiceInt frcode = 0;
+        SpiceChar frname[128];
+        SpiceBoolean found = SPICEFALSE;
+        cidfrm_c(body, 128, &frcode, frname, &found);
+        if (found) {
+          mission_body_frames[{mission, body}] = {(int)frcode, string(frname)};
         }
       }
       checkNaifErrors();
+      bodies.insert(missionBodies.begin(), missionBodies.end());
+    }
+
+    // With every mission's kernels unloaded again cidfrm_c gives NAIF's
+    // built-in association, keep it under "" and only keep the mission rows
+    // that differ from it.
+    map<int, pair<int, string>> builtin_body_frames;
+    for (int body : bodies) {
+      SpiceInt frcode = 0;
+      SpiceChar frname[128];
+      SpiceBoolean found = SPICEFALSE;
+      cidfrm_c(body, 128, &frcode, frname, &found);
+      if (found) {
+        builtin_body_frames[body] = {(int)frcode, string(frname)};
+        m_body_frame_missions.push_back("");
+        m_body_frame_bodies.push_back(body);
+        m_body_frame_codes.push_back((int)frcode);
+        m_body_frame_names.push_back(string(frname));
+      }
+    }
+    checkNaifErrors();
+
+    for (auto &[key, frame] : mission_body_frames) {
+      auto builtin = builtin_body_frames.find(key.second);
+      if (builtin != builtin_body_frames.end() && builtin->second == frame) {
+        continue;
+      }
+      m_body_frame_missions.push_back(key.first);
+      m_body_frame_bodies.push_back(key.second);
+      m_body_frame_codes.push_back(frame.first);
+      m_body_frame_names.push_back(frame.second);
+    }
+
+    for (auto &[mission, code, info] : missionRows(mission_frame_info)) {
+      m_frame_info_missions.push_back(mission);
+      m_frame_info_codes.push_back(code);
+      m_frame_info_centers.push_back(info[0]);
+      m_frame_info_classes.push_back(info[1]);
+      m_frame_info_class_ids.push_back(info[2]);
+    }
+
+    for (auto &[mission, code, edge] : missionRows(mission_tk_frames)) {
+      m_tk_frame_missions.push_back(mission);
+      m_tk_frame_codes.push_back(code);
+      m_tk_frame_parents.push_back(edge.first);
+      m_tk_frame_rotations.insert(m_tk_frame_rotations.end(), edge.second.begin(), edge.second.end());
+    }
+
+    SPDLOG_DEBUG("collectFrameInfo: {} frames in list, {} code<->name pairs, {} frame infos, {} body frames, {} TK frames",
+                 m_frame_list.size(), m_frame_codes.size(), m_frame_info_codes.size(), m_body_frame_bodies.size(), m_tk_frame_codes.size());
+  }
+
+
+  void InventoryImpl::collectMissionKeywords() {
+    json globalConf = Config().globalConf();
+    fs::path data_dir = getDataDirectory();
+    size_t total = 0;
+
+    // The same kernels findMissionKeywords searches for, replayed natively in
+    // the order they would be furnished (getKernelsAsVector puts IAKs last).
+    for (auto &el : globalConf.items()) {
+      string mission = el.key();
+      json kernels = json::object();
+      for (string type : {"fk", "ik", "iak"}) {
+        auto it = m_nontimedep_kerns.find(mission + "/" + type);
+        if (it != m_nontimedep_kerns.end() && !it->second.empty()) {
+          for (const string &kernel : it->second) {
+            kernels[type].push_back((data_dir / kernel).string());
+          }
+        }
+      }
+      if (kernels.empty()) {
+        continue;
+      }
+
+      json pool;
+      try {
+        pool = replayTextKernels(getKernelsAsVector(kernels));
+      }
+      catch (exception &e) {
+        SPDLOG_DEBUG("collectMissionKeywords: keywords of {} not cached: {}", mission, e.what());
+        continue;
+      }
+
+      MissionKeywordTable table;
+      for (auto &[name, values] : pool.items()) {
+        bool numeric = all_of(values.begin(), values.end(), [](const json &v) { return v.is_number(); });
+        table.names.push_back(name);
+        table.kinds.push_back(numeric ? 0 : 1);
+        table.starts.push_back(numeric ? table.numbers.size() : table.strings.size());
+        table.counts.push_back(values.size());
+        for (const json &value : values) {
+          if (numeric) {
+            table.numbers.push_back(value.get<double>());
+          }
+          else {
+            table.strings.push_back(value.is_string() ? value.get<string>() : value.dump());
+          }
+        }
+      }
+
+      if (!table.names.empty()) {
+        total += table.names.size();
+        m_mission_keywords[mission] = move(table);
+      }
     }
 
-    SPDLOG_DEBUG("collectFrameInfo: {} frames in list, {} code<->name pairs",
-                 m_frame_list.size(), m_frame_codes.size());
+    SPDLOG_DEBUG("collectMissionKeywords: {} keywords of {} missions", total, m_mission_keywords.size());
   }
 
 
-  InventoryImpl::InventoryImpl(bool force_regen, vector<string> mlist) : m_required_kernels() {
+  InventoryImpl::InventoryImpl(bool force_regen, vector<string> mlist) {
     fs::path db_root = getCacheDir();
     fs::path db_file = db_root / DB_HDF_FILE; 
 
@@ -312,7 +726,10 @@ namespace SpiceQL {
 
       SPDLOG_TRACE("InventoryImpl LSKs: {}", lsk_json.dump(4));
 
-      m_required_kernels.load(lsk_json); 
+      // the LSK and SCLKs have to stay furnished, with nothing else loaded or
+      // unloaded in between, until the kernel times are read
+      CspiceGuard cspice;
+      KernelSet lsks(lsk_json);
 
       for (auto &[mission, kernels] : json_kernels.items()) {
         SPDLOG_TRACE("MISSION: {}", mission);
@@ -365,6 +782,9 @@ namespace SpiceQL {
       // so runtime resolution never needs to furnish slow FKs.
       collectFrameInfo();
 
+      // Snapshot each mission's IK/FK/IAK keyword pool for findMissionKeywords
+      collectMissionKeywords();
+
       // write everything out
       write_database();
     }
@@ -399,6 +819,117 @@ namespace SpiceQL {
   }
 
 
+  TimeIndexedKernels *InventoryImpl::loadTimeIndexedKernels(string key, bool with_bodies) {
+    TimeIndexedKernels *time_indices = new TimeIndexedKernels();
+    string root = DB_SPICE_ROOT_KEY+"/"+key+"/";
+
+    try {
+      SPDLOG_TRACE("Starting deserializing the DB");
+
+      vector<double> start_times_v = getKey<vector<double>>(root+DB_START_TIME_KEY); 
+      vector<double> stop_times_v = getKey<vector<double>>(root+DB_STOP_TIME_KEY);
+      vector<size_t> start_file_index_v = getKey<vector<size_t>>(root+DB_START_TIME_INDICES_KEY); 
+      vector<size_t> stop_file_index_v = getKey<vector<size_t>>(root+DB_STOP_TIME_INDICES_KEY); 
+      vector<string> file_paths_v = getKey<vector<string>>(root+DB_TIME_FILES_KEY); 
+
+      time_indices->file_paths = file_paths_v;
+      SPDLOG_TRACE("Index, start time, stop time sizes: {}, {}, {}", start_file_index_v.size(), start_times_v.size(), stop_times_v.size());
+      // load start_times 
+      for(size_t i = 0; i < start_times_v.size(); i++) {
+        time_indices->start_times[start_times_v[i]] = start_file_index_v[i];
+      }
+      // load stop_times 
+      for(size_t i = 0; i < stop_times_v.size(); i++) {
+        time_indices->stop_times[stop_times_v[i]] = stop_file_index_v[i];
+      }
+    }
+    catch (runtime_error &e) { 
+      // should probably replace with a more specific exception 
+      SPDLOG_TRACE("Couldn't find "+DB_SPICE_ROOT_KEY+"/" + key+ ". " + e.what());
+      delete time_indices;
+      return nullptr;
+    }
+
+    // coverage windows are optional, older DBs only have the bounds
+    try {
+      time_indices->coverage_starts = getKey<vector<double>>(root+DB_COVERAGE_START_KEY);
+      time_indices->coverage_stops = getKey<vector<double>>(root+DB_COVERAGE_STOP_KEY);
+      time_indices->coverage_offsets = getKey<vector<size_t>>(root+DB_COVERAGE_OFFSETS_KEY);
+    }
+    catch (runtime_error &e) {
+      SPDLOG_DEBUG("No coverage windows for {}, selecting on start/stop bounds only. {}", key, e.what());
+    }
+
+    if (with_bodies) {
+      try {
+        vector<int> codes = getKey<vector<int>>(root+DB_BODY_CODES_KEY);
+        vector<double> starts = getKey<vector<double>>(root+DB_BODY_COVERAGE_START_KEY);
+        vector<double> stops = getKey<vector<double>>(root+DB_BODY_COVERAGE_STOP_KEY);
+        vector<size_t> offsets = getKey<vector<size_t>>(root+DB_BODY_COVERAGE_OFFSETS_KEY);
+        for (size_t i = 0; i < codes.size() && i+1 < offsets.size(); i++) {
+          vector<pair<double, double>> &windows = time_indices->body_coverage[codes[i]];
+          for (size_t j = offsets[i]; j < offsets[i+1]; j++) {
+            windows.push_back({starts[j], stops[j]});
+          }
+        }
+      }
+      catch (runtime_error &e) {
+        SPDLOG_DEBUG("No per code coverage windows for {}. {}", key, e.what());
+      }
+    }
+
+    return time_indices;
+  }
+
+
+  json InventoryImpl::getCoverage(string spiceql_name, Kernel::Type type, vector<Kernel::Quality> qualities,
+                                  double start_time, double stop_time, int naif_code) {
+    if (start_time > stop_time) { 
+      throw range_error("start time cannot be greater than stop time.");
+    }
+    if (type != Kernel::Type::CK && type != Kernel::Type::SPK) {
+      throw invalid_argument("Coverage is only indexed for ck and spk kernels, not [" + Kernel::translateType(type) + "].");
+    }
+    spiceql_name = toLower(spiceql_name);
+
+    json coverage = json::object();
+    for (auto &quality : qualities) {
+      string qstr = Kernel::translateQuality(quality);
+      string key = spiceql_name+"/"+Kernel::translateType(type)+"/"+qstr;
+
+      unique_ptr<TimeIndexedKernels> time_indices(loadTimeIndexedKernels(key, naif_code != 0));
+      if (!time_indices) {
+        continue;
+      }
+
+      vector<pair<double, double>> windows;
+      if (naif_code != 0) {
+        if (time_indices->body_coverage.empty() && !time_indices->coverage_starts.empty()) {
+          throw runtime_error("DB has no per code coverage for [" + key + "], regenerate it with create_database.");
+        }
+        auto it = time_indices->body_coverage.find(naif_code);
+        if (it != time_indices->body_coverage.end()) {
+          windows = it->second;
+        }
+      }
+      else if (time_indices->hasCoverage()) {
+        for (size_t i = 0; i < time_indices->coverage_starts.size(); i++) {
+          windows.push_back({time_indices->coverage_starts[i], time_indices->coverage_stops[i]});
+        }
+      }
+      else {
+        SPDLOG_DEBUG("No coverage windows for {}, reporting start/stop bounds.", key);
+        for (auto &[index, bounds] : fileBounds(*time_indices)) {
+          windows.push_back(bounds);
+        }
+      }
+
+      coverage[qstr] = coverageReport(mergeTimeIntervals(windows), start_time, stop_time);
+    }
+    return coverage;
+  }
+
+
   json InventoryImpl::search_for_kernelsets(vector<string> spiceql_names, vector<Kernel::Type> types, double start_time, double stop_time,
                                   vector<Kernel::Quality> ckQualities, vector<Kernel::Quality> spkQualities, bool full_kernel_path, 
                                   int limit_ck, int limit_spk, bool overwrite) { 
@@ -447,6 +978,10 @@ namespace SpiceQL {
         // sort in descending order
         std::sort(qualities.begin(), qualities.end(), std::greater<>());
 
+        // kept as an object so it is not mistaken for a kernel list
+        string ckey = spiceql_name + "_" + Kernel::translateType(type) + "_coverage";
+        bool selected = false;
+
         // iterate down the qualities
         for(auto quality = qualities.begin(); quality != qualities.end() && !found; ++quality) {
           string key = spiceql_name+"/"+Kernel::translateType(type)+"/"+Kernel::translateQuality(*quality)+"/";
@@ -461,31 +996,8 @@ namespace SpiceQL {
           }
           else {
             // try to load the binary files 
-            time_indices = new TimeIndexedKernels();
-            
-            try {
-              SPDLOG_TRACE("Starting deserializing the DB");
-
-              vector<double> start_times_v = getKey<vector<double>>(DB_SPICE_ROOT_KEY+"/"+key+"/"+DB_START_TIME_KEY); 
-              vector<double> stop_times_v = getKey<vector<double>>(DB_SPICE_ROOT_KEY+"/"+key+"/"+DB_STOP_TIME_KEY);
-              vector<size_t> start_file_index_v = getKey<vector<size_t>>(DB_SPICE_ROOT_KEY+"/"+key+"/"+DB_START_TIME_INDICES_KEY); 
-              vector<size_t> stop_file_index_v = getKey<vector<size_t>>(DB_SPICE_ROOT_KEY+"/"+key+"/"+DB_STOP_TIME_INDICES_KEY); 
-              vector<string> file_paths_v = getKey<vector<string>>(DB_SPICE_ROOT_KEY+"/"+key+"/"+DB_TIME_FILES_KEY); 
-
-              time_indices->file_paths = file_paths_v;
-              SPDLOG_TRACE("Index, start time, stop time sizes: {}, {}, {}", start_file_index_v.size(), start_times_v.size(), stop_times_v.size());
-              // load start_times 
-              for(size_t i = 0; i < start_times_v.size(); i++) {
-                time_indices->start_times[start_times_v[i]] = start_file_index_v[i];
-              }
-              // load stop_times 
-              for(size_t i = 0; i < stop_times_v.size(); i++) {
-                time_indices->stop_times[stop_times_v[i]] = stop_file_index_v[i];
-              }
-            }
-            catch (runtime_error &e) { 
-              // should probably replace with a more specific exception 
-              SPDLOG_TRACE("Couldn't find "+DB_SPICE_ROOT_KEY+"/" + key+ ". " + e.what());
+            time_indices = loadTimeIndexedKernels(key);
+            if (!time_indices) {
               continue;
             }
           }
@@ -537,14 +1049,35 @@ namespace SpiceQL {
             }
           }
           
+          // Drop files whose bounds span the window but whose coverage has a
+          // gap over it, so the limits below only rank files that have data
+          if (time_indices->hasCoverage()) {
+            erase_if(final_time_kernel_indices, [&](int index) {
+              bool covered = time_indices->covers(index, start_time, stop_time);
+              if (!covered) {
+                SPDLOG_TRACE("{} has no coverage in [{}, {}]", time_indices->file_paths.at(index), start_time, stop_time);
+              }
+              return !covered;
+            });
+          }
+
           // Sort the indices as the kernel dbs enforce load priority
           sort(final_time_kernel_indices.begin(), final_time_kernel_indices.end());
+
+          vector<pair<double, double>> gaps;
+          bool minimalCover = limitQuality == Inventory::LIMIT_MINIMAL_COVER && !final_time_kernel_indices.empty();
+          if (minimalCover) {
+            size_t candidates = final_time_kernel_indices.size();
+            final_time_kernel_indices = selectMinimalCover(*time_indices, final_time_kernel_indices, start_time, stop_time, gaps);
+            SPDLOG_DEBUG("Minimal cover kept {} of {} kernels for {}, {} gaps", final_time_kernel_indices.size(), candidates, key, gaps.size());
+          }
           for (auto index : final_time_kernel_indices) {
             final_time_kernels.push_back(time_indices->file_paths.at(index));
           }
 
           if (final_time_kernels.size()) { 
             found = true;
+            selected = true;
             if (limitQuality > -1 && limitQuality < final_time_kernels.size()) { 
               vector<string> limitedKernels;
               int start_idx = final_time_kernels.size() - 1;
@@ -571,10 +1104,20 @@ namespace SpiceQL {
               kernels[Kernel::translateType(type)] = allKernels;
               kernels[qkey] = Kernel::translateQuality(*quality);
             }
+
+            if (minimalCover) {
+              kernels[ckey] = {{"gaps", gaps}};
+            }
           }
           SPDLOG_TRACE("NUMBER OF ITERATIONS: {}", iterations);
           SPDLOG_TRACE("NUMBER OF KERNELS FOUND: {}", final_time_kernels.size());  
         }
+
+        if (limitQuality == Inventory::LIMIT_MINIMAL_COVER && !selected) {
+          // no kernel of any quality overlaps the window, all of it is a gap
+          vector<pair<double, double>> gaps = {{start_time, stop_time}};
+          kernels[ckey] = {{"gaps", gaps}};
+        }
       }
       else { // text/non time based kernels
         SPDLOG_DEBUG("Trying to search time independent kernels");
@@ -607,6 +1150,253 @@ namespace SpiceQL {
   }
   
 
+  namespace {
+    // Immutable snapshot of the frame code<->name cache as flat tables sorted
+    // by code and by upper-cased name.
+    struct FrameCacheSnapshot {
+      std::string key;  // "<path>@<write-time>" of the DB it was loaded from
+      unsigned long long generation = 0;  // bumped every time a new snapshot is published
+      std::vector<std::pair<int, std::string>> by_code;
+      std::vector<std::pair<std::string, int>> by_name;
+      // ((mission, code), {center, class, class ID}), sorted by mission and code
+      std::vector<std::pair<std::pair<std::string, int>, std::array<int, 3>>> frame_info;
+      // ((mission, body), (frame code, frame name)), sorted by mission and body
+      std::vector<std::pair<std::pair<std::string, int>, std::pair<int, std::string>>> body_frames;
+      // ((mission, code), (parent, rotation)) of TK frames, sorted by mission and code
+      std::vector<std::pair<std::pair<std::string, int>, std::pair<int, std::array<double, 9>>>> tk_frames;
+    };
+
+    // The row of the mission in a table sorted by (mission, code), else the
+    // one of "base", else the one of "". nullptr if there is none.
+    template <typename T>
+    const T *findMissionRow(const std::vector<std::pair<std::pair<std::string, int>, T>> &rows,
+                            const std::string &mission, int code) {
+      for (const string &m : {mission, string("base"), string("")}) {
+        auto key = std::make_pair(m, code);
+        auto it = std::lower_bound(rows.begin(), rows.end(), key,
+                                   [](const auto &e, const std::pair<string, int> &k) { return e.first < k; });
+        if (it != rows.end() && it->first == key) return &it->second;
+      }
+      return nullptr;
+    }
+
+    // The mission column of a table, DBs from before it was added only hold
+    // "" rows
+    vector<string> missionColumn(InventoryImpl &impl, const string &key, size_t n) {
+      try {
+        return impl.getKey<vector<string>>(key);
+      }
+      catch (exception &) {
+        return vector<string>(n, "");
+      }
+    }
+
+    // How long a snapshot is trusted before the DB file is stat'ed again.
+    const std::chrono::milliseconds FRAME_CACHE_REVALIDATE_INTERVAL(1000);
+
+    // Readers only load g_frame_cache, inside a SnapshotReadGuard, and
+    // g_frame_cache_checked. Reloads are serialized by g_frame_cache_mutex, and
+    // a replaced snapshot is freed by a later reload once no reader can still
+    // hold it.
+    Snapshot<FrameCacheSnapshot> g_frame_cache;
+    std::atomic<long long> g_frame_cache_checked{0};  // steady clock ticks of the last revalidation
+    std::atomic<bool> g_frame_cache_stale{false};     // set when this process rewrites the DB
+    std::mutex g_frame_cache_mutex;
+
+    long long steadyNow() {
+      return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    const FrameCacheSnapshot *reloadFrameCache() {
+      // constructed outside of the lock, it generates the DB if there is none yet
+      InventoryImpl impl;
+      std::lock_guard<std::mutex> lock(g_frame_cache_mutex);
+
+      string hdf_file = (fs::path(getCacheDir()) / DB_HDF_FILE).string();
+      string key = hdf_file;
+      try {
+        if (fs::exists(hdf_file)) {
+          key += "@" + std::to_string(
+              static_cast<long long>(fs::last_write_time(hdf_file).time_since_epoch().count()));
+        }
+      } catch (...) { /* fall through with path-only key */ }
+
+      const FrameCacheSnapshot *current = g_frame_cache.load();
+      if (current && current->key == key && !g_frame_cache_stale.exchange(false)) {
+        g_frame_cache_checked.store(steadyNow(), std::memory_order_relaxed);
+        return current;  // already loaded for this exact DB state
+      }
+
+      auto snapshot = std::make_unique<FrameCacheSnapshot>();
+      snapshot->key = key;
+      snapshot->generation = current ? current->generation + 1 : 1;
+      try {
+        vector<int> codes = impl.getKey<vector<int>>(DB_FRAME_CODES_KEY);
+        vector<string> names = impl.getKey<vector<string>>(DB_FRAME_NAMES_KEY);
+        size_t n = std::min(codes.size(), names.size());
+
+        // the first name of a code wins (a body before a frame of the same
+        // code), later pairs of a name win as they did when the cache was a
+        // pair of maps
+        std::unordered_map<int, std::string> code_to_name;
+        std::unordered_map<std::string, int> name_to_code;
+        code_to_name.reserve(n);
+        name_to_code.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+          code_to_name.emplace(codes[i], names[i]);
+          name_to_code[toUpper(names[i])] = codes[i];
+        }
+
+        snapshot->by_code.assign(code_to_name.begin(), code_to_name.end());
+        snapshot->by_name.assign(name_to_code.begin(), name_to_code.end());
+        std::sort(snapshot->by_code.begin(), snapshot->by_code.end());
+        std::sort(snapshot->by_name.begin(), snapshot->by_name.end());
+      }
+      catch (exception &e) {
+        SPDLOG_DEBUG("Frame code<->name cache unavailable: {}", e.what());
+      }
+
+      // DBs from before these tables were added just miss them
+      try {
+        vector<int> codes = impl.getKey<vector<int>>(DB_FRAME_INFO_CODES_KEY);
+        vector<int> centers = impl.getKey<vector<int>>(DB_FRAME_INFO_CENTERS_KEY);
+        vector<int> classes = impl.getKey<vector<int>>(DB_FRAME_INFO_CLASSES_KEY);
+        vector<int> class_ids = impl.getKey<vector<int>>(DB_FRAME_INFO_CLASS_IDS_KEY);
+        vector<string> missions = missionColumn(impl, DB_FRAME_INFO_MISSIONS_KEY, codes.size());
+        size_t n = std::min({missions.size(), codes.size(), centers.size(), classes.size(), class_ids.size()});
+        snapshot->frame_info.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+          snapshot->frame_info.push_back({{missions[i], codes[i]}, {centers[i], classes[i], class_ids[i]}});
+        }
+        std::sort(snapshot->frame_info.begin(), snapshot->frame_info.end());
+      }
+      catch (exception &e) {
+        SPDLOG_DEBUG("Frame info cache unavailable: {}", e.what());
+      }
+
+      try {
+        vector<string> missions = impl.getKey<vector<string>>(DB_BODY_FRAME_MISSIONS_KEY);
+        vector<int> bodies = impl.getKey<vector<int>>(DB_BODY_FRAME_BODIES_KEY);
+        vector<int> codes = impl.getKey<vector<int>>(DB_BODY_FRAME_CODES_KEY);
+        vector<string> names = impl.getKey<vector<string>>(DB_BODY_FRAME_NAMES_KEY);
+        size_t n = std::min({missions.size(), bodies.size(), codes.size(), names.size()});
+        snapshot->body_frames.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+          snapshot->body_frames.push_back({{missions[i], bodies[i]}, {codes[i], names[i]}});
+        }
+        std::sort(snapshot->body_frames.begin(), snapshot->body_frames.end());
+      }
+      catch (exception &e) {
+        SPDLOG_DEBUG("Body frame cache unavailable: {}", e.what());
+      }
+
+      try {
+        vector<int> codes = impl.getKey<vector<int>>(DB_TK_FRAME_CODES_KEY);
+        vector<int> parents = impl.getKey<vector<int>>(DB_TK_FRAME_PARENTS_KEY);
+        vector<double> rotations = impl.getKey<vector<double>>(DB_TK_FRAME_ROTATIONS_KEY);
+        vector<string> missions = missionColumn(impl, DB_TK_FRAME_MISSIONS_KEY, codes.size());
+        size_t n = std::min({missions.size(), codes.size(), parents.size(), rotations.size() / 9});
+        snapshot->tk_frames.resize(n);
+        for (size_t i = 0; i < n; i++) {
+          snapshot->tk_frames[i].first = {missions[i], codes[i]};
+          snapshot->tk_frames[i].second.first = parents[i];
+          std::copy_n(rotations.begin() + i * 9, 9, snapshot->tk_frames[i].second.second.begin());
+        }
+        std::sort(snapshot->tk_frames.begin(), snapshot->tk_frames.end(),
+                  [](const auto &a, const auto &b) { return a.first < b.first; });
+      }
+      catch (exception &e) {
+        SPDLOG_DEBUG("TK frame cache unavailable: {}", e.what());
+      }
+
+      const FrameCacheSnapshot *published = g_frame_cache.publish(std::move(snapshot));
+      g_frame_cache_checked.store(steadyNow(), std::memory_order_relaxed);
+      return published;
+    }
+
+    // The current snapshot, valid while the caller holds a SnapshotReadGuard;
+    // no lock or syscall unless it is due for revalidation.
+    const FrameCacheSnapshot *frameCache() {
+      const FrameCacheSnapshot *snapshot = g_frame_cache.load();
+      long long interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(FRAME_CACHE_REVALIDATE_INTERVAL).count();
+      if (snapshot && !g_frame_cache_stale.load(std::memory_order_relaxed)
+          && steadyNow() - g_frame_cache_checked.load(std::memory_order_relaxed) < interval) {
+        return snapshot;
+      }
+      return reloadFrameCache();
+    }
+
+
+    // One mission's keyword pool from the DB, sorted by name so a template's
+    // literal prefix narrows the scan to one range.
+    struct MissionKeywordIndex {
+      unsigned long long generation = 0;  // of the frame cache snapshot it was read with
+      std::vector<std::string> names;
+      std::vector<json> values;  // formatted like findKeywords, aligned with names
+    };
+
+    // Indices are immutable and handed out as shared_ptrs, the mutex only
+    // guards the map. A mission without a stored pool has a null index.
+    std::mutex g_keyword_mutex;
+    std::unordered_map<std::string, std::pair<unsigned long long, std::shared_ptr<const MissionKeywordIndex>>> g_keyword_indices;
+
+    std::shared_ptr<const MissionKeywordIndex> loadMissionKeywords(const string &mission, unsigned long long generation) {
+      InventoryImpl impl;
+      string root = DB_MISSION_KEYWORDS_KEY + "/" + mission + "/";
+      try {
+        vector<string> names = impl.getKey<vector<string>>(root + DB_KEYWORD_NAMES_KEY);
+        vector<int> kinds = impl.getKey<vector<int>>(root + DB_KEYWORD_KINDS_KEY);
+        vector<size_t> starts = impl.getKey<vector<size_t>>(root + DB_KEYWORD_STARTS_KEY);
+        vector<size_t> counts = impl.getKey<vector<size_t>>(root + DB_KEYWORD_COUNTS_KEY);
+        vector<double> numbers;
+        vector<string> strings;
+        // only written when the mission has values of that kind
+        try { numbers = impl.getKey<vector<double>>(root + DB_KEYWORD_NUMBERS_KEY); } catch (exception &) {}
+        try { strings = impl.getKey<vector<string>>(root + DB_KEYWORD_STRINGS_KEY); } catch (exception &) {}
+
+        auto index = std::make_shared<MissionKeywordIndex>();
+        index->generation = generation;
+        for (size_t i = 0; i < names.size() && i < kinds.size() && i < starts.size() && i < counts.size(); i++) {
+          json values = json::array();
+          for (size_t j = starts[i]; j < starts[i] + counts[i]; j++) {
+            if (kinds[i] == 0) {
+              values.push_back(numbers.at(j));
+            }
+            else {
+              values.push_back(strings.at(j));
+            }
+          }
+          index->names.push_back(names[i]);
+          index->values.push_back(formatKeywordValues(values));
+        }
+        SPDLOG_DEBUG("Loaded {} cached keywords of {}", index->names.size(), mission);
+        return index;
+      }
+      catch (exception &e) {
+        SPDLOG_DEBUG("Keyword cache of {} unavailable: {}", mission, e.what());
+        return nullptr;
+      }
+    }
+
+    std::shared_ptr<const MissionKeywordIndex> missionKeywords(const string &mission) {
+      unsigned long long generation = InventoryImpl::getFrameCacheGeneration();
+      {
+        std::lock_guard<std::mutex> lock(g_keyword_mutex);
+        auto it = g_keyword_indices.find(mission);
+        if (it != g_keyword_indices.end() && it->second.first == generation) {
+          return it->second.second;
+        }
+      }
+
+      // read outside of the lock, concurrent misses may both read the DB
+      std::shared_ptr<const MissionKeywordIndex> index = loadMissionKeywords(mission, generation);
+      std::lock_guard<std::mutex> lock(g_keyword_mutex);
+      g_keyword_indices[mission] = {generation, index};
+      return index;
+    }
+  }
+
+
   void InventoryImpl::write_database() { 
     fs::path db_root = getCacheDir(); 
     string hdf_file = (db_root / DB_HDF_FILE).string();
@@ -628,6 +1418,39 @@ namespace SpiceQL {
       H5Easy::dump(file, "/" + DB_FRAME_CODES_KEY, m_frame_codes, H5Easy::DumpMode::Overwrite);
       H5Easy::dump(file, "/" + DB_FRAME_NAMES_KEY, m_frame_names, H5Easy::DumpMode::Overwrite);
     }
+    if (!m_frame_info_codes.empty()) {
+      H5Easy::dump(file, "/" + DB_FRAME_INFO_MISSIONS_KEY, m_frame_info_missions, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_FRAME_INFO_CODES_KEY, m_frame_info_codes, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_FRAME_INFO_CENTERS_KEY, m_frame_info_centers, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_FRAME_INFO_CLASSES_KEY, m_frame_info_classes, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_FRAME_INFO_CLASS_IDS_KEY, m_frame_info_class_ids, H5Easy::DumpMode::Overwrite);
+    }
+    if (!m_body_frame_bodies.empty()) {
+      H5Easy::dump(file, "/" + DB_BODY_FRAME_MISSIONS_KEY, m_body_frame_missions, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_BODY_FRAME_BODIES_KEY, m_body_frame_bodies, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_BODY_FRAME_CODES_KEY, m_body_frame_codes, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_BODY_FRAME_NAMES_KEY, m_body_frame_names, H5Easy::DumpMode::Overwrite);
+    }
+    if (!m_tk_frame_codes.empty()) {
+      H5Easy::dump(file, "/" + DB_TK_FRAME_MISSIONS_KEY, m_tk_frame_missions, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_TK_FRAME_CODES_KEY, m_tk_frame_codes, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_TK_FRAME_PARENTS_KEY, m_tk_frame_parents, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, "/" + DB_TK_FRAME_ROTATIONS_KEY, m_tk_frame_rotations, H5Easy::DumpMode::Overwrite);
+    }
+
+    for (auto &[mission, table] : m_mission_keywords) {
+      string root = "/" + DB_MISSION_KEYWORDS_KEY + "/" + mission + "/";
+      H5Easy::dump(file, root + DB_KEYWORD_NAMES_KEY, table.names, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, root + DB_KEYWORD_KINDS_KEY, table.kinds, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, root + DB_KEYWORD_STARTS_KEY, table.starts, H5Easy::DumpMode::Overwrite);
+      H5Easy::dump(file, root + DB_KEYWORD_COUNTS_KEY, table.counts, H5Easy::DumpMode::Overwrite);
+      if (!table.numbers.empty()) {
+        H5Easy::dump(file, root + DB_KEYWORD_NUMBERS_KEY, table.numbers, H5Easy::DumpMode::Overwrite);
+      }
+      if (!table.strings.empty()) {
+        H5Easy::dump(file, root + DB_KEYWORD_STRINGS_KEY, table.strings, H5Easy::DumpMode::Overwrite);
+      }
+    }
 
     for (auto it=m_timedep_kerns.begin(); it!=m_timedep_kerns.end(); ++it) {
       string kernel_key = it->first; 
@@ -662,6 +1485,34 @@ namespace SpiceQL {
         H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_STOP_TIME_KEY, stop_times_v, H5Easy::DumpMode::Overwrite);
         H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_START_TIME_INDICES_KEY, start_indices_v, H5Easy::DumpMode::Overwrite);
         H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_STOP_TIME_INDICES_KEY, stop_indices_v, H5Easy::DumpMode::Overwrite);
+
+        if (kernels->hasCoverage() && !kernels->coverage_starts.empty()) {
+          H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_COVERAGE_START_KEY, kernels->coverage_starts, H5Easy::DumpMode::Overwrite);
+          H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_COVERAGE_STOP_KEY, kernels->coverage_stops, H5Easy::DumpMode::Overwrite);
+          H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_COVERAGE_OFFSETS_KEY, kernels->coverage_offsets, H5Easy::DumpMode::Overwrite);
+        }
+
+        if (!kernels->body_coverage.empty()) {
+          vector<int> body_codes_v;
+          vector<double> body_starts_v;
+          vector<double> body_stops_v;
+          vector<size_t> body_offsets_v = {0};
+          for (const auto &[body, windows] : kernels->body_coverage) {
+            body_codes_v.push_back(body);
+            for (const auto &w : windows) {
+              body_starts_v.push_back(w.first);
+              body_stops_v.push_back(w.second);
+            }
+            body_offsets_v.push_back(body_starts_v.size());
+          }
+
+          if (!body_starts_v.empty()) {
+            H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_BODY_CODES_KEY, body_codes_v, H5Easy::DumpMode::Overwrite);
+            H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_BODY_COVERAGE_START_KEY, body_starts_v, H5Easy::DumpMode::Overwrite);
+            H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_BODY_COVERAGE_STOP_KEY, body_stops_v, H5Easy::DumpMode::Overwrite);
+            H5Easy::dump(file, DB_SPICE_ROOT_KEY + "/"+kernel_key+"/"+DB_BODY_COVERAGE_OFFSETS_KEY, body_offsets_v, H5Easy::DumpMode::Overwrite);
+          }
+        }
       }
     }
 
@@ -675,49 +1526,8 @@ namespace SpiceQL {
       }
     }
 
-  }
-
-
-  namespace {
-    std::mutex g_frame_cache_mutex;
-    std::string g_frame_cache_key;  // "<path>@<write-time>" of the loaded DB
-    std::unordered_map<int, std::string> g_code_to_name;
-    std::unordered_map<std::string, int> g_name_to_code;  // keyed on UPPER name
-
-    void loadFrameCache(InventoryImpl *impl) {
-      std::lock_guard<std::mutex> lock(g_frame_cache_mutex);
-
-      string hdf_file = (fs::path(getCacheDir()) / DB_HDF_FILE).string();
-      string key = hdf_file;
-      try {
-        if (fs::exists(hdf_file)) {
-          key += "@" + std::to_string(
-              static_cast<long long>(fs::last_write_time(hdf_file).time_since_epoch().count()));
-        }
-      } catch (...) { /* fall through with path-only key */ }
-
-      if (key == g_frame_cache_key) {
-        return;  // already loaded for this exact DB state
-      }
-
-      g_code_to_name.clear();
-      g_name_to_code.clear();
-      try {
-        vector<int> codes = impl->getKey<vector<int>>(DB_FRAME_CODES_KEY);
-        vector<string> names = impl->getKey<vector<string>>(DB_FRAME_NAMES_KEY);
-        size_t n = std::min(codes.size(), names.size());
-        g_code_to_name.reserve(n);
-        g_name_to_code.reserve(n);
-        for (size_t i = 0; i < n; i++) {
-          g_code_to_name[codes[i]] = names[i];
-          g_name_to_code[toUpper(names[i])] = codes[i];
-        }
-      }
-      catch (exception &e) {
-        SPDLOG_DEBUG("Frame code<->name cache unavailable: {}", e.what());
-      }
-      g_frame_cache_key = key;
-    }
+    // the frame tables changed, make the next lookup reload them
+    g_frame_cache_stale.store(true);
   }
 
 
@@ -739,18 +1549,80 @@ namespace SpiceQL {
   }
 
 
+  unsigned long long InventoryImpl::getFrameCacheGeneration() {
+    SnapshotReadGuard guard;
+    return frameCache()->generation;
+  }
+
+
+  vector<pair<int, string>> InventoryImpl::getFrameCodeNames() {
+    SnapshotReadGuard guard;
+    return frameCache()->by_code;
+  }
+
+
+  vector<int> InventoryImpl::getFrameInfo(int code, string mission) {
+    SnapshotReadGuard guard;
+    const std::array<int, 3> *info = findMissionRow(frameCache()->frame_info, mission, code);
+    if (info) return {(*info)[0], (*info)[1], (*info)[2]};
+    return {};
+  }
+
+
+  pair<int, string> InventoryImpl::getBodyFrame(int body, string mission) {
+    SnapshotReadGuard guard;
+    const pair<int, string> *frame = findMissionRow(frameCache()->body_frames, mission, body);
+    if (frame) return *frame;
+    return {0, ""};
+  }
+
+
+  json InventoryImpl::findMissionKeywords(string keytpl, string mission) {
+    std::shared_ptr<const MissionKeywordIndex> index = missionKeywords(toLower(mission));
+    if (!index) {
+      return nullptr;
+    }
+
+    // only names starting with the template's literal prefix can match
+    string prefix = keytpl.substr(0, keytpl.find_first_of("*%"));
+    auto it = std::lower_bound(index->names.begin(), index->names.end(), prefix);
+    json keywords = json::object();
+    for (; it != index->names.end() && it->compare(0, prefix.size(), prefix) == 0; ++it) {
+      if (matchesKeywordTemplate(keytpl, *it)) {
+        keywords[*it] = index->values[it - index->names.begin()];
+      }
+    }
+    return keywords;
+  }
+
+
+  pair<int, vector<double>> InventoryImpl::getTkFrame(int code, string mission) {
+    SnapshotReadGuard guard;
+    const auto *edge = findMissionRow(frameCache()->tk_frames, mission, code);
+    if (edge) {
+      return {edge->first, vector<double>(edge->second.begin(), edge->second.end())};
+    }
+    return {0, {}};
+  }
+
+
   string InventoryImpl::getFrameName(int code) {
-    loadFrameCache(this);
-    auto it = g_code_to_name.find(code);
-    if (it != g_code_to_name.end()) return it->second;
+    SnapshotReadGuard guard;
+    const FrameCacheSnapshot *cache = frameCache();
+    auto it = std::lower_bound(cache->by_code.begin(), cache->by_code.end(), code,
+                               [](const std::pair<int, std::string> &e, int c) { return e.first < c; });
+    if (it != cache->by_code.end() && it->first == code) return it->second;
     return "";
   }
 
 
   int InventoryImpl::getFrameCode(string name) {
-    loadFrameCache(this);
-    auto it = g_name_to_code.find(toUpper(name));
-    if (it != g_name_to_code.end()) return it->second;
+    SnapshotReadGuard guard;
+    const FrameCacheSnapshot *cache = frameCache();
+    name = toUpper(name);
+    auto it = std::lower_bound(cache->by_name.begin(), cache->by_name.end(), name,
+                               [](const std::pair<std::string, int> &e, const std::string &n) { return e.first < n; });
+    if (it != cache->by_name.end() && it->first == name) return it->second;
     return 0;
   }
 
@@ -11,6 +11,7 @@
 
 #include <SpiceQL/io.h>
 #include <SpiceQL/utils.h>
+#include <SpiceQL/executor.h>
 
 #include <SpiceQL/spiceql_logging.h>
 
@@ -90,6 +91,7 @@ namespace SpiceQL {
                string lsk,
                vector<vector<double>> angularVelocities,
                string comment) {
+    CspiceGuard cspice;
 
     SpiceInt handle;
     
@@ -177,6 +179,7 @@ namespace SpiceQL {
                  int polyDegree,
                  vector<vector<double>> stateVelocities,
                  string segmentComment) {
+    CspiceGuard cspice;
 
     if (stateTimes.empty() || statePositions.empty()) {
       throw runtime_error("writeSpk: stateTimes and statePositions must be non-empty.");
@@ -282,6 +285,7 @@ namespace SpiceQL {
   }
 
   void writeComment(string fileName, string comment) {
+    CspiceGuard cspice;
     SpiceInt handle;
     dafopw_c(fileName.c_str(), &handle);
     checkNaifErrors();
@@ -0,0 +1,754 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+#include <ghc/fs_std.hpp>
+
+#include "SpiceQL/api.h"
+#include "SpiceQL/inventoryimpl.h"
+#include "SpiceQL/localengine.h"
+#include "SpiceQL/spiceql_logging.h"
+#include "SpiceQL/utils.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL)
+// macOS, SO_NOSIGPIPE is set on the sockets instead
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace SpiceQL {
+
+  namespace {
+    // set in worker processes, which run their queries themselves
+    bool inWorker = false;
+
+    mutex activeMutex;
+    shared_ptr<LocalEngine> activeEngine;
+    once_flag activeFromEnv;
+
+    long readEnvLong(const char *name, long defaultValue) {
+      char *rawEnv = std::getenv(name);
+      if (rawEnv == nullptr) {
+        return defaultValue;
+      }
+      try {
+        return stol(string(rawEnv));
+      }
+      catch (exception &e) {
+        SPDLOG_WARN("Ignoring {}={}, it is not an integer", name, rawEnv);
+        return defaultValue;
+      }
+    }
+
+    template <typename T>
+    T arg(const json &args, const char *name) {
+      return args.at(name).get<T>();
+    }
+
+    // the API functions workers run, called with useWeb off
+    const unordered_map<string, function<pair<json, json>(const json &)>> &engineFunctions() {
+      static const unordered_map<string, function<pair<json, json>(const json &)>> functions = {
+        {"getTargetStates", [](const json &args) -> pair<json, json> {
+          return getTargetStates(arg<vector<double>>(args, "ets"), arg<string>(args, "target"),
+                                 arg<string>(args, "observer"), arg<string>(args, "frame"), arg<string>(args, "abcorr"),
+                                 arg<string>(args, "mission"), arg<vector<string>>(args, "ckQualities"),
+                                 arg<vector<string>>(args, "spkQualities"), false, arg<bool>(args, "searchKernels"),
+                                 arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                 arg<vector<string>>(args, "kernelList"));
+        }},
+        {"getTargetStatesRanged", [](const json &args) -> pair<json, json> {
+          return getTargetStatesRanged(arg<double>(args, "startEt"), arg<double>(args, "stopEt"), arg<int>(args, "numRecords"),
+                                       arg<string>(args, "target"), arg<string>(args, "observer"), arg<string>(args, "frame"),
+                                       arg<string>(args, "abcorr"), arg<string>(args, "mission"),
+                                       arg<vector<string>>(args, "ckQualities"), arg<vector<string>>(args, "spkQualities"),
+                                       false, arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                       arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                       arg<vector<string>>(args, "kernelList"));
+        }},
+        {"getTargetOrientations", [](const json &args) -> pair<json, json> {
+          return getTargetOrientations(arg<vector<double>>(args, "ets"), arg<int>(args, "toFrame"), arg<int>(args, "refFrame"),
+                                       arg<string>(args, "mission"), arg<vector<string>>(args, "ckQualities"), false,
+                                       arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                       arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                       arg<vector<string>>(args, "kernelList"));
+        }},
+        {"getTargetOrientationsRanged", [](const json &args) -> pair<json, json> {
+          return getTargetOrientationsRanged(arg<double>(args, "startEt"), arg<double>(args, "stopEt"), arg<int>(args, "numRecords"),
+                                             arg<int>(args, "toFrame"), arg<int>(args, "refFrame"), arg<string>(args, "mission"),
+                                             arg<vector<string>>(args, "ckQualities"), false, arg<bool>(args, "searchKernels"),
+                                             arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                             arg<vector<string>>(args, "kernelList"));
+        }},
+        {"strSclkToEt", [](const json &args) -> pair<json, json> {
+          return strSclkToEt(arg<int>(args, "frameCode"), arg<string>(args, "sclk"), arg<string>(args, "mission"),
+                             false, arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                             arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                             arg<vector<string>>(args, "kernelList"));
+        }},
+        {"doubleSclkToEt", [](const json &args) -> pair<json, json> {
+          return doubleSclkToEt(arg<int>(args, "frameCode"), arg<double>(args, "sclk"), arg<string>(args, "mission"),
+                                false, arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                arg<vector<string>>(args, "kernelList"));
+        }},
+        {"doubleEtToSclk", [](const json &args) -> pair<json, json> {
+          return doubleEtToSclk(arg<int>(args, "frameCode"), arg<double>(args, "et"), arg<string>(args, "mission"),
+                                false, arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                arg<vector<string>>(args, "kernelList"));
+        }},
+        {"strSclkToEtBatch", [](const json &args) -> pair<json, json> {
+          return strSclkToEtBatch(arg<int>(args, "frameCode"), arg<vector<string>>(args, "sclks"),
+                                  arg<string>(args, "mission"), false, arg<bool>(args, "searchKernels"),
+                                  arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                  arg<vector<string>>(args, "kernelList"));
+        }},
+        {"doubleSclkToEtBatch", [](const json &args) -> pair<json, json> {
+          return doubleSclkToEtBatch(arg<int>(args, "frameCode"), arg<vector<double>>(args, "sclks"),
+                                     arg<string>(args, "mission"), false, arg<bool>(args, "searchKernels"),
+                                     arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                     arg<vector<string>>(args, "kernelList"));
+        }},
+        {"doubleEtToSclkBatch", [](const json &args) -> pair<json, json> {
+          return doubleEtToSclkBatch(arg<int>(args, "frameCode"), arg<vector<double>>(args, "ets"),
+                                     arg<string>(args, "mission"), false, arg<bool>(args, "searchKernels"),
+                                     arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                     arg<vector<string>>(args, "kernelList"));
+        }},
+        {"utcToEt", [](const json &args) -> pair<json, json> {
+          return utcToEt(arg<string>(args, "utc"), false, arg<bool>(args, "searchKernels"),
+                         arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                         arg<vector<string>>(args, "kernelList"));
+        }},
+        {"etToUtc", [](const json &args) -> pair<json, json> {
+          return etToUtc(arg<double>(args, "et"), arg<string>(args, "format"), arg<double>(args, "precision"),
+                         false, arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                         arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                         arg<vector<string>>(args, "kernelList"));
+        }},
+        {"utcToEtBatch", [](const json &args) -> pair<json, json> {
+          return utcToEtBatch(arg<vector<string>>(args, "utcs"), false, arg<bool>(args, "searchKernels"),
+                              arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                              arg<vector<string>>(args, "kernelList"));
+        }},
+        {"etToUtcBatch", [](const json &args) -> pair<json, json> {
+          return etToUtcBatch(arg<vector<double>>(args, "ets"), arg<string>(args, "format"),
+                              arg<double>(args, "precision"), false, arg<bool>(args, "searchKernels"),
+                              arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                              arg<vector<string>>(args, "kernelList"));
+        }},
+        {"translateNameToCode", [](const json &args) -> pair<json, json> {
+          return translateNameToCode(arg<string>(args, "frame"), arg<string>(args, "mission"), false,
+                                     arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                     arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                     arg<vector<string>>(args, "kernelList"));
+        }},
+        {"translateNameToCodeBatch", [](const json &args) -> pair<json, json> {
+          return translateNameToCodeBatch(arg<vector<string>>(args, "frames"), arg<string>(args, "mission"), false,
+                                          arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                          arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                          arg<vector<string>>(args, "kernelList"));
+        }},
+        {"translateCodeToName", [](const json &args) -> pair<json, json> {
+          return translateCodeToName(arg<int>(args, "frame"), arg<string>(args, "mission"), false,
+                                     arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                     arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                     arg<vector<string>>(args, "kernelList"));
+        }},
+        {"translateCodeToNameBatch", [](const json &args) -> pair<json, json> {
+          return translateCodeToNameBatch(arg<vector<int>>(args, "frames"), arg<string>(args, "mission"), false,
+                                          arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                          arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                          arg<vector<string>>(args, "kernelList"));
+        }},
+        {"getFrameInfo", [](const json &args) -> pair<json, json> {
+          return getFrameInfo(arg<int>(args, "frame"), arg<string>(args, "mission"), false,
+                              arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                              arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                              arg<vector<string>>(args, "kernelList"));
+        }},
+        {"getFrameInfoBatch", [](const json &args) -> pair<json, json> {
+          return getFrameInfoBatch(arg<vector<int>>(args, "frames"), arg<string>(args, "mission"), false,
+                                   arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                   arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                   arg<vector<string>>(args, "kernelList"));
+        }},
+        {"getTargetFrameInfo", [](const json &args) -> pair<json, json> {
+          return getTargetFrameInfo(arg<int>(args, "targetId"), arg<string>(args, "mission"), false,
+                                    arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                    arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                    arg<vector<string>>(args, "kernelList"));
+        }},
+        {"findMissionKeywords", [](const json &args) -> pair<json, json> {
+          return findMissionKeywords(arg<string>(args, "key"), arg<string>(args, "mission"), false,
+                                     arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                     arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                     arg<vector<string>>(args, "kernelList"));
+        }},
+        {"findTargetKeywords", [](const json &args) -> pair<json, json> {
+          return findTargetKeywords(arg<string>(args, "key"), arg<string>(args, "mission"), false,
+                                    arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                                    arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                    arg<vector<string>>(args, "kernelList"));
+        }},
+        {"frameTrace", [](const json &args) -> pair<json, json> {
+          return frameTrace(arg<double>(args, "et"), arg<int>(args, "initialFrame"), arg<string>(args, "mission"),
+                            arg<vector<string>>(args, "ckQualities"), arg<vector<string>>(args, "spkQualities"),
+                            false, arg<bool>(args, "searchKernels"), arg<bool>(args, "fullKernelPath"),
+                            arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                            arg<vector<string>>(args, "kernelList"));
+        }},
+        {"extractExactCkTimes", [](const json &args) -> pair<json, json> {
+          return extractExactCkTimes(arg<double>(args, "observStart"), arg<double>(args, "observEnd"),
+                                     arg<int>(args, "targetFrame"), arg<string>(args, "mission"),
+                                     arg<vector<string>>(args, "ckQualities"), false, arg<bool>(args, "searchKernels"),
+                                     arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                     arg<vector<string>>(args, "kernelList"));
+        }},
+        {"getExactTargetOrientations", [](const json &args) -> pair<json, json> {
+          return getExactTargetOrientations(arg<double>(args, "startEt"), arg<double>(args, "stopEt"), arg<int>(args, "toFrame"),
+                                            arg<int>(args, "refFrame"), arg<int>(args, "exactCkFrame"), arg<string>(args, "mission"),
+                                            arg<vector<string>>(args, "ckQualities"), false, arg<bool>(args, "searchKernels"),
+                                            arg<bool>(args, "fullKernelPath"), arg<int>(args, "limitCk"), arg<int>(args, "limitSpk"),
+                                            arg<vector<string>>(args, "kernelList"));
+        }}
+      };
+      return functions;
+    }
+
+#ifndef _WIN32
+    const char *WORKER_EXECUTABLE = "spiceql-worker";
+
+    void setCloseOnExec(int fd, bool on) {
+      int flags = fcntl(fd, F_GETFD);
+      fcntl(fd, F_SETFD, on ? (flags | FD_CLOEXEC) : (flags & ~FD_CLOEXEC));
+    }
+
+    // the worker executable, next to the library in a build tree or in the bin next to its lib when installed
+    string findWorkerExecutable() {
+      char *rawEnv = std::getenv("SPICEQL_LOCAL_ENGINE_WORKER");
+      if (rawEnv != nullptr) {
+        return rawEnv;
+      }
+
+      vector<fs::path> candidates;
+      Dl_info info;
+      if (dladdr(reinterpret_cast<void *>(&findWorkerExecutable), &info) != 0 && info.dli_fname != nullptr) {
+        fs::path libraryDir = fs::path(info.dli_fname).parent_path();
+        candidates.push_back(libraryDir / WORKER_EXECUTABLE);
+        candidates.push_back(libraryDir.parent_path() / "bin" / WORKER_EXECUTABLE);
+      }
+      char *path = std::getenv("PATH");
+      if (path != nullptr) {
+        for (const string &dir : split(path, ':')) {
+          if (!dir.empty()) {
+            candidates.push_back(fs::path(dir) / WORKER_EXECUTABLE);
+          }
+        }
+      }
+
+      for (const fs::path &candidate : candidates) {
+        if (access(candidate.c_str(), X_OK) == 0) {
+          return candidate.string();
+        }
+      }
+      throw runtime_error(fmt::format("Could not find the {} executable, set SPICEQL_LOCAL_ENGINE_WORKER to its path", WORKER_EXECUTABLE));
+    }
+
+    // unlinked right away, the worker gets the descriptor
+    int createSharedMemory(size_t size) {
+      static atomic<unsigned> count{0};
+      string name = fmt::format("/spiceql-{}-{}", getpid(), count++);
+      int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+      if (fd < 0) {
+        throw runtime_error(fmt::format("Could not create local engine shared memory: {}", strerror(errno)));
+      }
+      shm_unlink(name.c_str());
+      setCloseOnExec(fd, true);
+      if (ftruncate(fd, size) != 0) {
+        int error = errno;
+        close(fd);
+        throw runtime_error(fmt::format("Could not size {} bytes of local engine shared memory: {}", size, strerror(error)));
+      }
+      return fd;
+    }
+
+    // sent before every message, the payload is in shared memory or follows on the socket
+    struct MessageHeader {
+      uint64_t size;
+      uint32_t inSharedMemory;
+    };
+
+    void writeAll(int fd, const void *data, size_t size) {
+      const char *bytes = static_cast<const char *>(data);
+      while (size > 0) {
+        ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          throw runtime_error(fmt::format("Could not write to local engine socket: {}", strerror(errno)));
+        }
+        bytes += written;
+        size -= written;
+      }
+    }
+
+    // false if the other side closed the socket before sending anything,
+    // waitReadable (if set) returns once the socket has data or throws
+    bool readAll(int fd, void *data, size_t size, const function<void()> &waitReadable) {
+      char *bytes = static_cast<char *>(data);
+      size_t total = size;
+      while (size > 0) {
+        if (waitReadable) {
+          waitReadable();
+        }
+        ssize_t got = recv(fd, bytes, size, 0);
+        if (got < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          throw runtime_error(fmt::format("Could not read from local engine socket: {}", strerror(errno)));
+        }
+        if (got == 0) {
+          if (size == total) {
+            return false;
+          }
+          throw runtime_error("Local engine socket closed mid message");
+        }
+        bytes += got;
+        size -= got;
+      }
+      return true;
+    }
+
+    void sendMessage(int fd, unsigned char *sharedMemory, size_t sharedMemorySize, const vector<uint8_t> &bytes) {
+      MessageHeader header{bytes.size(), bytes.size() <= sharedMemorySize};
+      if (header.inSharedMemory) {
+        memcpy(sharedMemory, bytes.data(), bytes.size());
+      }
+      writeAll(fd, &header, sizeof(header));
+      if (!header.inSharedMemory) {
+        writeAll(fd, bytes.data(), bytes.size());
+      }
+    }
+
+    bool receiveMessage(int fd, const unsigned char *sharedMemory, vector<uint8_t> &bytes,
+                        const function<void()> &waitReadable = nullptr) {
+      MessageHeader header;
+      if (!readAll(fd, &header, sizeof(header), waitReadable)) {
+        return false;
+      }
+      bytes.resize(header.size);
+      if (header.inSharedMemory) {
+        memcpy(bytes.data(), sharedMemory, header.size);
+      }
+      else if (!readAll(fd, bytes.data(), header.size, waitReadable)) {
+        throw runtime_error("Local engine socket closed mid message");
+      }
+      return true;
+    }
+
+    // a worker's life, it returns when the supervisor closes its socket
+    void serve(int fd, unsigned char *sharedMemory, size_t sharedMemorySize) {
+      vector<uint8_t> bytes;
+
+      // the host's settings come first, the worker answers once it uses them
+      try {
+        if (!receiveMessage(fd, sharedMemory, bytes)) {
+          return;
+        }
+        json settings = json::from_msgpack(bytes);
+        setCacheDir(settings.at("cacheDir"), true);
+        if (settings.at("aliases").is_object()) {
+          setAliasMap(settings["aliases"]);
+        }
+        sendMessage(fd, sharedMemory, sharedMemorySize, json::to_msgpack({{"ready", true}}));
+      }
+      catch (exception &e) {
+        SPDLOG_ERROR("Local engine worker could not start: {}", e.what());
+        return;
+      }
+
+      while (true) {
+        json response;
+        try {
+          if (!receiveMessage(fd, sharedMemory, bytes)) {
+            break;
+          }
+          json request = json::from_msgpack(bytes);
+          string functionName = request.at("function");
+          auto function = engineFunctions().find(functionName);
+          if (function == engineFunctions().end()) {
+            throw invalid_argument(fmt::format("{} can not run on the local engine", functionName));
+          }
+          auto [value, kernels] = function->second(request.at("args"));
+          response = {{"statusCode", 200}, {"body", {{"return", value}, {"kernels", kernels}}}};
+        }
+        catch (invalid_argument &e) {
+          response = {{"error", e.what()}, {"type", "invalid_argument"}};
+        }
+        catch (out_of_range &e) {
+          response = {{"error", e.what()}, {"type", "out_of_range"}};
+        }
+        catch (exception &e) {
+          response = {{"error", e.what()}, {"type", "runtime_error"}};
+        }
+
+        try {
+          sendMessage(fd, sharedMemory, sharedMemorySize, json::to_msgpack(response));
+        }
+        catch (exception &e) {
+          break;
+        }
+      }
+    }
+#endif
+  }
+
+
+  LocalEngine::LocalEngine(size_t workers, size_t sharedMemorySize, chrono::seconds timeout) :
+      m_sharedMemorySize(sharedMemorySize), m_timeout(timeout) {
+#ifdef _WIN32
+    throw runtime_error("The local engine needs worker processes, they are not available on Windows");
+#else
+    m_executable = findWorkerExecutable();
+    m_workers.resize(max<size_t>(workers, 1));
+    try {
+      for (Worker &worker : m_workers) {
+        spawn(worker);
+      }
+    }
+    catch (exception &e) {
+      for (Worker &worker : m_workers) {
+        reap(worker);
+        unmap(worker);
+      }
+      throw;
+    }
+    SPDLOG_DEBUG("Started a local engine with {} workers of {}", m_workers.size(), m_executable);
+#endif
+  }
+
+
+  LocalEngine::~LocalEngine() {
+#ifndef _WIN32
+    unique_lock<mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] {
+      return none_of(m_workers.begin(), m_workers.end(), [](const Worker &w) { return w.busy; });
+    });
+    for (Worker &worker : m_workers) {
+      if (worker.socket >= 0) {
+        // the worker exits once it reads the end of its socket
+        close(worker.socket);
+        worker.socket = -1;
+        waitpid(worker.pid, nullptr, 0);
+        worker.pid = -1;
+      }
+      unmap(worker);
+    }
+#endif
+  }
+
+
+  json LocalEngine::query(const string &functionName, const json &args) {
+#ifdef _WIN32
+    throw runtime_error("The local engine needs worker processes, they are not available on Windows");
+#else
+    Worker *worker = nullptr;
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_idle.wait(lock, [this] {
+        return any_of(m_workers.begin(), m_workers.end(), [](const Worker &w) { return !w.busy; });
+      });
+      worker = &*find_if(m_workers.begin(), m_workers.end(), [](const Worker &w) { return !w.busy; });
+      worker->busy = true;
+    }
+
+    auto release = [&]() {
+      {
+        lock_guard<mutex> lock(m_mutex);
+        worker->busy = false;
+      }
+      m_idle.notify_one();
+    };
+
+    vector<uint8_t> bytes;
+    try {
+      if (worker->pid < 0) {
+        SPDLOG_WARN("Starting a local engine worker to replace one that could not be started");
+        spawn(*worker);
+      }
+      SPDLOG_TRACE("Local engine worker {} running {}", worker->pid, functionName);
+      sendMessage(worker->socket, worker->sharedMemory, m_sharedMemorySize, json::to_msgpack({{"function", functionName}, {"args", args}}));
+      if (!receive(*worker, bytes)) {
+        throw runtime_error("the worker exited");
+      }
+    }
+    catch (exception &e) {
+      // a worker that died or hangs is killed and replaced right away
+      SPDLOG_WARN("Replacing local engine worker {}: {}", worker->pid, e.what());
+      reap(*worker);
+      try {
+        spawn(*worker);
+      }
+      catch (exception &spawnError) {
+        SPDLOG_ERROR("Could not replace a local engine worker: {}", spawnError.what());
+        reap(*worker);
+      }
+      release();
+      throw runtime_error(fmt::format("Local engine query {} failed: {}", functionName, e.what()));
+    }
+    release();
+
+    json response = json::from_msgpack(bytes);
+    if (response.contains("error")) {
+      string message = response["error"];
+      if (response["type"] == "invalid_argument") {
+        throw invalid_argument(message);
+      }
+      if (response["type"] == "out_of_range") {
+        throw out_of_range(message);
+      }
+      throw runtime_error(message);
+    }
+    return response;
+#endif
+  }
+
+
+  void LocalEngine::spawn(Worker &worker) {
+#ifndef _WIN32
+    if (worker.sharedMemoryFd < 0) {
+      worker.sharedMemoryFd = createSharedMemory(m_sharedMemorySize);
+      void *memory = mmap(nullptr, m_sharedMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, worker.sharedMemoryFd, 0);
+      if (memory == MAP_FAILED) {
+        int error = errno;
+        close(worker.sharedMemoryFd);
+        worker.sharedMemoryFd = -1;
+        throw runtime_error(fmt::format("Could not map {} bytes of local engine shared memory: {}", m_sharedMemorySize, strerror(error)));
+      }
+      worker.sharedMemory = static_cast<unsigned char *>(memory);
+    }
+
+    // close-on-exec from the start, so workers started from other threads do not keep them open
+    int fds[2];
+#ifdef SOCK_CLOEXEC
+    int created = socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds);
+#else
+    int created = socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+#endif
+    if (created != 0) {
+      throw runtime_error(fmt::format("Could not create a local engine socket: {}", strerror(errno)));
+    }
+    setCloseOnExec(fds[0], true);
+    setCloseOnExec(fds[1], true);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+    setsockopt(fds[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    // everything the child needs is built before the fork, other threads'
+    // locks stay held in the child, so it only makes async-signal-safe calls
+    string socketArg = to_string(fds[1]);
+    string sharedMemoryArg = to_string(worker.sharedMemoryFd);
+    string sizeArg = to_string(m_sharedMemorySize);
+    vector<char *> argv = {m_executable.data(), socketArg.data(), sharedMemoryArg.data(), sizeArg.data(), nullptr};
+    int sharedMemoryFd = worker.sharedMemoryFd;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+      setCloseOnExec(fds[1], false);
+      setCloseOnExec(sharedMemoryFd, false);
+      execv(argv[0], argv.data());
+      _exit(127);
+    }
+
+    close(fds[1]);
+    if (pid < 0) {
+      close(fds[0]);
+      throw runtime_error(fmt::format("Could not start a local engine worker: {}", strerror(errno)));
+    }
+    worker.pid = pid;
+    worker.socket = fds[0];
+
+    // the worker answers once it has the host's cache directory and aliases
+    try {
+      json settings = {{"cacheDir", getCacheDir()}, {"aliases", getAliasMap()}};
+      sendMessage(worker.socket, worker.sharedMemory, m_sharedMemorySize, json::to_msgpack(settings));
+      vector<uint8_t> bytes;
+      if (!receive(worker, bytes)) {
+        throw runtime_error("the worker exited");
+      }
+    }
+    catch (exception &e) {
+      throw runtime_error(fmt::format("Local engine worker {} did not start: {}", m_executable, e.what()));
+    }
+#endif
+  }
+
+
+  bool LocalEngine::receive(Worker &worker, vector<uint8_t> &bytes) {
+#ifdef _WIN32
+    return false;
+#else
+    auto deadline = chrono::steady_clock::now() + m_timeout;
+    // poll in short steps, a worker that died does not always close its socket
+    // (a process it started can keep it open), so check on the process as well
+    auto waitReadable = [&]() {
+      while (true) {
+        auto left = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+        if (left.count() <= 0) {
+          throw runtime_error(fmt::format("the worker did not answer within {} s", m_timeout.count()));
+        }
+        pollfd socket = {worker.socket, POLLIN, 0};
+        int ready = poll(&socket, 1, static_cast<int>(min<long long>(left.count(), 1000)));
+        if (ready > 0) {
+          return;
+        }
+        if (ready < 0 && errno != EINTR) {
+          throw runtime_error(fmt::format("Could not poll local engine socket: {}", strerror(errno)));
+        }
+        if (waitpid(worker.pid, nullptr, WNOHANG) == worker.pid) {
+          worker.pid = -1;
+          throw runtime_error("the worker exited");
+        }
+      }
+    };
+    return receiveMessage(worker.socket, worker.sharedMemory, bytes, waitReadable);
+#endif
+  }
+
+
+  void LocalEngine::reap(Worker &worker) {
+#ifndef _WIN32
+    if (worker.socket >= 0) {
+      close(worker.socket);
+      worker.socket = -1;
+    }
+    if (worker.pid > 0) {
+      kill(worker.pid, SIGKILL);
+      waitpid(worker.pid, nullptr, 0);
+      worker.pid = -1;
+    }
+#endif
+  }
+
+
+  void LocalEngine::unmap(Worker &worker) {
+#ifndef _WIN32
+    if (worker.sharedMemory) {
+      munmap(worker.sharedMemory, m_sharedMemorySize);
+      worker.sharedMemory = nullptr;
+    }
+    if (worker.sharedMemoryFd >= 0) {
+      close(worker.sharedMemoryFd);
+      worker.sharedMemoryFd = -1;
+    }
+#endif
+  }
+
+
+  void LocalEngine::start(size_t workers, size_t sharedMemorySize, chrono::seconds timeout) {
+    shared_ptr<LocalEngine> engine = make_shared<LocalEngine>(workers, sharedMemorySize, timeout);
+    lock_guard<mutex> lock(activeMutex);
+    // a replaced engine stops once its running queries finish
+    activeEngine.swap(engine);
+  }
+
+
+  void LocalEngine::stop() {
+    shared_ptr<LocalEngine> engine;
+    {
+      lock_guard<mutex> lock(activeMutex);
+      engine.swap(activeEngine);
+    }
+  }
+
+
+  shared_ptr<LocalEngine> LocalEngine::active() {
+    if (inWorker) {
+      return nullptr;
+    }
+
+    call_once(activeFromEnv, []() {
+      long workers = readEnvLong("SPICEQL_LOCAL_ENGINE_WORKERS", 0);
+      if (workers > 0) {
+        long sharedMemoryMb = max(readEnvLong("SPICEQL_LOCAL_ENGINE_SHM_MB", 64), 1L);
+        long timeout = max(readEnvLong("SPICEQL_LOCAL_ENGINE_TIMEOUT", 600), 1L);
+        start(workers, sharedMemoryMb * 1024 * 1024, chrono::seconds(timeout));
+      }
+    });
+
+    lock_guard<mutex> lock(activeMutex);
+    return activeEngine;
+  }
+
+
+  int LocalEngine::runWorker(int argc, char **argv) {
+#ifdef _WIN32
+    SPDLOG_ERROR("The local engine needs worker processes, they are not available on Windows");
+    return 1;
+#else
+    if (argc != 4) {
+      SPDLOG_ERROR("Usage: {} <socket> <shared memory> <shared memory size>, {} is started by the local engine",
+                   WORKER_EXECUTABLE, WORKER_EXECUTABLE);
+      return 2;
+    }
+
+    int fd, sharedMemoryFd;
+    size_t sharedMemorySize;
+    try {
+      fd = stoi(argv[1]);
+      sharedMemoryFd = stoi(argv[2]);
+      sharedMemorySize = stoull(argv[3]);
+    }
+    catch (exception &e) {
+      SPDLOG_ERROR("Invalid local engine worker arguments: {}", e.what());
+      return 2;
+    }
+
+    void *memory = mmap(nullptr, sharedMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, sharedMemoryFd, 0);
+    close(sharedMemoryFd);
+    if (memory == MAP_FAILED) {
+      SPDLOG_ERROR("Could not map local engine shared memory: {}", strerror(errno));
+      return 1;
+    }
+
+    inWorker = true;
+    serve(fd, static_cast<unsigned char *>(memory), sharedMemorySize);
+    munmap(memory, sharedMemorySize);
+    close(fd);
+    return 0;
+#endif
+  }
+}
@@ -30,9 +30,9 @@ namespace SpiceQL {
 
 
  std::string getKernelStringValue(std::string key) {
-   // check to make sure the key exists when calling findKeyWords(key)
-   if (findKeywords(key).contains(key)){
-      json results = findKeywords(key);
+   json results = findKeywords(key);
+   // check to make sure the key exists in the results
+   if (results.contains(key)){
       std::string keyResult;
       if (results[key].is_string()) {
           keyResult = results[key];
@@ -50,11 +50,11 @@ namespace SpiceQL {
 
   std::vector<string> getKernelVectorValue(std::string key) {
 
-    // check to make sure the key exists when calling findKeyWords(key)
-    if (findKeywords(key).contains(key)){
+    // get json results of key
+    json results = findKeywords(key);
 
-      // get json results of key
-      json results = findKeywords(key);
+    // check to make sure the key exists in the results
+    if (results.contains(key)){
       vector<string> kernelValues;
 
       // iterate over results @ key
@@ -0,0 +1,293 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <ghc/fs_std.hpp>
+
+#include <fmt/format.h>
+
+#include "SpiceQL/restcache.h"
+#include "SpiceQL/spiceql_logging.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace SpiceQL {
+
+  namespace {
+
+    long readEnvLong(const char *name, long defaultValue) {
+      char *rawEnv = std::getenv(name);
+      if (rawEnv == nullptr) {
+        return defaultValue;
+      }
+      try {
+        return stol(string(rawEnv));
+      }
+      catch (exception &e) {
+        SPDLOG_WARN("Ignoring {}={}, it is not an integer", name, rawEnv);
+        return defaultValue;
+      }
+    }
+
+    // FNV-1a, stable across runs and platforms unlike std::hash, so disk entries
+    // written by one session are found by the next
+    uint64_t stableHash(const string &key) {
+      uint64_t hash = 14695981039346656037ULL;
+      for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    long long toSeconds(chrono::system_clock::time_point time) {
+      return chrono::duration_cast<chrono::seconds>(time.time_since_epoch()).count();
+    }
+  }
+
+
+  RestCache::RestCache(size_t maxBytes, string directory, chrono::seconds ttl)
+      : m_maxBytes(maxBytes), m_directory(directory), m_ttl(ttl) {
+    if (enabled() && !m_directory.empty()) {
+      fs::create_directories(m_directory);
+      pruneDirectory();
+    }
+  }
+
+
+  RestCache &RestCache::instance() {
+    static RestCache cache([] {
+      long maxBytes = max(readEnvLong("SPICEQL_REST_CACHE_SIZE", 0), 0L);
+      char *directory = std::getenv("SPICEQL_REST_CACHE_DIR");
+      long ttl = max(readEnvLong("SPICEQL_REST_CACHE_TTL", 600), 0L);
+      if (maxBytes > 0) {
+        SPDLOG_DEBUG("REST cache holds up to {} bytes of responses for {}s, on disk in {}", maxBytes, ttl, directory ? directory : "(none)");
+      }
+      return RestCache(maxBytes, directory ? directory : "", chrono::seconds(ttl));
+    }());
+    return cache;
+  }
+
+
+  string RestCache::makeKey(const string &functionName, const json &args) {
+    return functionName + "?" + args.dump();
+  }
+
+
+  optional<RestCache::Entry> RestCache::get(const string &key) {
+    if (!enabled()) {
+      return nullopt;
+    }
+
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    Stored *stored = nullptr;
+
+    if (it != m_entries.end()) {
+      stored = &it->second;
+      m_lru.splice(m_lru.begin(), m_lru, stored->lru);
+    }
+    else if (!m_directory.empty()) {
+      string path = pathFor(key);
+      ifstream file(path, ios::binary);
+      if (!file) {
+        return nullopt;
+      }
+
+      try {
+        vector<uint8_t> bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        json j = json::from_msgpack(bytes);
+        if (j.at("key") != key) {
+          // hash collision, the file belongs to another request
+          return nullopt;
+        }
+        if (bytes.size() > m_maxBytes) {
+          return nullopt;
+        }
+        chrono::system_clock::time_point storedAt{chrono::seconds(j.at("stored").get<long long>())};
+        stored = &insert(key, std::move(j.at("response")), j.at("etag").get<string>(), storedAt, bytes.size());
+      }
+      catch (json::exception &e) {
+        SPDLOG_WARN("Removing unreadable REST cache file {}: {}", path, e.what());
+        file.close();
+        std::error_code ec;
+        fs::remove(path, ec);
+        return nullopt;
+      }
+    }
+    else {
+      return nullopt;
+    }
+
+    bool fresh = chrono::system_clock::now() - stored->stored < m_ttl &&
+                 (m_serverEtag.empty() || stored->etag == m_serverEtag);
+    return Entry{stored->response, stored->etag, fresh};
+  }
+
+
+  void RestCache::put(const string &key, const json &response, const string &etag) {
+    if (!enabled()) {
+      return;
+    }
+
+    // the on-disk record also sizes the entry in memory
+    auto now = chrono::system_clock::now();
+    json j = {{"key", key}, {"etag", etag}, {"stored", toSeconds(now)}, {"response", response}};
+    vector<uint8_t> bytes = json::to_msgpack(j);
+
+    lock_guard<mutex> lock(m_mutex);
+    if (!etag.empty()) {
+      m_serverEtag = etag;
+    }
+    if (bytes.size() > m_maxBytes) {
+      SPDLOG_DEBUG("Not caching a {} byte response, the REST cache holds {} bytes", bytes.size(), m_maxBytes);
+      return;
+    }
+    insert(key, std::move(j.at("response")), etag, now, bytes.size());
+
+    if (m_directory.empty()) {
+      return;
+    }
+
+    // write then rename so other processes never read a partial file
+    string path = pathFor(key);
+    string tmpPath = fmt::format("{}.{:x}.tmp", path, random_device{}());
+    {
+      ofstream file(tmpPath, ios::binary | ios::trunc);
+      file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+      if (!file) {
+        SPDLOG_WARN("Could not write REST cache file {}", tmpPath);
+        file.close();
+        std::error_code ec;
+        fs::remove(tmpPath, ec);
+        return;
+      }
+    }
+    std::error_code ec;
+    uintmax_t replaced = fs::file_size(path, ec);
+    if (ec) {
+      replaced = 0;
+    }
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+      SPDLOG_WARN("Could not write REST cache file {}: {}", path, ec.message());
+      fs::remove(tmpPath, ec);
+      return;
+    }
+
+    // only scan the directory once this process has written past the limit
+    m_directoryBytes = m_directoryBytes - min<size_t>(replaced, m_directoryBytes) + bytes.size();
+    if (m_directoryBytes > m_maxBytes) {
+      pruneDirectory();
+    }
+  }
+
+
+  void RestCache::clear() {
+    lock_guard<mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+    m_directoryBytes = 0;
+    m_serverEtag.clear();
+
+    if (!m_directory.empty() && fs::exists(m_directory)) {
+      for (auto &file : fs::directory_iterator(m_directory)) {
+        if (file.path().extension() == ".msgpack") {
+          fs::remove(file.path());
+        }
+      }
+    }
+  }
+
+
+  size_t RestCache::size() {
+    lock_guard<mutex> lock(m_mutex);
+    return m_entries.size();
+  }
+
+
+  size_t RestCache::bytes() {
+    lock_guard<mutex> lock(m_mutex);
+    return m_bytes;
+  }
+
+
+  RestCache::Stored &RestCache::insert(const string &key, json response, string etag,
+                                       chrono::system_clock::time_point stored, size_t bytes) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+      m_lru.push_front(key);
+      it = m_entries.emplace(key, Stored{json(), "", {}, 0, m_lru.begin()}).first;
+    }
+    else {
+      m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    }
+    it->second.response = std::move(response);
+    it->second.etag = std::move(etag);
+    it->second.stored = stored;
+    m_bytes += bytes - it->second.bytes;
+    it->second.bytes = bytes;
+
+    // entries are never larger than the limit, so the new one at the front stays
+    while (m_bytes > m_maxBytes) {
+      auto last = m_entries.find(m_lru.back());
+      m_bytes -= last->second.bytes;
+      m_entries.erase(last);
+      m_lru.pop_back();
+    }
+    return it->second;
+  }
+
+
+  string RestCache::pathFor(const string &key) const {
+    return (fs::path(m_directory) / fmt::format("{:016x}.msgpack", stableHash(key))).string();
+  }
+
+
+  void RestCache::pruneDirectory() {
+    // other processes may share the directory, so files can vanish under us
+    // and the real total can be larger than m_directoryBytes
+    std::error_code ec;
+    vector<tuple<fs::file_time_type, uintmax_t, fs::path>> files;
+    size_t total = 0;
+    for (auto &file : fs::directory_iterator(m_directory, ec)) {
+      if (file.path().extension() == ".msgpack") {
+        fs::file_time_type written = fs::last_write_time(file.path(), ec);
+        uintmax_t size = ec ? 0 : fs::file_size(file.path(), ec);
+        if (!ec) {
+          files.emplace_back(written, size, file.path());
+          total += size;
+        }
+      }
+    }
+    m_directoryBytes = total;
+    if (total <= m_maxBytes) {
+      return;
+    }
+
+    // Drop the least recently written files down to three quarters of the
+    // limit, so the next scan is a quarter of the limit of writes away
+    sort(files.begin(), files.end());
+    for (auto &[written, size, path] : files) {
+      if (m_directoryBytes <= m_maxBytes / 4 * 3) {
+        break;
+      }
+      if (fs::remove(path, ec)) {
+        m_directoryBytes -= size;
+      }
+    }
+  }
+}
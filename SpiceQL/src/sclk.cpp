@@ -0,0 +1,389 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <ghc/fs_std.hpp>
+
+#include <fmt/format.h>
+
+#include "SpiceQL/sclk.h"
+#include "SpiceQL/spiceql_logging.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace SpiceQL {
+
+  namespace {
+
+    /**
+     * Get the numeric values of a text kernel keyword, throwing if it is missing.
+     */
+    vector<double> getNumbers(const json &pool, string keyword, int clockId) {
+      if (!pool.contains(keyword)) {
+        throw invalid_argument(fmt::format("Keyword [{}] for clock [{}] was not found in the SCLK kernels.", keyword, clockId));
+      }
+
+      vector<double> values;
+      for (const json &value : pool[keyword]) {
+        if (!value.is_number()) {
+          throw invalid_argument(fmt::format("Keyword [{}] for clock [{}] has non-numeric value [{}].", keyword, clockId, value.dump()));
+        }
+        values.push_back(value.get<double>());
+      }
+      return values;
+    }
+
+
+    /**
+     * Index of the last element of a sorted column that is <= value, clamped to the first element.
+     */
+    size_t lastAtOrBefore(const vector<double> &column, double value) {
+      auto it = upper_bound(column.begin(), column.end(), value);
+      if (it == column.begin()) {
+        return 0;
+      }
+      return (it - column.begin()) - 1;
+    }
+
+
+    /**
+     * Number of digits needed to print a non-negative count.
+     */
+    int countDigits(double value) {
+      int digits = 1;
+      while (value >= 10) {
+        value = floor(value / 10);
+        digits++;
+      }
+      return digits;
+    }
+  }
+
+
+  shared_ptr<const SclkModel> SclkModel::load(vector<string> sclkPaths, int clockId, string lskPath) {
+    // a model, or why the kernels have none, and the entry's place in the LRU order
+    struct Cached {
+      shared_ptr<const SclkModel> model;
+      string error;
+      list<string>::iterator lru;
+    };
+    static mutex cacheMutex;
+    static unordered_map<string, Cached> cache;
+    static list<string> lru;
+
+    // key on the file list and modification times so edited kernels are re-read
+    string key = to_string(clockId);
+    vector<string> keyPaths = sclkPaths;
+    if (!lskPath.empty()) {
+      keyPaths.push_back(lskPath);
+    }
+    for (const string &path : keyPaths) {
+      if (!fs::exists(path)) {
+        throw invalid_argument("Kernel [" + path + "] does not exist");
+      }
+      key += "|" + path + "@" + to_string(fs::last_write_time(path).time_since_epoch().count());
+    }
+    key += "|" + lskPath;
+
+    {
+      lock_guard<mutex> lock(cacheMutex);
+      auto it = cache.find(key);
+      if (it != cache.end()) {
+        lru.splice(lru.begin(), lru, it->second.lru);
+        if (!it->second.model) {
+          throw invalid_argument(it->second.error);
+        }
+        return it->second.model;
+      }
+    }
+
+    auto remember = [&](shared_ptr<const SclkModel> model, string error) {
+      lock_guard<mutex> lock(cacheMutex);
+      auto it = cache.find(key);
+      if (it == cache.end()) {
+        lru.push_front(key);
+        it = cache.emplace(key, Cached{nullptr, "", lru.begin()}).first;
+      }
+      it->second.model = model;
+      it->second.error = error;
+      while (cache.size() > MODEL_CACHE_SIZE) {
+        cache.erase(lru.back());
+        lru.pop_back();
+      }
+    };
+
+    shared_ptr<const SclkModel> model;
+    try {
+      model = build(sclkPaths, clockId, lskPath);
+    }
+    catch (invalid_argument &e) {
+      remember(nullptr, e.what());
+      throw;
+    }
+    remember(model, "");
+    return model;
+  }
+
+
+  shared_ptr<const SclkModel> SclkModel::build(const vector<string> &sclkPaths, int clockId, const string &lskPath) {
+    json pool = json::object();
+    for (const string &path : sclkPaths) {
+      pool.update(parseTextKernel(path));
+    }
+
+    // the clock's keywords are suffixed with the negated clock ID
+    string suffix = "_" + to_string(-clockId);
+
+    shared_ptr<SclkModel> model(new SclkModel());
+    model->m_clock_id = clockId;
+
+    int dataType = (int)getNumbers(pool, "SCLK_DATA_TYPE" + suffix, clockId).at(0);
+    if (dataType != 1) {
+      throw invalid_argument(fmt::format("SCLK data type [{}] for clock [{}] is not supported, only type 1 clocks can be evaluated natively.", dataType, clockId));
+    }
+
+    if (pool.contains("SCLK01_TIME_SYSTEM" + suffix)) {
+      model->m_time_system = (int)getNumbers(pool, "SCLK01_TIME_SYSTEM" + suffix, clockId).at(0);
+    }
+    if (model->m_time_system != 1 && model->m_time_system != 2) {
+      throw invalid_argument(fmt::format("SCLK time system [{}] for clock [{}] is not supported.", model->m_time_system, clockId));
+    }
+
+    if (pool.contains("SCLK01_OUTPUT_DELIM" + suffix)) {
+      static const string delimiters = ".:-, ";
+      int delim = (int)getNumbers(pool, "SCLK01_OUTPUT_DELIM" + suffix, clockId).at(0);
+      if (delim < 1 || delim > (int)delimiters.size()) {
+        throw invalid_argument(fmt::format("SCLK output delimiter code [{}] for clock [{}] is invalid.", delim, clockId));
+      }
+      model->m_delimiter = delimiters[delim-1];
+    }
+
+    size_t nFields = (size_t)getNumbers(pool, "SCLK01_N_FIELDS" + suffix, clockId).at(0);
+    model->m_moduli = getNumbers(pool, "SCLK01_MODULI" + suffix, clockId);
+    model->m_offsets = getNumbers(pool, "SCLK01_OFFSETS" + suffix, clockId);
+    if (nFields == 0 || model->m_moduli.size() != nFields || model->m_offsets.size() != nFields) {
+      throw invalid_argument(fmt::format("SCLK field definitions for clock [{}] are inconsistent.", clockId));
+    }
+
+    model->m_field_ticks.assign(nFields, 1);
+    for (size_t i = nFields - 1; i > 0; i--) {
+      model->m_field_ticks[i-1] = model->m_field_ticks[i] * model->m_moduli[i];
+    }
+
+    model->m_partition_starts = getNumbers(pool, "SCLK_PARTITION_START" + suffix, clockId);
+    model->m_partition_ends = getNumbers(pool, "SCLK_PARTITION_END" + suffix, clockId);
+    if (model->m_partition_starts.empty() || model->m_partition_starts.size() != model->m_partition_ends.size()) {
+      throw invalid_argument(fmt::format("SCLK partitions for clock [{}] are inconsistent.", clockId));
+    }
+
+    double partitionTicks = 0;
+    for (size_t i = 0; i < model->m_partition_starts.size(); i++) {
+      model->m_partition_ticks.push_back(partitionTicks);
+      partitionTicks += model->m_partition_ends[i] - model->m_partition_starts[i];
+    }
+    model->m_partition_ticks.push_back(partitionTicks);
+
+    vector<double> coefficients = getNumbers(pool, "SCLK01_COEFFICIENTS" + suffix, clockId);
+    if (coefficients.empty() || coefficients.size() % 3 != 0) {
+      throw invalid_argument(fmt::format("SCLK coefficients for clock [{}] are not a list of triplets.", clockId));
+    }
+    for (size_t i = 0; i < coefficients.size(); i += 3) {
+      model->m_coeff_ticks.push_back(coefficients[i]);
+      model->m_coeff_parallel.push_back(coefficients[i+1]);
+      model->m_coeff_rates.push_back(coefficients[i+2]);
+    }
+
+    if (!lskPath.empty()) {
+      json lsk = parseTextKernel(lskPath);
+      if (lsk.contains("DELTET/K")) {
+        model->m_k = getNumbers(lsk, "DELTET/K", clockId).at(0);
+      }
+      if (lsk.contains("DELTET/EB")) {
+        model->m_eb = getNumbers(lsk, "DELTET/EB", clockId).at(0);
+      }
+      if (lsk.contains("DELTET/M")) {
+        vector<double> m = getNumbers(lsk, "DELTET/M", clockId);
+        model->m_m0 = m.at(0);
+        model->m_m1 = m.at(1);
+      }
+    }
+
+    SPDLOG_DEBUG("Loaded SCLK model for clock {} with {} partitions and {} coefficient records", clockId, model->m_partition_starts.size(), model->m_coeff_ticks.size());
+    return model;
+  }
+
+
+  double SclkModel::parallelToEt(double parallel) const {
+    if (m_time_system == 1) {
+      return parallel;
+    }
+    // TDT to TDB, the periodic term is evaluated at TDT like UNITIM does
+    double m = m_m0 + m_m1 * parallel;
+    return parallel + m_k * sin(m + m_eb * sin(m));
+  }
+
+
+  double SclkModel::etToParallel(double et) const {
+    if (m_time_system == 1) {
+      return et;
+    }
+    // invert parallelToEt, the term changes by < 1e-9 s between iterations after two passes
+    double tdt = et;
+    for (int i = 0; i < 3; i++) {
+      double m = m_m0 + m_m1 * tdt;
+      tdt = et - m_k * sin(m + m_eb * sin(m));
+    }
+    return tdt;
+  }
+
+
+  double SclkModel::ticksToEt(double ticks) const {
+    if (ticks < 0 || ticks > m_partition_ticks.back()) {
+      throw range_error(fmt::format("SCLK ticks [{}] are outside of the partitions of clock [{}].", ticks, m_clock_id));
+    }
+    size_t i = lastAtOrBefore(m_coeff_ticks, ticks);
+    double parallel = m_coeff_parallel[i] + (ticks - m_coeff_ticks[i]) * m_coeff_rates[i] / m_field_ticks[0];
+    return parallelToEt(parallel);
+  }
+
+
+  double SclkModel::etToTicks(double et) const {
+    double parallel = etToParallel(et);
+    size_t i = lastAtOrBefore(m_coeff_parallel, parallel);
+    double ticks = m_coeff_ticks[i] + (parallel - m_coeff_parallel[i]) * m_field_ticks[0] / m_coeff_rates[i];
+    if (ticks < 0 || ticks > m_partition_ticks.back()) {
+      throw range_error(fmt::format("Ephemeris time [{}] is outside of the partitions of clock [{}].", et, m_clock_id));
+    }
+    return ticks;
+  }
+
+
+  void SclkModel::ticksToEt(const double *ticks, double *ets, size_t n) const {
+    for (size_t i = 0; i < n; i++) {
+      ets[i] = ticksToEt(ticks[i]);
+    }
+  }
+
+
+  void SclkModel::etToTicks(const double *ets, double *ticks, size_t n) const {
+    for (size_t i = 0; i < n; i++) {
+      ticks[i] = etToTicks(ets[i]);
+    }
+  }
+
+
+  double SclkModel::sclkToTicks(string sclk) const {
+    size_t partition = 1;
+    size_t slash = sclk.find('/');
+    if (slash != string::npos) {
+      try {
+        partition = stoul(sclk.substr(0, slash));
+      }
+      catch (exception &e) {
+        throw invalid_argument("Invalid SCLK partition in [" + sclk + "]");
+      }
+      sclk = sclk.substr(slash + 1);
+    }
+
+    if (partition < 1 || partition > m_partition_starts.size()) {
+      throw range_error(fmt::format("SCLK partition [{}] does not exist for clock [{}].", partition, m_clock_id));
+    }
+
+    // fields may be separated by any of the delimiters NAIF allows
+    for (char &c : sclk) {
+      if (c == '.' || c == ':' || c == '-' || c == ',') {
+        c = ' ';
+      }
+    }
+
+    stringstream stream(sclk);
+    vector<double> fields;
+    string field;
+    while (stream >> field) {
+      size_t consumed = 0;
+      double value;
+      try {
+        value = stod(field, &consumed);
+      }
+      catch (exception &e) {
+        consumed = 0;
+      }
+      if (consumed != field.size()) {
+        throw invalid_argument("Invalid SCLK field [" + field + "] in [" + sclk + "]");
+      }
+      fields.push_back(value);
+    }
+
+    if (fields.empty() || fields.size() > m_moduli.size()) {
+      throw invalid_argument(fmt::format("SCLK string [{}] does not match the {} fields of clock [{}].", sclk, m_moduli.size(), m_clock_id));
+    }
+
+    // missing trailing fields take their offsets
+    double count = 0;
+    for (size_t i = 0; i < fields.size(); i++) {
+      count += (fields[i] - m_offsets[i]) * m_field_ticks[i];
+    }
+
+    size_t p = partition - 1;
+    if (count < m_partition_starts[p] || count > m_partition_ends[p]) {
+      throw range_error(fmt::format("SCLK string [{}] is outside of partition [{}] of clock [{}].", sclk, partition, m_clock_id));
+    }
+    return m_partition_ticks[p] + (count - m_partition_starts[p]);
+  }
+
+
+  string SclkModel::ticksToSclk(double ticks) const {
+    ticks = round(ticks);
+    if (ticks < 0 || ticks > m_partition_ticks.back()) {
+      throw range_error(fmt::format("SCLK ticks [{}] are outside of the partitions of clock [{}].", ticks, m_clock_id));
+    }
+
+    // ticks on a boundary belong to the earlier partition, like scpart/scdecd
+    size_t p = 0;
+    while (p + 1 < m_partition_starts.size() && ticks > m_partition_ticks[p+1]) {
+      p++;
+    }
+
+    double count = m_partition_starts[p] + (ticks - m_partition_ticks[p]);
+
+    string sclk = to_string(p + 1) + "/";
+    for (size_t i = 0; i < m_moduli.size(); i++) {
+      double value = floor(count / m_field_ticks[i]);
+      count -= value * m_field_ticks[i];
+      value += m_offsets[i];
+
+      int width = countDigits(m_offsets[i] + m_moduli[i] - 1);
+      if (i > 0) {
+        sclk += m_delimiter;
+      }
+      sclk += fmt::format("{:0{}.0f}", value, width);
+    }
+    return sclk;
+  }
+
+
+  double SclkModel::sclkToEt(string sclk) const {
+    return ticksToEt(sclkToTicks(sclk));
+  }
+
+
+  string SclkModel::etToSclk(double et) const {
+    return ticksToSclk(etToTicks(et));
+  }
+
+
+  int SclkModel::getClockId() const {
+    return m_clock_id;
+  }
+}
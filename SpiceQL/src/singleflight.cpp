@@ -0,0 +1,243 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "SpiceQL/singleflight.h"
+#include "SpiceQL/spiceql_logging.h"
+#include "SpiceQL/utils.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace SpiceQL {
+
+  namespace {
+    // set while the thread computes a result, calls it makes are not coalesced
+    thread_local bool computing = false;
+
+    uint32_t rotateRight(uint32_t value, int bits) {
+      return (value >> bits) | (value << (32 - bits));
+    }
+
+    // SHA-256 (FIPS 180-4) as lowercase hex
+    string sha256(const string &message) {
+      static const array<uint32_t, 64> k = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+      };
+      array<uint32_t, 8> h = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+      // the message, a 1 bit, zeros up to 8 bytes short of a 64 byte block, then its length in bits
+      string padded = message;
+      padded.push_back(static_cast<char>(0x80));
+      while (padded.size() % 64 != 56) {
+        padded.push_back(0);
+      }
+      uint64_t bits = static_cast<uint64_t>(message.size()) * 8;
+      for (int shift = 56; shift >= 0; shift -= 8) {
+        padded.push_back(static_cast<char>((bits >> shift) & 0xff));
+      }
+
+      array<uint32_t, 64> w;
+      for (size_t block = 0; block < padded.size(); block += 64) {
+        for (int i = 0; i < 16; i++) {
+          const unsigned char *word = reinterpret_cast<const unsigned char *>(padded.data()) + block + i * 4;
+          w[i] = (uint32_t(word[0]) << 24) | (uint32_t(word[1]) << 16) | (uint32_t(word[2]) << 8) | uint32_t(word[3]);
+        }
+        for (int i = 16; i < 64; i++) {
+          uint32_t s0 = rotateRight(w[i-15], 7) ^ rotateRight(w[i-15], 18) ^ (w[i-15] >> 3);
+          uint32_t s1 = rotateRight(w[i-2], 17) ^ rotateRight(w[i-2], 19) ^ (w[i-2] >> 10);
+          w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int i = 0; i < 64; i++) {
+          uint32_t t1 = hh + (rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+          uint32_t t2 = (rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+          hh = g;
+          g = f;
+          f = e;
+          e = d + t1;
+          d = c;
+          c = b;
+          b = a;
+          a = t1 + t2;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+      }
+
+      static const char *digits = "0123456789abcdef";
+      string hex;
+      hex.reserve(64);
+      for (uint32_t word : h) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+          hex.push_back(digits[(word >> shift) & 0xf]);
+        }
+      }
+      return hex;
+    }
+
+    any compute(const function<any()> &fn) {
+      bool wasComputing = computing;
+      computing = true;
+      try {
+        any result = fn();
+        computing = wasComputing;
+        return result;
+      }
+      catch (...) {
+        computing = wasComputing;
+        throw;
+      }
+    }
+  }
+
+
+  SingleFlight::SingleFlight(bool enabled, chrono::milliseconds maxWait, size_t maxTrackedKeys)
+      : m_enabled(enabled), m_maxWait(maxWait), m_maxTrackedKeys(maxTrackedKeys) { }
+
+
+  SingleFlight &SingleFlight::instance() {
+    static SingleFlight flights([] {
+      char *rawEnabled = std::getenv("SPICEQL_SINGLE_FLIGHT");
+      bool enabled = rawEnabled != nullptr && toLower(string(rawEnabled)) == "true";
+
+      long maxWait = 30000;
+      char *rawWait = std::getenv("SPICEQL_SINGLE_FLIGHT_WAIT_MS");
+      if (rawWait != nullptr) {
+        try {
+          maxWait = max(stol(string(rawWait)), 0L);
+        }
+        catch (exception &e) {
+          SPDLOG_WARN("Ignoring SPICEQL_SINGLE_FLIGHT_WAIT_MS={}, it is not an integer", rawWait);
+        }
+      }
+
+      if (enabled) {
+        SPDLOG_DEBUG("Coalescing identical concurrent calls, waiting up to {}ms", maxWait);
+      }
+      return SingleFlight(enabled, chrono::milliseconds(maxWait));
+    }());
+    return flights;
+  }
+
+
+  string SingleFlight::makeKey(const string &functionName, const json &args) {
+    return functionName + "?" + sha256(args.dump());
+  }
+
+
+  void SingleFlight::setEnabled(bool enabled) {
+    m_enabled = enabled;
+  }
+
+
+  bool SingleFlight::shouldCoalesce() const {
+    return m_enabled && !computing;
+  }
+
+
+  any SingleFlight::runAny(const string &key, const function<any()> &fn) {
+    if (!shouldCoalesce()) {
+      return compute(fn);
+    }
+
+    promise<any> leader;
+    shared_future<any> flight;
+    bool leading = false;
+    {
+      lock_guard<mutex> lock(m_mutex);
+      auto it = m_inFlight.find(key);
+      if (it == m_inFlight.end()) {
+        flight = leader.get_future().share();
+        m_inFlight.emplace(key, flight);
+        leading = true;
+      }
+      else {
+        flight = it->second;
+      }
+    }
+
+    if (!leading) {
+      if (flight.wait_for(m_maxWait) == future_status::ready) {
+        count(key, &Stats::shared);
+        SPDLOG_TRACE("Shared the result of a call in flight for {}", key);
+        // rethrows what the computing call threw
+        return flight.get();
+      }
+      count(key, &Stats::timedOut);
+      SPDLOG_DEBUG("Waited {}ms for the call in flight for {}, running it", m_maxWait.count(), key);
+      return compute(fn);
+    }
+
+    count(key, &Stats::computed);
+    auto land = [&]() {
+      lock_guard<mutex> lock(m_mutex);
+      m_inFlight.erase(key);
+    };
+    try {
+      any result = compute(fn);
+      land();
+      leader.set_value(result);
+      return result;
+    }
+    catch (...) {
+      land();
+      leader.set_exception(current_exception());
+      throw;
+    }
+  }
+
+
+  void SingleFlight::count(const string &key, uint64_t Stats::*counter) {
+    lock_guard<mutex> lock(m_mutex);
+    m_total.*counter += 1;
+
+    auto it = m_stats.find(key);
+    if (it == m_stats.end()) {
+      if (m_stats.size() >= m_maxTrackedKeys) {
+        return;
+      }
+      it = m_stats.emplace(key, Stats()).first;
+    }
+    it->second.*counter += 1;
+  }
+
+
+  SingleFlight::Stats SingleFlight::stats(const string &key) {
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_stats.find(key);
+    return it == m_stats.end() ? Stats() : it->second;
+  }
+
+
+  SingleFlight::Stats SingleFlight::totalStats() {
+    lock_guard<mutex> lock(m_mutex);
+    return m_total;
+  }
+
+
+  map<string, SingleFlight::Stats> SingleFlight::allStats() {
+    lock_guard<mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+
+  void SingleFlight::resetStats() {
+    lock_guard<mutex> lock(m_mutex);
+    m_stats.clear();
+    m_total = Stats();
+  }
+}
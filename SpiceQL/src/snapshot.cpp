@@ -0,0 +1,97 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include "SpiceQL/snapshot.h"
+
+using namespace std;
+
+namespace SpiceQL {
+
+  namespace {
+    // A thread's announced epoch, 0 while it is not reading. Slots are never
+    // freed, a thread that exits leaves its slot to the next new thread.
+    struct ReaderSlot {
+      atomic<unsigned long long> epoch{0};
+      atomic<bool> used{true};
+      ReaderSlot *next = nullptr;
+    };
+
+    // leaked so guards still work while statics are destroyed
+    atomic<unsigned long long> &currentEpoch() {
+      static atomic<unsigned long long> *epoch = new atomic<unsigned long long>(1);
+      return *epoch;
+    }
+
+    atomic<ReaderSlot *> &slots() {
+      static atomic<ReaderSlot *> *head = new atomic<ReaderSlot *>(nullptr);
+      return *head;
+    }
+
+    ReaderSlot *acquireSlot() {
+      for (ReaderSlot *slot = slots().load(memory_order_acquire); slot; slot = slot->next) {
+        bool used = false;
+        if (!slot->used.load(memory_order_relaxed) && slot->used.compare_exchange_strong(used, true)) {
+          return slot;
+        }
+      }
+
+      ReaderSlot *slot = new ReaderSlot();
+      slot->next = slots().load(memory_order_relaxed);
+      while (!slots().compare_exchange_weak(slot->next, slot, memory_order_release, memory_order_relaxed)) {}
+      return slot;
+    }
+
+    struct ThreadReader {
+      ReaderSlot *slot = acquireSlot();
+      int depth = 0;
+
+      ~ThreadReader() {
+        slot->epoch.store(0, memory_order_release);
+        slot->used.store(false, memory_order_release);
+      }
+    };
+
+    ThreadReader &threadReader() {
+      thread_local ThreadReader reader;
+      return reader;
+    }
+  }
+
+
+  SnapshotReadGuard::SnapshotReadGuard() {
+    ThreadReader &reader = threadReader();
+    if (reader.depth++ == 0) {
+      // sequentially consistent, so a writer either sees the epoch or this
+      // thread loads the value the writer published
+      reader.slot->epoch.store(currentEpoch().load(memory_order_seq_cst), memory_order_seq_cst);
+    }
+  }
+
+
+  SnapshotReadGuard::~SnapshotReadGuard() {
+    ThreadReader &reader = threadReader();
+    if (--reader.depth == 0) {
+      reader.slot->epoch.store(0, memory_order_release);
+    }
+  }
+
+
+  unsigned long long retireSnapshotEpoch() {
+    return currentEpoch().fetch_add(1, memory_order_seq_cst) + 1;
+  }
+
+
+  unsigned long long oldestSnapshotEpoch() {
+    unsigned long long oldest = currentEpoch().load(memory_order_seq_cst);
+    for (ReaderSlot *slot = slots().load(memory_order_acquire); slot; slot = slot->next) {
+      unsigned long long epoch = slot->epoch.load(memory_order_seq_cst);
+      if (epoch != 0) {
+        oldest = min(oldest, epoch);
+      }
+    }
+    return oldest;
+  }
+}
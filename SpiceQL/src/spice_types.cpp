@@ -19,6 +19,7 @@
 #include <SpiceQL/query.h>
 #include <SpiceQL/utils.h>
 #include <SpiceQL/config.h>
+#include <SpiceQL/executor.h>
 
 using namespace std;
 using json = nlohmann::json;
@@ -154,6 +155,7 @@ namespace SpiceQL {
 
 
   void load(string path, bool force_refurnsh) {
+    CspiceGuard cspice;
     SPDLOG_DEBUG("Furnishing {}, force refurnish? {}.", path, force_refurnsh); 
     checkNaifErrors();
     furnsh_c(path.c_str());
@@ -161,6 +163,7 @@ namespace SpiceQL {
   }
 
   void unload(string path) {
+    CspiceGuard cspice;
     SPDLOG_TRACE("Unloading kernel {}", path);
     checkNaifErrors();
     unload_c(path.c_str());
@@ -168,6 +171,7 @@ namespace SpiceQL {
   }
 
   vector<string> getLoadedKernels() {
+    CspiceGuard cspice;
     const SpiceInt FILESIZ = 256;
     const SpiceInt TYPESIZ = 32;
     const SpiceInt SOURCESIZ = 256;
@@ -199,6 +203,7 @@ namespace SpiceQL {
   }
 
   bool isLskLoaded() {
+    CspiceGuard cspice;
     SpiceBoolean found = SPICEFALSE;
     SpiceInt n = 0;
     SpiceChar type[2];
@@ -213,6 +218,7 @@ namespace SpiceQL {
   }
 
   void KernelSet::load(json kernels) { 
+    CspiceGuard cspice;
     SPDLOG_TRACE("Creating Kernelset: {}", kernels.dump());
     this->m_kernels.merge_patch(kernels);
     vector<string> iaks = {};
@@ -248,6 +254,7 @@ namespace SpiceQL {
 
 
   void KernelSet::unload() {
+    CspiceGuard cspice;
     for(auto p : m_loadedKernels) {
       delete p;
     }
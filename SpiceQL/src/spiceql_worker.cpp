@@ -0,0 +1,12 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include "SpiceQL/localengine.h"
+
+// a worker process of the local engine, started by LocalEngine
+int main(int argc, char **argv) {
+  return SpiceQL::LocalEngine::runWorker(argc, argv);
+}
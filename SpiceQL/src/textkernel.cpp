@@ -0,0 +1,568 @@
+/**
+ *
+ *
+ *
+ **/
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <ghc/fs_std.hpp>
+
+#include "SpiceQL/textkernel.h"
+#include "SpiceQL/spiceql_logging.h"
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace SpiceQL {
+
+  namespace {
+
+    /**
+     * Parse a single text kernel value token. Numbers may use Fortran "D"
+     * exponents; anything else (e.g. @dates) is kept as a string.
+     */
+    json parseTextKernelValue(string token) {
+      if (token.empty()) {
+        return token;
+      }
+
+      if (token[0] == '@') {
+        return token;
+      }
+
+      string number = token;
+      replace(number.begin(), number.end(), 'D', 'E');
+      replace(number.begin(), number.end(), 'd', 'e');
+
+      size_t consumed = 0;
+      try {
+        double value = stod(number, &consumed);
+        if (consumed == number.size()) {
+          return value;
+        }
+      }
+      catch (exception &e) { }
+
+      return token;
+    }
+
+
+    /**
+     * Read a quoted string starting at data[pos] == '\'', with '' as an escaped quote.
+     */
+    string readTextKernelString(const string &data, size_t &pos, string path) {
+      string value;
+      pos++;
+      while (pos < data.size()) {
+        if (data[pos] == '\'') {
+          if (pos + 1 < data.size() && data[pos+1] == '\'') {
+            value += '\'';
+            pos += 2;
+            continue;
+          }
+          pos++;
+          return value;
+        }
+        value += data[pos++];
+      }
+      throw runtime_error("Unterminated string in text kernel [" + path + "]");
+    }
+
+
+    /**
+     * Concatenate the contents of the \begindata sections of a text kernel.
+     */
+    string readTextKernelData(string path) {
+      ifstream file(path);
+      if (!file) {
+        throw runtime_error("Could not open text kernel [" + path + "]");
+      }
+
+      string data;
+      string line;
+      bool inData = false;
+      while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+          line.pop_back();
+        }
+
+        size_t first = line.find_first_not_of(" \t");
+        if (first != string::npos && line[first] == '\\') {
+          string marker = line.substr(first, line.find_first_of(" \t", first) - first);
+          if (marker == "\\begindata") {
+            inData = true;
+          }
+          else if (marker == "\\begintext") {
+            inData = false;
+          }
+          continue;
+        }
+
+        if (inData) {
+          data += line;
+          data += '\n';
+        }
+      }
+      return data;
+    }
+
+
+    /**
+     * True if the file starts with a DAF or DAS ID word, i.e. is a binary kernel.
+     */
+    bool isBinaryKernel(string path) {
+      ifstream file(path, ios::binary);
+      if (!file) {
+        throw runtime_error("Could not open kernel [" + path + "]");
+      }
+
+      char idWord[8] = {};
+      file.read(idWord, sizeof(idWord));
+      string id(idWord, file.gcount());
+      return id.rfind("DAF/", 0) == 0 || id.rfind("DAS/", 0) == 0 || id.rfind("NAIF/DA", 0) == 0;
+    }
+
+
+    /**
+     * Days from 2000-01-01 to a proleptic Gregorian date, month 1-12.
+     */
+    long long daysSince2000(long long year, long long month, long long day) {
+      year -= month <= 2;
+      long long era = (year >= 0 ? year : year - 399) / 400;
+      long long yoe = year - era * 400;
+      long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+      long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+      return era * 146097 + doe - 730425;
+    }
+
+
+    /**
+     * Read a whole, non-negative number, false if the field is anything else.
+     */
+    bool readDateField(const string &field, long long &value) {
+      if (field.empty() || field.size() > 9 || !all_of(field.begin(), field.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); })) {
+        return false;
+      }
+      value = stoll(field);
+      return true;
+    }
+
+
+    // keywords furnsh reads from a meta-kernel and deletes once its kernels are loaded
+    const vector<string> META_KERNEL_KEYWORDS = {"KERNELS_TO_LOAD", "PATH_SYMBOLS", "PATH_VALUES"};
+
+
+    /**
+     * String values of a keyword with '+' continued strings joined, as stpool_c reads them.
+     */
+    vector<string> joinContinuedStrings(const json &values) {
+      vector<string> joined;
+      bool continued = false;
+      for (const json &value : values) {
+        if (!value.is_string()) {
+          throw invalid_argument("Meta-kernel values must be strings, got " + value.dump());
+        }
+        string str = value.get<string>();
+        bool continues = !str.empty() && str.back() == '+';
+        if (continues) {
+          str.pop_back();
+        }
+        if (continued) {
+          joined.back() += str;
+        }
+        else {
+          joined.push_back(str);
+        }
+        continued = continues;
+      }
+      return joined;
+    }
+
+
+    /**
+     * The kernels a meta-kernel's pool variables list, with $symbols replaced by their paths.
+     */
+    vector<string> metaKernelPaths(const json &pool) {
+      vector<string> kernels = joinContinuedStrings(pool["KERNELS_TO_LOAD"]);
+      vector<string> symbols = pool.contains("PATH_SYMBOLS") ? joinContinuedStrings(pool["PATH_SYMBOLS"]) : vector<string>();
+      vector<string> values = pool.contains("PATH_VALUES") ? joinContinuedStrings(pool["PATH_VALUES"]) : vector<string>();
+      if (symbols.size() != values.size()) {
+        throw invalid_argument("Meta-kernel PATH_SYMBOLS and PATH_VALUES differ in length");
+      }
+
+      // longer symbols first, so $DATA is not replaced inside $DATA_DIR
+      vector<size_t> order(symbols.size());
+      for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+      }
+      sort(order.begin(), order.end(), [&](size_t a, size_t b) { return symbols[a].size() > symbols[b].size(); });
+
+      for (string &kernel : kernels) {
+        for (size_t i : order) {
+          string symbol = "$" + symbols[i];
+          for (size_t at = kernel.find(symbol); at != string::npos; at = kernel.find(symbol, at + values[i].size())) {
+            kernel.replace(at, symbol.size(), values[i]);
+          }
+        }
+      }
+      return kernels;
+    }
+  }
+
+
+  vector<TextKernelAssignment> parseTextKernelAssignments(string path) {
+    string data = readTextKernelData(path);
+    vector<TextKernelAssignment> assignments;
+
+    size_t pos = 0;
+    auto skipSpace = [&]() {
+      while (pos < data.size() && (isspace(static_cast<unsigned char>(data[pos])) || data[pos] == ',')) {
+        pos++;
+      }
+    };
+
+    while (true) {
+      skipSpace();
+      if (pos >= data.size()) {
+        break;
+      }
+
+      TextKernelAssignment assignment;
+      size_t nameStart = pos;
+      while (pos < data.size() && !isspace(static_cast<unsigned char>(data[pos])) && data[pos] != '='
+             && !(data[pos] == '+' && pos + 1 < data.size() && data[pos+1] == '=')) {
+        pos++;
+      }
+      assignment.name = data.substr(nameStart, pos - nameStart);
+
+      skipSpace();
+      if (pos < data.size() && data[pos] == '+') {
+        assignment.append = true;
+        pos++;
+      }
+      if (pos >= data.size() || data[pos] != '=') {
+        throw runtime_error("Expected an assignment to [" + assignment.name + "] in text kernel [" + path + "]");
+      }
+      pos++;
+      skipSpace();
+
+      json values = json::array();
+      auto readValue = [&]() {
+        if (data[pos] == '\'') {
+          values.push_back(readTextKernelString(data, pos, path));
+          return;
+        }
+        size_t valueStart = pos;
+        while (pos < data.size() && !isspace(static_cast<unsigned char>(data[pos])) && data[pos] != ',' && data[pos] != ')') {
+          pos++;
+        }
+        values.push_back(parseTextKernelValue(data.substr(valueStart, pos - valueStart)));
+      };
+
+      if (pos < data.size() && data[pos] == '(') {
+        pos++;
+        while (true) {
+          skipSpace();
+          if (pos >= data.size()) {
+            throw runtime_error("Unterminated value list for [" + assignment.name + "] in text kernel [" + path + "]");
+          }
+          if (data[pos] == ')') {
+            pos++;
+            break;
+          }
+          readValue();
+        }
+      }
+      else if (pos < data.size()) {
+        readValue();
+      }
+
+      assignment.values = move(values);
+      assignments.push_back(move(assignment));
+    }
+
+    return assignments;
+  }
+
+
+  json parseTextKernel(string path) {
+    json pool = json::object();
+    for (TextKernelAssignment &assignment : parseTextKernelAssignments(path)) {
+      if (assignment.append && pool.contains(assignment.name)) {
+        for (json &value : assignment.values) {
+          pool[assignment.name].push_back(value);
+        }
+      }
+      else {
+        pool[assignment.name] = move(assignment.values);
+      }
+    }
+    return pool;
+  }
+
+
+  shared_ptr<const vector<TextKernelAssignment>> loadTextKernel(string path) {
+    static mutex cacheMutex;
+    static unordered_map<string, pair<fs::file_time_type, shared_ptr<const vector<TextKernelAssignment>>>> cache;
+
+    if (!fs::exists(path)) {
+      throw invalid_argument("Kernel [" + path + "] does not exist");
+    }
+    fs::file_time_type writeTime = fs::last_write_time(path);
+
+    {
+      lock_guard<mutex> lock(cacheMutex);
+      auto it = cache.find(path);
+      if (it != cache.end() && it->second.first == writeTime) {
+        return it->second.second;
+      }
+    }
+
+    // parse outside of the lock so other kernels can be served meanwhile,
+    // binary kernels are cached as having no assignments
+    shared_ptr<const vector<TextKernelAssignment>> assignments;
+    if (isBinaryKernel(path)) {
+      assignments = make_shared<const vector<TextKernelAssignment>>();
+    }
+    else {
+      assignments = make_shared<const vector<TextKernelAssignment>>(parseTextKernelAssignments(path));
+      SPDLOG_TRACE("Parsed {} assignments from text kernel {}", assignments->size(), path);
+    }
+
+    lock_guard<mutex> lock(cacheMutex);
+    cache[path] = {writeTime, assignments};
+    return assignments;
+  }
+
+
+  bool matchesKeywordTemplate(const string &keytpl, const string &name) {
+    // iterative wildcard match, backtracking to the last '*' on a mismatch
+    size_t t = 0, n = 0;
+    size_t star = string::npos, starMatch = 0;
+    while (n < name.size()) {
+      if (t < keytpl.size() && (keytpl[t] == '%' || keytpl[t] == name[n])) {
+        t++;
+        n++;
+      }
+      else if (t < keytpl.size() && keytpl[t] == '*') {
+        star = t++;
+        starMatch = n;
+      }
+      else if (star != string::npos) {
+        t = star + 1;
+        n = ++starMatch;
+      }
+      else {
+        return false;
+      }
+    }
+    while (t < keytpl.size() && keytpl[t] == '*') {
+      t++;
+    }
+    return t == keytpl.size();
+  }
+
+
+  bool textKernelDateToSeconds(string date, double &seconds) {
+    if (!date.empty() && date[0] == '@') {
+      date = date.substr(1);
+    }
+    transform(date.begin(), date.end(), date.begin(), [](unsigned char c) { return toupper(c); });
+
+    // the date ends at a '/', ' ' or an ISO 'T' following a digit
+    size_t split = 0;
+    while (split < date.size() && date[split] != '/' && date[split] != ' '
+           && !(date[split] == 'T' && split > 0 && isdigit(static_cast<unsigned char>(date[split-1])))) {
+      split++;
+    }
+    string datePart = date.substr(0, split);
+    string timePart = split < date.size() ? date.substr(split + 1) : "";
+
+    vector<string> fields;
+    size_t start = 0;
+    while (true) {
+      size_t end = datePart.find('-', start);
+      fields.push_back(datePart.substr(start, end - start));
+      if (end == string::npos) {
+        break;
+      }
+      start = end + 1;
+    }
+
+    static const string months[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+    long long year, month, day, days;
+    if (fields.size() == 3) {
+      if (!readDateField(fields[0], year) || !readDateField(fields[2], day)) {
+        return false;
+      }
+      if (!readDateField(fields[1], month)) {
+        auto it = fields[1].size() >= 3 ? find(begin(months), end(months), fields[1].substr(0, 3)) : end(months);
+        if (it == end(months)) {
+          return false;
+        }
+        month = (it - begin(months)) + 1;
+      }
+      if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+      }
+      days = daysSince2000(year, month, day);
+    }
+    else if (fields.size() == 2) {
+      if (!readDateField(fields[0], year) || !readDateField(fields[1], day) || day < 1 || day > 366) {
+        return false;
+      }
+      days = daysSince2000(year, 1, 1) + day - 1;
+    }
+    else {
+      return false;
+    }
+
+    double timeOfDay = 0;
+    if (!timePart.empty()) {
+      double scale = 3600;
+      start = 0;
+      for (int field = 0; field < 3; field++) {
+        size_t end = timePart.find(':', start);
+        string value = timePart.substr(start, end - start);
+        if (value.empty() || !all_of(value.begin(), value.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)) || c == '.'; })) {
+          return false;
+        }
+        try {
+          timeOfDay += stod(value) * scale;
+        }
+        catch (exception &e) {
+          return false;
+        }
+        if (end == string::npos) {
+          break;
+        }
+        if (field == 2) {
+          return false;
+        }
+        start = end + 1;
+        scale /= 60;
+      }
+    }
+
+    // J2000 is noon on 2000-01-01
+    seconds = days * 86400.0 + timeOfDay - 43200.0;
+    return true;
+  }
+
+
+  json replayTextKernels(vector<string> kernelPaths, string keytpl) {
+    // replay the assignments in load order, the same way furnsh builds the pool
+    json pool = json::object();
+    vector<string> metaKernels;
+    function<void(const string &)> replay = [&](const string &path) {
+      shared_ptr<const vector<TextKernelAssignment>> assignments = loadTextKernel(path);
+      bool isMetaKernel = false;
+      for (const TextKernelAssignment &assignment : *assignments) {
+        bool metaKeyword = find(META_KERNEL_KEYWORDS.begin(), META_KERNEL_KEYWORDS.end(), assignment.name) != META_KERNEL_KEYWORDS.end();
+        isMetaKernel |= assignment.name == "KERNELS_TO_LOAD";
+        if (!metaKeyword && !matchesKeywordTemplate(keytpl, assignment.name)) {
+          continue;
+        }
+
+        // the pool holds @dates as seconds past J2000
+        json values = json::array();
+        for (const json &value : assignment.values) {
+          double seconds;
+          if (value.is_string() && value.get_ref<const string &>().rfind("@", 0) == 0
+              && textKernelDateToSeconds(value.get<string>(), seconds)) {
+            values.push_back(seconds);
+          }
+          else {
+            values.push_back(value);
+          }
+        }
+
+        json &current = pool[assignment.name];
+        if (assignment.append && current.is_array()) {
+          current.insert(current.end(), values.begin(), values.end());
+        }
+        else {
+          current = move(values);
+        }
+      }
+
+      // furnsh loads the kernels a meta-kernel lists, then deletes its keywords
+      if (!isMetaKernel) {
+        return;
+      }
+      if (find(metaKernels.begin(), metaKernels.end(), path) != metaKernels.end()) {
+        throw invalid_argument("Meta-kernel [" + path + "] loads itself");
+      }
+      vector<string> listed = metaKernelPaths(pool);
+      for (const string &keyword : META_KERNEL_KEYWORDS) {
+        pool.erase(keyword);
+      }
+      metaKernels.push_back(path);
+      for (const string &kernel : listed) {
+        replay(kernel);
+      }
+      metaKernels.pop_back();
+    };
+
+    for (const string &path : kernelPaths) {
+      replay(path);
+    }
+
+    for (auto it = pool.begin(); it != pool.end();) {
+      bool unmatched = !matchesKeywordTemplate(keytpl, it.key());
+      it = it->empty() || unmatched ? pool.erase(it) : next(it);
+    }
+    return pool;
+  }
+
+
+  json formatKeywordValues(const json &values) {
+    json formatted = json::array();
+    for (const json &value : values) {
+      if (!value.is_string()) {
+        formatted.push_back(value);
+        continue;
+      }
+
+      string str = value.get<string>();
+      string lower = str;
+      transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return tolower(c); });
+      // if null or boolean, do a conversion
+      if (lower == "true") {
+        formatted.push_back(true);
+      }
+      else if (lower == "false") {
+        formatted.push_back(false);
+      }
+      else if (lower == "null") {
+        formatted.push_back(nullptr);
+      }
+      else {
+        formatted.push_back(str);
+      }
+    }
+
+    if (formatted.size() == 1) {
+      return formatted[0];
+    }
+    return formatted;
+  }
+
+
+  json findTextKernelKeywords(string keytpl, vector<string> kernelPaths) {
+    json pool = replayTextKernels(kernelPaths, keytpl);
+    json results;
+    for (auto &[name, values] : pool.items()) {
+      results[name] = formatKeywordValues(values);
+    }
+    return results;
+  }
+}
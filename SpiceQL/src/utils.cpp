@@ -7,10 +7,13 @@
 #include <exception>
 #include <fstream>
 #include <regex>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstring>
 #include <float.h>
+#include <memory>
+#include <mutex>
 #ifdef _WIN32
 #include <process.h>  // _getpid
 #define getpid _getpid
@@ -40,6 +43,8 @@
 #include <SpiceQL/utils.h>
 #include <SpiceQL/inventory.h>
 #include <SpiceQL/alias_map.h>
+#include <SpiceQL/executor.h>
+#include <SpiceQL/snapshot.h>
 
 using json = nlohmann::json;
 using namespace std;
@@ -211,6 +216,7 @@ namespace SpiceQL {
 
 
   vector<double> getTargetState(double et, string target, string observer, string frame, string abcorr) {
+    CspiceGuard cspice;
     SPDLOG_TRACE("getTargetState(et={}, target={}, observer={}, frame={}, abcorr={})", et, target, observer, frame, abcorr);
 
     // convert params to spice types
@@ -265,6 +271,7 @@ namespace SpiceQL {
   }
 
   vector<double> getTargetOrientation(double et, int toFrame, int refFrame) {
+    CspiceGuard cspice;
     // Much of this function is from ISIS SpiceRotation.cpp
     SpiceDouble stateCJ[6][6];
     SpiceDouble CJ_spice[3][3];
@@ -318,131 +325,91 @@ namespace SpiceQL {
 
 
   // Given a string keyname template, search the kernel pool for matching keywords and their values
-  // returns json with up to ROOM=200 matching keynames:values
+  // names and values are read in pages, so there is no limit on how many are returned
   // if no keys are found, returns null
   json findKeywords(string keytpl) {
-    // Define gnpool i/o
-    const SpiceInt START = 0;
+    CspiceGuard cspice;
+    // Define gnpool/gXpool i/o, ROOM is the page size
     const SpiceInt ROOM = 200;
-    const SpiceInt LENOUT = 200;
+    const SpiceInt NAMELEN = 33;   // kernel pool names are at most 32 characters
+    const SpiceInt LENOUT = 1025;  // longest string value a text kernel line can hold, plus the null
     ConstSpiceChar *cstr = keytpl.c_str();
     SpiceInt nkeys;
-    SpiceChar kvals [ROOM][LENOUT];
     SpiceBoolean gnfound;
 
-    // Call gnpool to search for input key template
-    checkNaifErrors();
-    gnpool_c(cstr, START, ROOM, LENOUT, &nkeys, kvals, &gnfound);
+    // Call gnpool to search for input key template, one page at a time
+    vector<string> names;
+    vector<SpiceChar> kvals(ROOM * NAMELEN);
     checkNaifErrors();
+    do {
+      gnpool_c(cstr, (SpiceInt)names.size(), ROOM, NAMELEN, &nkeys, kvals.data(), &gnfound);
+      checkNaifErrors();
+      for (int i = 0; gnfound && i < nkeys; i++) {
+        names.emplace_back(&kvals[i * NAMELEN]);
+      }
+    } while (gnfound && nkeys == ROOM);
 
-    if(!gnfound) {
+    if (names.empty()) {
       return nullptr;
     }
 
-    // Call gXpool for each key found in gnpool
-    // accumulate results to json allResults
-
-    // Define gXpool params
-    ConstSpiceChar *fkey;
-    SpiceInt nvals;
-    SpiceChar cvals [ROOM][LENOUT];
-    SpiceDouble dvals[ROOM];
-    SpiceInt ivals[ROOM];
-    SpiceBoolean gcfound = false, gdfound = false, gifound = false;
-
-    json allResults;
-    
-    // iterate over kvals;
-    for(int i = 0; i < nkeys; i++) {
-      json jresultVal;
-
-      fkey = &kvals[i][0];
-
-      checkNaifErrors();
-      gdpool_c(fkey, START, ROOM, &nvals, dvals, &gdfound);
-      checkNaifErrors();
-
-      if (gdfound) {
-        // format output
-        if (nvals == 1) {
-          jresultVal = dvals[0];
-        }
-        else {
-          for(int j=0; j<nvals; j++) {
-            jresultVal.push_back(dvals[j]);
-          }
-        }
+    // if null or boolean, do a conversion
+    auto convert = [](string str_cval) -> json {
+      string lower = toLower(str_cval);
+      if (lower == "true") {
+        return true;
       }
-
-      if (!gdfound) {
-        gipool_c(fkey, START, ROOM, &nvals, ivals, &gifound);
-        checkNaifErrors();
+      else if (lower == "false") {
+        return false;
       }
-
-      if (gifound) {
-        // format output
-        if (nvals == 1) {
-          jresultVal = ivals[0];
-        }
-        else {
-          for(int j=0; j<nvals; j++) {
-            jresultVal.push_back(ivals[j]);
-          }
-        }
+      else if (lower == "null") {
+        return nullptr;
       }
+      return str_cval;
+    };
 
-      if (!gifound || !gdfound) {
-        gcpool_c(fkey, START, ROOM, LENOUT, &nvals, cvals, &gcfound);
-        checkNaifErrors();
-      }
+    json allResults;
 
-      if (gcfound) {
-        // format gcpool output
-        string str_cval;
-        if (nvals == 1) {
-          str_cval.assign(&cvals[0][0]);
-          string lower = toLower(str_cval);
+    vector<SpiceDouble> dvals(ROOM);
+    vector<SpiceChar> cvals(ROOM * LENOUT);
+    for (const string &fkey : names) {
+      SpiceBoolean found;
+      SpiceInt size;
+      SpiceChar type;
+      dtpool_c(fkey.c_str(), &found, &size, &type);
+      checkNaifErrors();
+      if (!found) {
+        continue;
+      }
 
-          // if null or boolean, do a conversion
-          if (lower == "true") {
-            jresultVal = true;
-          }
-          else if (lower == "false") {
-            jresultVal = false;
-          }
-          else if (lower == "null") {
-            jresultVal = nullptr;
-          }
-          else {
-            jresultVal = str_cval;
+      // read the values of key in pages of ROOM
+      json values = json::array();
+      SpiceInt nvals;
+      SpiceBoolean gfound;
+      while ((SpiceInt)values.size() < size) {
+        SpiceInt start = (SpiceInt)values.size();
+        if (type == 'N') {
+          gdpool_c(fkey.c_str(), start, ROOM, &nvals, dvals.data(), &gfound);
+          checkNaifErrors();
+          for (int j = 0; gfound && j < nvals; j++) {
+            values.push_back(dvals[j]);
           }
         }
         else {
-          for(int j=0; j<nvals; j++) {
-            str_cval.assign(&cvals[j][0]);
-            string lower = toLower(str_cval);
-
-            // if null or boolean, do a conversion
-            if (lower == "true") {
-              jresultVal.push_back(true);
-            }
-            else if (lower == "false") {
-              jresultVal.push_back(false);
-            }
-            else if (lower == "null") {
-              jresultVal.push_back(nullptr);
-            }
-            else {
-              jresultVal.push_back(str_cval);
-            }
+          gcpool_c(fkey.c_str(), start, ROOM, LENOUT, &nvals, cvals.data(), &gfound);
+          checkNaifErrors();
+          for (int j = 0; gfound && j < nvals; j++) {
+            values.push_back(convert(string(&cvals[j * LENOUT])));
           }
         }
+        if (!gfound || nvals == 0) {
+          break;
+        }
       }
 
       // append to allResults:
-      //     key:list-of-values
-      string resultKey(fkey);
-      allResults[resultKey] = jresultVal;
+      //     key:value or key:list-of-values
+      allResults[fkey] = values.size() == 1 ? values[0] : values;
     }
 
     return allResults;
@@ -723,6 +690,17 @@ namespace SpiceQL {
 
 
   vector<pair<double, double>> getTimeIntervals(string kpath) {
+    vector<pair<double, double>> result;
+    for (auto &[body, times] : getBodyTimeIntervals(kpath)) {
+      result.reserve(result.size() + times.size());
+      result.insert(result.end(), times.begin(), times.end());
+    }
+    return result;
+  }
+
+
+  map<int, vector<pair<double, double>>> getBodyTimeIntervals(string kpath) {
+    CspiceGuard cspice;
     auto formatIntervals = [&](SpiceCell &coverage) -> vector<pair<double, double>> {
       //Get the number of intervals in the object.
       checkNaifErrors();
@@ -758,14 +736,14 @@ namespace SpiceQL {
     string currFile = fileType;
 
     //create a spice cell capable of containing all the objects in the kernel.
-    SPICEINT_CELL(currCell, 200000);
+    SPICEINT_CELL(currCell, 300000);
 
     //this resizing is done because otherwise a spice cell will append new data
     //to the last "currCell"
     ssize_c(0, &currCell);
-    ssize_c(200000, &currCell);
+    ssize_c(300000, &currCell);
 
-    SPICEDOUBLE_CELL(cover, 200000);
+    SPICEDOUBLE_CELL(cover, 300000);
 
     if (currFile == "SPK") {
       spkobj_c(kpath.c_str(), &currCell);
@@ -778,7 +756,7 @@ namespace SpiceQL {
     }
     checkNaifErrors();
 
-    vector<pair<double, double>> result;
+    map<int, vector<pair<double, double>>> result;
 
     for(int bodyCount = 0 ; bodyCount < card_c(&currCell) ; bodyCount++) {
       //get the NAIF body code
@@ -792,17 +770,18 @@ namespace SpiceQL {
         vector<pair<double, double>> times;
         //find the correct coverage window
         if(currFile == "SPK") {
-          SPICEDOUBLE_CELL(cover, 200000);
+          SPICEDOUBLE_CELL(cover, 300000);
           ssize_c(0, &cover);
-          ssize_c(200000, &cover);
+          ssize_c(300000, &cover);
           spkcov_c(kpath.c_str(), body, &cover);
           times = formatIntervals(cover);
         }
         else if(currFile == "CK") {
-          //  200,000 is the max coverage window size for a CK kernel
-          SPICEDOUBLE_CELL(cover, 200000);
+          // room for 150,000 coverage windows, two doubles each, the same as
+          // getKernelStartStopTimes since the DB stores both for every kernel
+          SPICEDOUBLE_CELL(cover, 300000);
           ssize_c(0, &cover);
-          ssize_c(200000, &cover);
+          ssize_c(300000, &cover);
 
           // A SPICE SEGMENT is composed of SPICE INTERVALS
           ckcov_c(kpath.c_str(), body, SPICEFALSE, "SEGMENT", 0.0, "TDB", &cover);
@@ -811,16 +790,34 @@ namespace SpiceQL {
         }
         checkNaifErrors();
 
-        result.reserve(result.size() + distance(times.begin(), times.end()));
-        result.insert(result.end(), times.begin(), times.end());
-
+        result[body] = times;
       }
     }
     return result;
   }
 
 
+  vector<pair<double, double>> mergeTimeIntervals(vector<pair<double, double>> intervals) {
+    intervals.erase(remove_if(intervals.begin(), intervals.end(),
+                              [](const pair<double, double> &p) { return p.first > p.second; }),
+                    intervals.end());
+    sort(intervals.begin(), intervals.end());
+
+    vector<pair<double, double>> merged;
+    for (auto &interval : intervals) {
+      if (!merged.empty() && interval.first <= merged.back().second) {
+        merged.back().second = max(merged.back().second, interval.second);
+      }
+      else {
+        merged.push_back(interval);
+      }
+    }
+    return merged;
+  }
+
+
   pair<double, double> getKernelStartStopTimes(string kpath) {
+    CspiceGuard cspice;
     SPDLOG_TRACE("getKernelStartStopTimes({})", kpath);
 
     double start_time = 0;
@@ -905,7 +902,7 @@ namespace SpiceQL {
           getStartStopFromInterval(cover);
         }
         else if(currFile == "CK") {
-          //  200,000 is the max coverage window size for a CK kernel
+          // room for 150,000 coverage windows, two doubles each
           SPICEDOUBLE_CELL(cover, 300000);
           ssize_c(0, &cover);
           ssize_c(300000, &cover);
@@ -930,6 +927,8 @@ namespace SpiceQL {
     conf = conf[mission];
     json new_json = {};
     json sclk_json = getLatestKernels(conf.get("sclk"));
+    // the SCLKs have to stay furnished until every kernel's times are read
+    CspiceGuard cspice;
     KernelSet sclks(sclk_json);
 
     // Get CK Times
@@ -968,6 +967,8 @@ namespace SpiceQL {
     conf = conf[mission];
     json new_json = {};
     json sclk_json = getLatestKernels(conf.get("sclk"));
+    // the SCLKs have to stay furnished until every kernel's times are read
+    CspiceGuard cspice;
     KernelSet sclks(sclk_json);
 
     // Get CK Times
@@ -1124,6 +1125,63 @@ namespace SpiceQL {
   }
 
 
+  int getRestMaxConnections() {
+    char* rawEnv = std::getenv("SPICEQL_REST_MAX_CONNECTIONS");
+    int maxConnections = 8;
+
+    if (rawEnv != nullptr) {
+      try {
+        maxConnections = stoi(string(rawEnv));
+      }
+      catch (exception &e) {
+        SPDLOG_WARN("Ignoring SPICEQL_REST_MAX_CONNECTIONS={}, it is not an integer", rawEnv);
+      }
+    }
+
+    return max(maxConnections, 1);
+  }
+
+
+  vector<vector<double>> splitEtBatches(const vector<double> &ets, size_t minBatchSize, size_t maxBatches) {
+    minBatchSize = max<size_t>(minBatchSize, 1);
+    maxBatches = max<size_t>(maxBatches, 1);
+
+    size_t batchSize = max(minBatchSize, (ets.size() + maxBatches - 1) / maxBatches);
+    vector<vector<double>> batches;
+    for (size_t start = 0; start < ets.size(); start += batchSize) {
+      size_t stop = min(start + batchSize, ets.size());
+      batches.emplace_back(ets.begin() + start, ets.begin() + stop);
+    }
+    return batches;
+  }
+
+
+  void mergeBatchKernels(json &kernels, json batchKernels) {
+    if (!kernels.is_object() || !batchKernels.is_object()) {
+      merge_json(kernels, batchKernels);
+      return;
+    }
+
+    // merge_json replaces nested objects, so join the gap lists first
+    for (auto it = batchKernels.begin(); it != batchKernels.end();) {
+      const json &gaps = it.value().is_object() ? it.value().value("gaps", json()) : json();
+      if (!gaps.is_array() || !kernels.contains(it.key()) || !kernels[it.key()].is_object()) {
+        ++it;
+        continue;
+      }
+
+      json &coverage = kernels[it.key()];
+      vector<pair<double, double>> joined = coverage.value("gaps", json::array()).get<vector<pair<double, double>>>();
+      for (const auto &gap : gaps.get<vector<pair<double, double>>>()) {
+        joined.push_back(gap);
+      }
+      coverage["gaps"] = mergeTimeIntervals(joined);
+      it = batchKernels.erase(it);
+    }
+    merge_json(kernels, batchKernels);
+  }
+
+
   void resolveConfigDependencies(json &config, const json &dependencies) {
     SPDLOG_TRACE("IN resolveConfigDependencies");
     vector<json::json_pointer> depLists = findKeyInJson(config, "deps");
@@ -1170,6 +1228,7 @@ namespace SpiceQL {
 
 
   string getKernelType(string kernelPath) {
+    CspiceGuard cspice;
     SpiceChar type[6];
     SpiceChar source[6];
     SpiceInt handle;
@@ -1210,15 +1269,15 @@ namespace SpiceQL {
 
 
   bool checkNaifErrors(bool reset) {
-    static bool initialized = false; 
+    CspiceGuard cspice;
+    static once_flag initialized;
 
-    if(!initialized) {
+    call_once(initialized, []() {
       SpiceChar returnAct[32] = "RETURN";
       SpiceChar printAct[32] = "NONE";
       erract_c("SET", sizeof(returnAct), returnAct);   // Reset action to return
       errprt_c("SET", sizeof(printAct), printAct);     // ... and print nothing
-      initialized = true;
-    }
+    });
     
     if(!failed_c()) return true;
 
@@ -1342,6 +1401,7 @@ namespace SpiceQL {
 
 
   static string codeToNameNoKernels(int code) {
+    CspiceGuard cspice;
     SPDLOG_DEBUG("Resolving code {} to name without furnishing kernels", code);
     string name = Inventory::getFrameNameFromCache(code);
     SPDLOG_DEBUG("Resolved code {} to name '{}' from cache", code, name);
@@ -1358,6 +1418,57 @@ namespace SpiceQL {
   }
 
 
+  namespace {
+    // NAIF code -> mission, derived from the frame cache and the alias map and
+    // stamped with the generations of both so it is rebuilt when either changes.
+    struct MissionCodeTable {
+      unsigned long long frames = 0;
+      unsigned long long aliases = 0;
+      unordered_map<int, string> missions;
+    };
+
+    // Readers only load g_mission_codes inside a SnapshotReadGuard. Rebuilds
+    // are serialized by the mutex, and a replaced table is freed by a later
+    // rebuild once no reader can still hold it.
+    Snapshot<MissionCodeTable> g_mission_codes;
+    std::mutex g_mission_codes_mutex;
+
+    // valid while the caller holds a SnapshotReadGuard
+    const MissionCodeTable *missionCodeTable() {
+      unsigned long long frames = Inventory::getFrameCacheGeneration();
+      unsigned long long aliases = AliasMap::instance().getGeneration();
+      const MissionCodeTable *table = g_mission_codes.load();
+      if (table && table->frames == frames && table->aliases == aliases) {
+        return table;
+      }
+
+      std::lock_guard<std::mutex> lock(g_mission_codes_mutex);
+      table = g_mission_codes.load();
+      if (table && table->frames == frames && table->aliases == aliases) {
+        return table;
+      }
+
+      auto rebuilt = make_unique<MissionCodeTable>();
+      rebuilt->frames = frames;
+      // Resolving names can itself replace the alias map (the first miss loads
+      // its frame list), so rebuild until the alias generation holds still.
+      do {
+        rebuilt->aliases = AliasMap::instance().getGeneration();
+        rebuilt->missions.clear();
+        for (const auto &[code, name] : Inventory::getFrameCodeNamesFromCache()) {
+          string m = AliasMap::instance().getSpiceqlName(name);
+          if (!m.empty()) {
+            rebuilt->missions.emplace(code, m);
+          }
+        }
+      } while (rebuilt->aliases != AliasMap::instance().getGeneration());
+      SPDLOG_DEBUG("Indexed {} NAIF codes to missions", rebuilt->missions.size());
+
+      return g_mission_codes.publish(std::move(rebuilt));
+    }
+  }
+
+
   string inferMission(const vector<string>& nameCandidates,
                       const vector<int>& codeCandidates) {
     SPDLOG_DEBUG("Inferring mission from name candidates: [{}] and code candidates: [{}]",
@@ -1370,10 +1481,21 @@ namespace SpiceQL {
         return m;
       }
     }
+
+    SnapshotReadGuard guard;
+    const MissionCodeTable *table = codeCandidates.empty() ? nullptr : missionCodeTable();
     for (int code : codeCandidates) {
       if (code == 0) continue;
       int bus = (std::abs(code) / 1000 != 0) ? code / 1000 : code;
       for (int c : {code, bus}) {
+        auto it = table->missions.find(c);
+        if (it != table->missions.end()) {
+          SPDLOG_DEBUG("Found mission {} from code candidate {}", it->second, code);
+          return it->second;
+        }
+
+        // Codes that are not in the frame cache, e.g. NAIF's built-in bodies
+        if (!Inventory::getFrameNameFromCache(c).empty()) continue;
         string name = codeToNameNoKernels(c);
         if (!name.empty()) {
           string m = AliasMap::instance().getSpiceqlName(name);
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
 
+#include <atomic>
+#include <thread>
+
 #include "Fixtures.h"
 #include <SpiceQL/alias_map.h>
 
@@ -30,6 +33,76 @@ TEST_F(AliasMapTest, CaseInsensitiveFrameListFallback) {
 	EXPECT_EQ(aliasMap.getSpiceqlName("lro"), "lro");
 }
 
+TEST_F(AliasMapTest, AliasesTakePrecedenceOverFrameList) {
+	load_aliases(testAliasMapFile.string());
+	EXPECT_EQ(aliasMap.getSpiceqlName("lro"), "lro");
+
+	aliasMap.addAliasKey("lro", "test_mission");
+	EXPECT_EQ(aliasMap.getSpiceqlName("LRO"), "test_mission");
+	// repeated misses keep answering from the same frame list
+	EXPECT_EQ(aliasMap.getSpiceqlName("bad_alias"), "");
+	EXPECT_EQ(aliasMap.getSpiceqlName("bad_alias"), "");
+	EXPECT_EQ(aliasMap.getSpiceqlName("mro"), "mro");
+}
+
+TEST_F(AliasMapTest, ConcurrentLookupsDuringUpdates) {
+	load_aliases(testAliasMapFile.string());
+
+	std::atomic<int> mismatches{0};
+	std::vector<std::thread> readers;
+	for (int t = 0; t < 4; t++) {
+		readers.emplace_back([&]() {
+			for (int i = 0; i < 1000; i++) {
+				if (aliasMap.getSpiceqlName("fake") != "test_mission") {
+					mismatches++;
+				}
+			}
+		});
+	}
+	for (int i = 0; i < 50; i++) {
+		aliasMap.addAliasKey("alias" + std::to_string(i), "test_mission");
+	}
+	for (auto &reader : readers) {
+		reader.join();
+	}
+
+	EXPECT_EQ(mismatches, 0);
+	EXPECT_EQ(aliasMap.getSpiceqlName("ALIAS49"), "test_mission");
+}
+
+TEST(SnapshotTests, UnitTestReplacedValuesAreFreed) {
+	struct Counted {
+		std::atomic<int> *alive;
+		explicit Counted(std::atomic<int> *alive) : alive(alive) { (*alive)++; }
+		~Counted() { (*alive)--; }
+	};
+
+	std::atomic<int> alive{0};
+	{
+		Snapshot<Counted> snapshot;
+		snapshot.publish(std::make_unique<Counted>(&alive));
+
+		// a reader keeps what it may have loaded alive
+		const Counted *held;
+		{
+			SnapshotReadGuard guard;
+			held = snapshot.load();
+			snapshot.publish(std::make_unique<Counted>(&alive));
+			EXPECT_EQ(alive, 2);
+			EXPECT_EQ(snapshot.retiredCount(), 1);
+			EXPECT_EQ(held->alive, &alive);
+		}
+
+		// and once it is done the next update frees it
+		for (int i = 0; i < 100; i++) {
+			snapshot.publish(std::make_unique<Counted>(&alive));
+		}
+		EXPECT_EQ(alive, 1);
+		EXPECT_EQ(snapshot.retiredCount(), 0);
+	}
+	EXPECT_EQ(alive, 0);
+}
+
 TEST_F(AliasMapTest, InvalidAlias) {
 	// Test error handling for missing alias
 	load_aliases(testAliasMapFile.string());
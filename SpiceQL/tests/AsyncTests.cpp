@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Fixtures.h"
+#include <SpiceQL/api.h>
+#include <SpiceQL/api_async.h>
+#include <SpiceQL/executor.h>
+#include <SpiceQL/inventoryimpl.h>
+#include <SpiceQL/memo.h>
+
+using namespace std;
+using namespace SpiceQL;
+
+TEST(AsyncTests, UnitTestTaskQueue) {
+  TaskQueue queue(1, "test queue");
+  EXPECT_EQ(queue.threadCount(), 1);
+  EXPECT_FALSE(queue.onQueueThread());
+
+  // one thread runs tasks in submission order
+  vector<int> order;
+  vector<future<void>> done;
+  for (int i = 0; i < 100; i++) {
+    done.push_back(queue.submit([&order, i]() { order.push_back(i); }));
+  }
+  for (auto &d : done) {
+    d.get();
+  }
+  ASSERT_EQ(order.size(), 100);
+  EXPECT_TRUE(is_sorted(order.begin(), order.end()));
+
+  future<int> failed = queue.submit([]() -> int { throw invalid_argument("bad task"); });
+  EXPECT_THROW(failed.get(), invalid_argument);
+
+  // run() from a task of the same queue does not wait on itself
+  int nested = queue.run([&queue]() {
+    EXPECT_TRUE(queue.onQueueThread());
+    return queue.run([]() { return 42; });
+  });
+  EXPECT_EQ(nested, 42);
+
+  EXPECT_GE(workerPool().threadCount(), 2);
+}
+
+
+TEST(AsyncTests, UnitTestCspiceGuard) {
+  atomic<int> holders = 0;
+  atomic<int> maxHolders = 0;
+
+  vector<thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 50; j++) {
+        CspiceGuard outer;
+        // nested guards on the same thread do not wait on themselves
+        CspiceGuard inner;
+        int now = ++holders;
+        maxHolders = max(maxHolders.load(), now);
+        this_thread::yield();
+        holders--;
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(maxHolders, 1);
+}
+
+
+TEST(AsyncTests, UnitTestCacheDirectoriesFromThreads) {
+  vector<string> cacheDirs(8);
+  vector<string> memoDirs(8);
+  vector<thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&, i]() {
+      cacheDirs[i] = getHdfFile();
+      memoDirs[i] = Memo::getCacheDir();
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(count(cacheDirs.begin(), cacheDirs.end(), cacheDirs[0]), 8);
+  EXPECT_EQ(count(memoDirs.begin(), memoDirs.end(), memoDirs[0]), 8);
+}
+
+
+TEST_F(LroKernelSet, UnitTestAsyncApi) {
+  vector<double> ets = {110000000, 110000001};
+  auto states = getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+  auto ets2 = strSclkToEtBatch(-85, {"1/281199081:48971", "1/281199081:48971"}, "lro");
+  // the second string goes to str2et under a CspiceGuard from a worker thread
+  vector<string> utcs = {"2016-12-31T23:59:60", "86 JAN 18 12:19:52"};
+  auto utcEts = utcToEtBatch(utcs, false, true);
+
+  // issue queries from several host threads at once, CSPICE work is serialized for them
+  vector<thread> hosts;
+  for (int i = 0; i < 4; i++) {
+    hosts.emplace_back([&]() {
+      auto statesFuture = getTargetStatesAsync(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+      auto sclkFuture = strSclkToEtBatchAsync(-85, {"1/281199081:48971", "1/281199081:48971"}, "lro");
+      auto searchFuture = searchForKernelsetsAsync({"lroc"}, {"fk"});
+      auto utcFuture = utcToEtBatchAsync(utcs, false, true);
+      EXPECT_EQ(statesFuture.get().first, states.first);
+      EXPECT_EQ(utcFuture.get().first, utcEts.first);
+      EXPECT_EQ(sclkFuture.get().first, ets2.first);
+      EXPECT_EQ(searchFuture.get().second, searchForKernelsets({"lroc"}, {"fk"}).second);
+    });
+  }
+  for (thread &host : hosts) {
+    host.join();
+  }
+
+  EXPECT_THROW(getTargetStatesAsync({}, "LRO", "LRO", "J2000", "NONE", "lroc").get(), invalid_argument);
+
+  // a call waiting for CSPICE does not hold up calls that do not use it
+  future<pair<vector<vector<double>>, nlohmann::json>> statesFuture;
+  {
+    CspiceGuard cspice;
+    statesFuture = getTargetStatesAsync(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+    auto searchFuture = searchForKernelsetsAsync({"lroc"}, {"fk"});
+    ASSERT_EQ(searchFuture.wait_for(chrono::seconds(60)), future_status::ready);
+    EXPECT_EQ(statesFuture.wait_for(chrono::milliseconds(100)), future_status::timeout);
+  }
+  EXPECT_EQ(statesFuture.get().first, states.first);
+}
+
+
+TEST_F(LroKernelSet, UnitTestConcurrentHostThreads) {
+  vector<double> ets = {110000000, 110000001};
+  auto states = getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+  auto orientations = getTargetOrientations(ets, 1, -85000, "lroc");
+  vector<string> loaded = getLoadedKernels();
+
+  // synchronous calls from host threads, each furnish, compute, unload runs as a whole
+  vector<thread> hosts;
+  for (int i = 0; i < 8; i++) {
+    hosts.emplace_back([&, i]() {
+      if (i % 2 == 0) {
+        EXPECT_EQ(getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"}).first, states.first);
+      }
+      else {
+        EXPECT_EQ(getTargetOrientations(ets, 1, -85000, "lroc").first, orientations.first);
+      }
+    });
+  }
+  for (thread &host : hosts) {
+    host.join();
+  }
+
+  // nothing is left furnished by the calls
+  EXPECT_EQ(getLoadedKernels(), loaded);
+}
@@ -53,6 +53,16 @@ void FrameCacheEnvironment::SetUp() {
     {"FRAME_-74021_CLASS_ID", -74021},
     {"FRAME_-74021_CENTER", -74},
     {"TKFRAME_-74021_RELATIVE", "MRO_SPACECRAFT"},
+    {"FRAME_TEST_SHARED_TK", -99990},
+    {"FRAME_-99990_NAME", "TEST_SHARED_TK"},
+    {"FRAME_-99990_CLASS", 4},
+    {"FRAME_-99990_CLASS_ID", -99990},
+    {"FRAME_-99990_CENTER", 399},
+    {"TKFRAME_-99990_RELATIVE", "J2000"},
+    {"TKFRAME_-99990_SPEC", "ANGLES"},
+    {"TKFRAME_-99990_UNITS", "DEGREES"},
+    {"TKFRAME_-99990_AXES", {1, 2, 3}},
+    {"TKFRAME_-99990_ANGLES", {0.0, 0.0, 0.0}},
     {"FRAME_MRO_SPACECRAFT", -74000},
     {"FRAME_-74000_NAME", "MRO_SPACECRAFT"},
     {"FRAME_-74000_CLASS", 3},
@@ -63,8 +73,30 @@ void FrameCacheEnvironment::SetUp() {
   };
   writeTextKernel((dir / "fk" / "mro_v01.tf").string(), "fk", mroFk);
 
-  //   lro_frames...tf -> LRO_LROCNACL (-85600), LRO (-85)
+  //   lro_frames...tf -> LRO_LROCNACL (-85600), LRO (-85), and a TK frame
+  //   LRO_TEST_TK (-85990) rotated 90 degrees about X from J2000. It also
+  //   rotates TEST_SHARED_TK (-99990), which the MRO FK leaves at J2000.
   nlohmann::json lroFk = {
+    {"FRAME_LRO_TEST_TK", -85990},
+    {"FRAME_-85990_NAME", "LRO_TEST_TK"},
+    {"FRAME_-85990_CLASS", 4},
+    {"FRAME_-85990_CLASS_ID", -85990},
+    {"FRAME_-85990_CENTER", -85},
+    {"TKFRAME_-85990_RELATIVE", "J2000"},
+    {"TKFRAME_-85990_SPEC", "ANGLES"},
+    {"TKFRAME_-85990_UNITS", "DEGREES"},
+    {"TKFRAME_-85990_AXES", {1, 2, 3}},
+    {"TKFRAME_-85990_ANGLES", {90.0, 0.0, 0.0}},
+    {"FRAME_TEST_SHARED_TK", -99990},
+    {"FRAME_-99990_NAME", "TEST_SHARED_TK"},
+    {"FRAME_-99990_CLASS", 4},
+    {"FRAME_-99990_CLASS_ID", -99990},
+    {"FRAME_-99990_CENTER", 399},
+    {"TKFRAME_-99990_RELATIVE", "J2000"},
+    {"TKFRAME_-99990_SPEC", "ANGLES"},
+    {"TKFRAME_-99990_UNITS", "DEGREES"},
+    {"TKFRAME_-99990_AXES", {1, 2, 3}},
+    {"TKFRAME_-99990_ANGLES", {90.0, 0.0, 0.0}},
     {"FRAME_LRO_LROCNACL", -85600},
     {"FRAME_-85600_NAME", "LRO_LROCNACL"},
     {"FRAME_-85600_CLASS", 3},
@@ -1,5 +1,7 @@
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -98,3 +100,29 @@ TEST_F(LroKernelSet, FrameCodeNameCacheBidirectional) {
   EXPECT_EQ(Inventory::getFrameCodeFromCache("NOT_A_FRAME"), 0);
 }
 
+
+TEST_F(LroKernelSet, FrameCodeNameCacheConcurrentReads) {
+  Inventory::create_database();
+
+  // every reader sees a complete snapshot while others read the same cache
+  vector<thread> readers;
+  atomic<int> mismatches{0};
+  for (int t = 0; t < 8; t++) {
+    readers.emplace_back([&mismatches]() {
+      for (int i = 0; i < 1000; i++) {
+        if (Inventory::getFrameNameFromCache(-85) != "LRO" || Inventory::getFrameCodeFromCache("lro_lrocnacl") != -85600) {
+          mismatches++;
+        }
+      }
+    });
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(mismatches, 0);
+
+  // regenerating the DB is picked up on the next lookup
+  Inventory::create_database();
+  EXPECT_EQ(Inventory::getFrameNameFromCache(-85), "LRO");
+}
+
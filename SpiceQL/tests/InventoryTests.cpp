@@ -251,3 +251,100 @@ TEST_F(LroKernelSet, InferMissionInitCache) {
     setenv("SPICEQL_CACHE_DIR", original_cache_dir, 1);
   }
 }
+
+
+TEST(TestInventory, TimeIndexedKernelsCoverage) {
+  TimeIndexedKernels kernels;
+  kernels.file_paths = {"gapped.bc", "full.bc"};
+
+  // without windows everything falls back to the start/stop bounds
+  EXPECT_FALSE(kernels.hasCoverage());
+  EXPECT_TRUE(kernels.covers(0, 25, 26));
+
+  kernels.addCoverage({{10, 20}, {30, 40}});
+  kernels.addCoverage({{10, 40}});
+  EXPECT_TRUE(kernels.hasCoverage());
+
+  EXPECT_TRUE(kernels.covers(0, 15, 16));
+  EXPECT_TRUE(kernels.covers(0, 18, 32));
+  EXPECT_TRUE(kernels.covers(0, 20, 20));
+  EXPECT_FALSE(kernels.covers(0, 21, 29));
+  EXPECT_FALSE(kernels.covers(0, 41, 50));
+  EXPECT_FALSE(kernels.covers(0, 0, 9));
+  EXPECT_TRUE(kernels.covers(1, 21, 29));
+}
+
+
+TEST_F(LroKernelSet, TestInventoryCoverageWindows) {
+  Inventory::create_database();
+  fs::path dbfile = Inventory::getDbFilePath();
+  HighFive::File file(dbfile, HighFive::File::ReadOnly);
+
+  vector<double> starts = file.getDataSet("/spice/lroc/ck/reconstructed/coverage_start").read<vector<double>>();
+  vector<double> stops = file.getDataSet("/spice/lroc/ck/reconstructed/coverage_stop").read<vector<double>>();
+  vector<size_t> offsets = file.getDataSet("/spice/lroc/ck/reconstructed/coverage_offsets").read<vector<size_t>>();
+  vector<string> paths = file.getDataSet("/spice/lroc/ck/reconstructed/path_index").read<vector<string>>();
+
+  EXPECT_EQ(offsets.size(), paths.size() + 1);
+  EXPECT_EQ(starts.size(), stops.size());
+  EXPECT_EQ(offsets.back(), starts.size());
+
+  // the window between the two CKs is not covered by either file
+  nlohmann::json kernels = Inventory::search_for_kernelset("lroc", {"ck"}, 121000000, 129000000, {"reconstructed"}, {"reconstructed"});
+  EXPECT_FALSE(kernels.contains("ck"));
+}
+
+
+TEST_F(LroKernelSet, TestInventoryMinimalCover) {
+  Inventory::create_database();
+
+  nlohmann::json kernels = Inventory::search_for_kernelset("lroc", {"ck"}, 110000000, 140000000, {"reconstructed"}, {"reconstructed"},
+                                                           false, Inventory::LIMIT_MINIMAL_COVER);
+  SPDLOG_DEBUG("Returned Kernels {} ", kernels.dump());
+  EXPECT_EQ(kernels["ck"].size(), 2);
+  ASSERT_EQ(kernels["lroc_ck_coverage"]["gaps"].size(), 1);
+  EXPECT_GE(kernels["lroc_ck_coverage"]["gaps"][0][0].get<double>(), 110000000);
+  EXPECT_LE(kernels["lroc_ck_coverage"]["gaps"][0][1].get<double>(), 140000000);
+
+  kernels = Inventory::search_for_kernelset("lroc", {"ck"}, 112000000, 118000000, {"reconstructed"}, {"reconstructed"},
+                                            false, Inventory::LIMIT_MINIMAL_COVER);
+  ASSERT_EQ(kernels["ck"].size(), 1);
+  EXPECT_EQ(fs::path(kernels["ck"][0]).filename(), "soc31_1111111_1111111_v21.bc");
+  EXPECT_TRUE(kernels["lroc_ck_coverage"]["gaps"].empty());
+
+  // nothing overlaps the window, so all of it is uncovered
+  kernels = Inventory::search_for_kernelset("lroc", {"ck"}, 10, 20, {"reconstructed"}, {"reconstructed"},
+                                            false, Inventory::LIMIT_MINIMAL_COVER);
+  EXPECT_FALSE(kernels.contains("ck"));
+  ASSERT_EQ(kernels["lroc_ck_coverage"]["gaps"].size(), 1);
+  EXPECT_EQ(kernels["lroc_ck_coverage"]["gaps"][0], nlohmann::json({10, 20}));
+}
+
+
+TEST_F(LroKernelSet, TestInventoryCoverage) {
+  Inventory::create_database();
+
+  nlohmann::json coverage = Inventory::getCoverage("lroc", "ck", {"reconstructed", "smithed"});
+  SPDLOG_DEBUG("Coverage {} ", coverage.dump());
+  EXPECT_FALSE(coverage.contains("smithed"));
+  ASSERT_EQ(coverage["reconstructed"]["windows"].size(), 2);
+  ASSERT_EQ(coverage["reconstructed"]["gaps"].size(), 1);
+  EXPECT_EQ(coverage["reconstructed"]["gaps"][0][0], coverage["reconstructed"]["windows"][0][1]);
+  EXPECT_EQ(coverage["reconstructed"]["gaps"][0][1], coverage["reconstructed"]["windows"][1][0]);
+
+  // explicit bounds are clipped and the uncovered ends are reported
+  coverage = Inventory::getCoverage("lroc", "ck", {"reconstructed"}, 100000000, 115000000);
+  ASSERT_EQ(coverage["reconstructed"]["windows"].size(), 1);
+  EXPECT_EQ(coverage["reconstructed"]["windows"][0][1].get<double>(), 115000000);
+  ASSERT_EQ(coverage["reconstructed"]["gaps"].size(), 1);
+  EXPECT_EQ(coverage["reconstructed"]["gaps"][0][0].get<double>(), 100000000);
+
+  coverage = Inventory::getCoverage("lroc", "ck", {"reconstructed"}, -std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), -85000);
+  EXPECT_EQ(coverage["reconstructed"]["windows"].size(), 2);
+
+  coverage = Inventory::getCoverage("lroc", "ck", {"reconstructed"}, 100000000, 150000000, -1);
+  EXPECT_TRUE(coverage["reconstructed"]["windows"].empty());
+  EXPECT_EQ(coverage["reconstructed"]["gaps"].size(), 1);
+
+  EXPECT_THROW(Inventory::getCoverage("lroc", "fk"), std::invalid_argument);
+}
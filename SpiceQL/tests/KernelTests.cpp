@@ -9,6 +9,7 @@
 #include <SpiceQL/query.h>
 #include <SpiceQL/inventory.h>
 #include <SpiceQL/api.h>
+#include <SpiceQL/textkernel.h>
 #include <SpiceQL/io.h>
 
 #include <SpiceUsr.h>
@@ -130,6 +131,29 @@ TEST_F(LroKernelSet, UnitTestDoubleSclkToEt) {
 }
 
 
+TEST_F(LroKernelSet, UnitTestSclkToEtBatch) {
+  nlohmann::json testKernelJson;
+  testKernelJson["kernels"] = {{ckPath1}, {ckPath2}, {spkPath1}, {spkPath2}, {spkPath3}, {ikPath2}, {fkPath}, {sclkPath}, {lskPath}};
+  KernelSet testSet(testKernelJson);
+
+  auto [strEts, strKernels] = strSclkToEtBatch(-85, {"1/281199081:48971", "1/281199081:48971"}, "lro");
+  ASSERT_EQ(strEts.size(), 2);
+  EXPECT_DOUBLE_EQ(strEts[0], 312778347.97478431);
+  EXPECT_DOUBLE_EQ(strEts[1], 312778347.97478431);
+
+  auto [dblEts, dblKernels] = doubleSclkToEtBatch(-85, {922997380.174174, 922997380.174174}, "lro");
+  ASSERT_EQ(dblEts.size(), 2);
+  EXPECT_DOUBLE_EQ(dblEts[0], 31593348.006268278);
+
+  auto [sclks, sclkKernels] = doubleEtToSclkBatch(-85, {312778347.97478431, 31593348.006268278}, "lro");
+  ASSERT_EQ(sclks.size(), 2);
+  EXPECT_EQ(sclks[0], doubleEtToSclk(-85, 312778347.97478431, "lro").first);
+  EXPECT_EQ(sclks[1], doubleEtToSclk(-85, 31593348.006268278, "lro").first);
+
+  EXPECT_TRUE(strSclkToEtBatch(-85, {}, "lro").first.empty());
+}
+
+
 TEST_F(LroKernelSet, UnitTestUtcToEt) {
   auto [et, kernels] = utcToEt("2016-11-26 22:32:14.582000");
 
@@ -172,6 +196,77 @@ TEST_F(LroKernelSet, TestEtToUTCNoSearch) {
   EXPECT_EQ(utc_search, expectedUtc);
 }
 
+TEST_F(LroKernelSet, TestUtcEtBatch) {
+  const std::vector<std::string> utcs = {"2016-11-26T22:32:14.582000", "1971-08-04T16:28:24.9159358", "1986 JAN 18 12:19:52", "1969-07-20T20:17:40"};
+
+  // Test with no search (uses utcet)
+  auto [ets_nosearch, kernels_nosearch] = utcToEtBatch(utcs, false, false);
+  ASSERT_EQ(ets_nosearch.size(), utcs.size());
+  for (size_t i = 0; i < utcs.size(); i++) {
+    EXPECT_EQ(ets_nosearch[i], utcToEt(utcs[i], false, false).first);
+  }
+
+  // Test with search (uses LSK kernel)
+  auto [ets_search, kernels_search] = utcToEtBatch(utcs, false, true);
+  ASSERT_EQ(ets_search.size(), utcs.size());
+  for (size_t i = 0; i < utcs.size(); i++) {
+    EXPECT_NEAR(ets_nosearch[i], ets_search[i], 1e-6);
+  }
+
+  auto [utcs_nosearch, utcKernels_nosearch] = etToUtcBatch(ets_search, "ISOC", 6, false, false);
+  auto [utcs_search, utcKernels_search] = etToUtcBatch(ets_search, "ISOC", 6, false, true);
+  ASSERT_EQ(utcs_nosearch.size(), utcs.size());
+  for (size_t i = 0; i < utcs.size(); i++) {
+    EXPECT_EQ(utcs_nosearch[i], etToUtc(ets_search[i], "ISOC", 6, false, false).first);
+    EXPECT_EQ(utcs_nosearch[i], utcs_search[i]);
+  }
+  EXPECT_EQ(utcs_nosearch[0], "2016-11-26T22:32:14.582000");
+
+  EXPECT_TRUE(utcToEtBatch({}, false, false).first.empty());
+  EXPECT_TRUE(etToUtcBatch({}, "ISOC", 6, false, false).first.empty());
+}
+
+TEST_F(LroKernelSet, TestUtcEtLskLeapSeconds) {
+  const std::vector<std::string> utcs = {"1969-07-20T20:17:40", "1972-06-30T23:59:59.5", "1972-07-01T00:00:00", "2008-09-12 05:32:11.25", "2016-12-31T23:59:59", "2016-12-31T23:59:60", "2016-12-31T23:59:60.5", "2017-01-01T00:00:01", "2024-04-04T01:35:29.123456"};
+
+  // the search path reads leap seconds from the LSK instead of furnishing it
+  auto [ets, kernels] = utcToEtBatch(utcs, false, true);
+  EXPECT_TRUE(getLoadedKernels().empty());
+
+  nlohmann::json testKernelJson;
+  testKernelJson["kernels"] = {{lskPath}};
+  KernelSet testSet(testKernelJson);
+
+  for (size_t i = 0; i < utcs.size(); i++) {
+    SpiceDouble et;
+    str2et_c(utcs[i].c_str(), &et);
+    EXPECT_NEAR(ets[i], et, 1e-6);
+    EXPECT_NEAR(utcToEt(utcs[i], false, true).first, et, 1e-6);
+
+    for (std::string format : {"C", "D", "ISOC", "ISOD"}) {
+      SpiceChar utc[100];
+      et2utc_c(et, format.c_str(), 3, 100, utc);
+      EXPECT_EQ(etToUtc(et, format, 3, false, true).first, std::string(utc));
+    }
+  }
+
+  // the seconds around a leap second, including round ups into and out of it
+  SpiceDouble lastSecond;
+  str2et_c("2016-12-31T23:59:59", &lastSecond);
+  for (double offset : {-0.5, 0.25, 0.9996, 1.0, 1.5, 1.9996}) {
+    SpiceChar utc[100];
+    et2utc_c(lastSecond + offset, "ISOC", 3, 100, utc);
+    EXPECT_EQ(etToUtc(lastSecond + offset, "ISOC", 3, false, true).first, std::string(utc));
+    EXPECT_EQ(etToUtcBatch({lastSecond + offset}, "ISOC", 3, false, true).first[0], std::string(utc));
+  }
+
+  // two digit years are left to str2et
+  SpiceDouble twoDigitYear;
+  str2et_c("86 JAN 18 12:19:52", &twoDigitYear);
+  EXPECT_NEAR(utcToEt("86 JAN 18 12:19:52", false, true).first, twoDigitYear, 1e-6);
+  EXPECT_NEAR(utcToEtBatch({"86 JAN 18 12:19:52", "2016-12-31T23:59:60"}, false, true).first[0], twoDigitYear, 1e-6);
+}
+
 TEST_F(LroKernelSet, UnitTestGetLoadedKernels) {
   // Nothing furnished yet, so the pool reports no kernels.
   EXPECT_TRUE(getLoadedKernels().empty());
@@ -249,6 +344,23 @@ TEST_F(LroKernelSet, InferMissionGetFrameInfo) {
 }
 
 
+TEST_F(LroKernelSet, FrameInfoFromCache) {
+  Inventory::create_database();
+
+  // cached values match frinfo_c/cidfrm_c with the FKs furnished
+  EXPECT_EQ(Inventory::getFrameInfoFromCache(-85620, "lroc"), vector<int>({-85, 3, -85620}));
+  EXPECT_TRUE(Inventory::getFrameInfoFromCache(123456789, "lroc").empty());
+  EXPECT_EQ(Inventory::getTargetFrameFromCache(499, "lroc"), make_pair(10014, string("IAU_MARS")));
+
+  auto [infos, kernels] = getFrameInfoBatch({-85620, -85600}, "lroc");
+  ASSERT_EQ(infos.size(), 2);
+  EXPECT_EQ(infos[0], getFrameInfo(-85620, "lroc").first);
+  EXPECT_EQ(infos[1], getFrameInfo(-85600, "lroc").first);
+
+  EXPECT_THROW(getFrameInfoBatch({-85620, 123456789}, "lroc"), invalid_argument);
+}
+
+
 TEST_F(LroKernelSet, InferMissionStrSclkToEt) {
   Inventory::create_database();
 
@@ -274,6 +386,25 @@ TEST_F(LroKernelSet, InferMissionFromFrameName) {
 }
 
 
+TEST_F(LroKernelSet, TranslateFrameBatch) {
+  Inventory::create_database();
+
+  vector<string> names = {"LRO_LROCWAC", "LRO_LROCNACL", "lro"};
+  auto [codes, kernels1] = translateNameToCodeBatch(names, "lroc");
+  EXPECT_EQ(codes, vector<int>({-85620, -85600, -85}));
+
+  auto [roundTrip, kernels2] = translateCodeToNameBatch(codes, "lroc");
+  EXPECT_EQ(roundTrip, vector<string>({"LRO_LROCWAC", "LRO_LROCNACL", "LRO"}));
+
+  // batch results match the scalar calls
+  EXPECT_EQ(codes[1], translateNameToCode("LRO_LROCNACL", "lroc").first);
+  EXPECT_EQ(roundTrip[1], translateCodeToName(-85600, "lroc").first);
+
+  EXPECT_THROW(translateNameToCodeBatch({"LRO_LROCNACL", "NOT_A_FRAME"}, "lroc"), invalid_argument);
+  EXPECT_TRUE(translateCodeToNameBatch({}, "lroc").first.empty());
+}
+
+
 TEST_F(LroKernelSet, UnitTestFindMissionKeywords) {
   auto [keywords, kernels] = findMissionKeywords("INS-85600_CCD_CENTER", "lro");
 
@@ -284,6 +415,22 @@ TEST_F(LroKernelSet, UnitTestFindMissionKeywords) {
 }
 
 
+TEST_F(LroKernelSet, MissionKeywordsFromCache) {
+  Inventory::create_database();
+
+  nlohmann::json cached = Inventory::findMissionKeywordsFromCache("INS-85600_*", "lro");
+  ASSERT_TRUE(cached.is_object());
+  EXPECT_EQ(cached["INS-85600_CCD_CENTER"], nlohmann::json({2531.5, 0.5}));
+  EXPECT_TRUE(Inventory::findMissionKeywordsFromCache("NOT_A_KEYWORD*", "lro").empty());
+  EXPECT_TRUE(Inventory::findMissionKeywordsFromCache("*", "not_a_mission").is_null());
+
+  // same keywords as reading the kernels the search returns
+  auto [keywords, kernels] = findMissionKeywords("INS-85600_*", "lro", false, true, true);
+  EXPECT_EQ(keywords, cached);
+  EXPECT_EQ(findTextKernelKeywords("INS-85600_*", getKernelsAsVector(kernels)), cached);
+}
+
+
 TEST_F(LroKernelSet, UnitTestGetTargetFrameInfo) {
   auto [frameInfo, kernels] = getTargetFrameInfo(499, "lroc");
 
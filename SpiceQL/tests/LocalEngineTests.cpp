@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Fixtures.h"
+#include <SpiceQL/api.h>
+#include <SpiceQL/localengine.h>
+
+using namespace std;
+using namespace SpiceQL;
+
+TEST_F(LroKernelSet, UnitTestLocalEngine) {
+  vector<double> ets = {110000000, 110000001};
+  auto states = getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+  auto ets2 = strSclkToEtBatch(-85, {"1/281199081:48971", "1/281199081:48971"}, "lro");
+  vector<double> manyEts(12000, 110000000);
+  auto manyStates = getTargetStates(manyEts, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+
+  // workers are new processes, starting them while other tests' threads run is safe
+  EXPECT_EQ(LocalEngine::active(), nullptr);
+  LocalEngine::start(2);
+  ASSERT_NE(LocalEngine::active(), nullptr);
+  EXPECT_EQ(LocalEngine::active()->workerCount(), 2);
+
+  // the same calls give the same results from the workers
+  vector<thread> hosts;
+  for (int i = 0; i < 4; i++) {
+    hosts.emplace_back([&]() {
+      EXPECT_EQ(getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"}), states);
+      EXPECT_EQ(strSclkToEtBatch(-85, {"1/281199081:48971", "1/281199081:48971"}, "lro"), ets2);
+    });
+  }
+  for (thread &host : hosts) {
+    host.join();
+  }
+
+  // long ET lists are split across the workers and put back in order
+  auto [engineStates, engineKernels] = getTargetStates(manyEts, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+  EXPECT_EQ(engineStates, manyStates.first);
+  EXPECT_EQ(engineKernels, manyStates.second);
+
+  // errors in a worker are rethrown with their type
+  EXPECT_THROW(getTargetStates({}, "LRO", "LRO", "J2000", "NONE", "lroc"), invalid_argument);
+  EXPECT_THROW(LocalEngine::active()->query("searchForKernelsets", {}), invalid_argument);
+
+  LocalEngine::stop();
+  EXPECT_EQ(LocalEngine::active(), nullptr);
+  EXPECT_EQ(getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"}), states);
+}
+
+
+TEST(LocalEngineTests, UnitTestLocalEngineWorkerFailures) {
+  // a worker that never answers is killed once the timeout passes
+  setenv("SPICEQL_LOCAL_ENGINE_WORKER", "/bin/sleep", true);
+  auto started = chrono::steady_clock::now();
+  EXPECT_THROW({ LocalEngine engine(1, 1024, chrono::seconds(1)); }, runtime_error);
+  EXPECT_LT(chrono::steady_clock::now() - started, chrono::seconds(30));
+
+  // one that can not be run exits before it answers
+  setenv("SPICEQL_LOCAL_ENGINE_WORKER", "/nonexistent/spiceql-worker", true);
+  EXPECT_THROW({ LocalEngine engine(1, 1024, chrono::seconds(30)); }, runtime_error);
+
+  unsetenv("SPICEQL_LOCAL_ENGINE_WORKER");
+}
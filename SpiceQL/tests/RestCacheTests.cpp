@@ -0,0 +1,117 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Fixtures.h"
+#include <SpiceQL/restcache.h>
+
+using namespace std;
+using namespace SpiceQL;
+
+TEST_F(TempTestingFiles, UnitTestRestCacheMemoryAndDisk) {
+  fs::path cacheDir = tempDir / "restcache";
+  nlohmann::json response = {{"statusCode", 200}, {"body", {{"return", {1.5, 2.5}}, {"kernels", {{"lsk", {"naif0012.tls"}}}}}}};
+
+  // argument order does not change the key
+  nlohmann::json args = {{"mission", "ctx"}, {"ets", {1, 2}}};
+  nlohmann::json reordered;
+  reordered["ets"] = {1, 2};
+  reordered["mission"] = "ctx";
+  string key = RestCache::makeKey("getTargetStates", args);
+  EXPECT_EQ(key, RestCache::makeKey("getTargetStates", reordered));
+  EXPECT_NE(key, RestCache::makeKey("getTargetOrientations", args));
+  string otherKey = RestCache::makeKey("getTargetStates", {{"mission", "ctx"}, {"ets", {3, 4}}});
+  string thirdKey = RestCache::makeKey("getTargetStates", {{"mission", "ctx"}, {"ets", {5, 6}}});
+
+  // all three entries are the same size, the cache holds two and a half
+  size_t entryBytes;
+  {
+    RestCache probe(1 << 20);
+    probe.put(key, response, "W/\"db1\"");
+    entryBytes = probe.bytes();
+  }
+  size_t maxBytes = entryBytes * 5 / 2;
+
+  {
+    RestCache cache(maxBytes, cacheDir.string());
+    EXPECT_FALSE(cache.get(key).has_value());
+    cache.put(key, response, "W/\"db1\"");
+
+    auto entry = cache.get(key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_TRUE(entry->fresh);
+    EXPECT_EQ(entry->response, response);
+    EXPECT_EQ(entry->etag, "W/\"db1\"");
+  }
+
+  // a new session finds the entry on disk
+  RestCache reloaded(maxBytes, cacheDir.string());
+  auto entry = reloaded.get(key);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_TRUE(entry->fresh);
+  EXPECT_EQ(entry->response, response);
+
+  // a newer server ETag makes older entries stale until they are refreshed
+  reloaded.put(otherKey, response, "W/\"db2\"");
+  EXPECT_FALSE(reloaded.get(key)->fresh);
+  reloaded.put(key, response, "W/\"db2\"");
+  EXPECT_TRUE(reloaded.get(key)->fresh);
+
+  // least recently used entries are evicted in memory, and the directory is
+  // pruned to three quarters of the limit once it grows past it
+  reloaded.put(thirdKey, response, "W/\"db2\"");
+  EXPECT_EQ(reloaded.size(), 2);
+  EXPECT_EQ(reloaded.bytes(), 2 * entryBytes);
+  EXPECT_TRUE(reloaded.get(key).has_value());
+  size_t files = 0;
+  for (auto &file : fs::directory_iterator(cacheDir)) {
+    files += file.path().extension() == ".msgpack";
+  }
+  EXPECT_EQ(files, 1);
+
+  // responses larger than the whole cache are not kept
+  RestCache small(entryBytes - 1);
+  small.put(key, response, "W/\"db1\"");
+  EXPECT_FALSE(small.get(key).has_value());
+  EXPECT_EQ(small.bytes(), 0);
+
+  reloaded.clear();
+  EXPECT_EQ(reloaded.size(), 0);
+  EXPECT_FALSE(reloaded.get(key).has_value());
+}
+
+
+TEST(RestCacheTests, UnitTestRestCacheTtlAndDisabled) {
+  nlohmann::json response = {{"statusCode", 200}};
+
+  RestCache expired(1 << 20, "", chrono::seconds(0));
+  expired.put("key", response, "");
+  auto entry = expired.get("key");
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_FALSE(entry->fresh);
+
+  RestCache disabled(0);
+  EXPECT_FALSE(disabled.enabled());
+  disabled.put("key", response, "");
+  EXPECT_FALSE(disabled.get("key").has_value());
+
+  // keys of one length give entries of one size, room for 64 of them
+  RestCache probe(1 << 20);
+  probe.put("key100", response, "");
+  RestCache shared(64 * probe.bytes());
+  vector<thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < 100; j++) {
+        string key = "key" + to_string(100 + (i * 100 + j) % 80);
+        shared.put(key, response, "");
+        shared.get(key);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(shared.size(), 64);
+  EXPECT_EQ(shared.bytes(), 64 * probe.bytes());
+}
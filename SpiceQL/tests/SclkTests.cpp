@@ -0,0 +1,122 @@
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "Fixtures.h"
+#include <SpiceQL/sclk.h>
+#include <SpiceQL/spice_types.h>
+
+#include <SpiceUsr.h>
+
+using namespace std;
+using namespace SpiceQL;
+
+TEST_F(LroKernelSet, UnitTestSclkModelMatchesCspice) {
+  nlohmann::json testKernelJson;
+  testKernelJson["kernels"] = {{sclkPath}, {lskPath}};
+  KernelSet testSet(testKernelJson);
+
+  shared_ptr<const SclkModel> model = SclkModel::load({sclkPath}, -85, lskPath);
+  EXPECT_EQ(model->getClockId(), -85);
+
+  // spans several coefficient records
+  vector<double> ticks = {0, 922997380.174174, 1.7492178501632e13, 1.7492182433792e13 + 12345.5, 1.7643513772661e13, 1.765e13};
+  vector<double> ets(ticks.size());
+  model->ticksToEt(ticks.data(), ets.data(), ticks.size());
+
+  for (size_t i = 0; i < ticks.size(); i++) {
+    SpiceDouble et;
+    sct2e_c(-85, ticks[i], &et);
+    EXPECT_NEAR(ets[i], et, 1e-6);
+
+    SpiceDouble cspiceTicks;
+    sce2c_c(-85, et, &cspiceTicks);
+    EXPECT_NEAR(model->etToTicks(et), cspiceTicks, 1e-2);
+
+    SpiceChar sclk[100];
+    sce2s_c(-85, et, 100, sclk);
+    EXPECT_EQ(model->etToSclk(et), string(sclk));
+
+    SpiceDouble strEt;
+    scs2e_c(-85, sclk, &strEt);
+    EXPECT_NEAR(model->sclkToEt(sclk), strEt, 1e-6);
+  }
+
+  EXPECT_NEAR(model->sclkToEt("1/281199081:48971"), 312778347.97478431, 1e-6);
+  EXPECT_DOUBLE_EQ(model->sclkToTicks("281199081.48971"), model->sclkToTicks("1/281199081:48971"));
+}
+
+
+TEST_F(LroKernelSet, UnitTestSclkModelErrors) {
+  shared_ptr<const SclkModel> model = SclkModel::load({sclkPath}, -85, lskPath);
+
+  EXPECT_THROW(model->ticksToEt(-1), range_error);
+  EXPECT_THROW(model->sclkToTicks("2/281199081:48971"), range_error);
+  EXPECT_THROW(model->sclkToTicks("1/abc"), invalid_argument);
+  EXPECT_THROW(SclkModel::load({sclkPath}, -86, lskPath), invalid_argument);
+}
+
+
+TEST_F(LroKernelSet, UnitTestSclkModelCache) {
+  shared_ptr<const SclkModel> first = SclkModel::load({sclkPath}, -85, lskPath);
+  shared_ptr<const SclkModel> second = SclkModel::load({sclkPath}, -85, lskPath);
+  EXPECT_EQ(first.get(), second.get());
+
+  // kernels without the clock are remembered and rethrow the same error
+  string error;
+  try {
+    SclkModel::load({sclkPath}, -86, lskPath);
+  }
+  catch (invalid_argument &e) {
+    error = e.what();
+  }
+  EXPECT_FALSE(error.empty());
+  try {
+    SclkModel::load({sclkPath}, -86, lskPath);
+    FAIL() << "a cached miss should throw";
+  }
+  catch (invalid_argument &e) {
+    EXPECT_EQ(string(e.what()), error);
+  }
+
+  // the least recently used entries are dropped once the cache is full
+  fs::path empty = fs::temp_directory_path() / "spiceql_sclk_cache.tsc";
+  ofstream file(empty);
+  file << "\\begindata\nSCLK_KERNEL_ID = ( @2020-07-02 )\n";
+  file.close();
+  for (int clockId = -1000; clockId > -1000 - (int)SclkModel::MODEL_CACHE_SIZE; clockId--) {
+    EXPECT_THROW(SclkModel::load({empty.string()}, clockId), invalid_argument);
+  }
+  fs::remove(empty);
+  shared_ptr<const SclkModel> rebuilt = SclkModel::load({sclkPath}, -85, lskPath);
+  EXPECT_NE(first.get(), rebuilt.get());
+  EXPECT_EQ(rebuilt->getClockId(), -85);
+}
+
+
+TEST(SclkTests, UnitTestParseTextKernel) {
+  fs::path path = fs::temp_directory_path() / "spiceql_parse_text_kernel.tsc";
+  ofstream file(path);
+  file << "KPL/SCLK\n"
+       << "NAME = 'ignored'\n"
+       << "\\begindata\n"
+       << "VALUE = 1.5D+01\n"
+       << "LIST  = ( 1, 2\n"
+       << "          3 )\n"
+       << "STR   = 'it''s'\n"
+       << "DATE  = @2020-07-02/04:12:13.51\n"
+       << "LIST += 4\n"
+       << "\\begintext\n"
+       << "OTHER = 1\n";
+  file.close();
+
+  nlohmann::json pool = parseTextKernel(path.string());
+  fs::remove(path);
+
+  EXPECT_FALSE(pool.contains("NAME"));
+  EXPECT_FALSE(pool.contains("OTHER"));
+  EXPECT_EQ(pool["VALUE"], nlohmann::json({15.0}));
+  EXPECT_EQ(pool["LIST"], nlohmann::json({1.0, 2.0, 3.0, 4.0}));
+  EXPECT_EQ(pool["STR"], nlohmann::json({"it's"}));
+  EXPECT_EQ(pool["DATE"], nlohmann::json({"@2020-07-02/04:12:13.51"}));
+}
@@ -0,0 +1,167 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Fixtures.h"
+#include <SpiceQL/api.h>
+#include <SpiceQL/singleflight.h>
+
+using namespace std;
+using namespace SpiceQL;
+
+TEST(SingleFlightTests, UnitTestSingleFlightSharesResults) {
+  SingleFlight flights(true);
+
+  // argument order does not change the key
+  nlohmann::json args = {{"target", "LRO"}, {"ets", {1, 2}}};
+  nlohmann::json reordered;
+  reordered["ets"] = {1, 2};
+  reordered["target"] = "LRO";
+  string key = SingleFlight::makeKey("getTargetStates", args);
+  EXPECT_EQ(key, SingleFlight::makeKey("getTargetStates", reordered));
+  EXPECT_NE(key, SingleFlight::makeKey("getTargetOrientations", args));
+  EXPECT_NE(key, SingleFlight::makeKey("getTargetStates", {{"target", "LRO"}, {"ets", {1, 3}}}));
+
+  // the arguments are kept as a SHA-256 digest of their JSON
+  EXPECT_EQ(SingleFlight::makeKey("f", ""), "f?12ae32cb1ec02d01eda3581b127c1fee3b0dc53572ed6baf239721a03d82e126");
+  EXPECT_EQ(SingleFlight::makeKey("f", {{"a", 1}}), "f?015abd7f5cc57a2dd94b7590f04ad8084273905ee33ec5cebeae62276a97f862");
+  EXPECT_EQ(SingleFlight::makeKey("f", vector<double>(100000, 110000000.5)).size(), 2 + 64);
+
+  atomic<int> runs = 0;
+  atomic<bool> release = false;
+  function<vector<double>()> slow = [&]() {
+    runs++;
+    while (!release) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    return vector<double>{1.5, 2.5};
+  };
+
+  vector<vector<double>> results(8);
+  vector<thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&, i]() { results[i] = flights.run(key, slow); });
+  }
+  // let every call join the one in flight before it finishes
+  while (flights.totalStats().computed == 0) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  this_thread::sleep_for(chrono::milliseconds(50));
+  release = true;
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(runs, 1);
+  for (auto &result : results) {
+    EXPECT_EQ(result, vector<double>({1.5, 2.5}));
+  }
+  SingleFlight::Stats stats = flights.stats(key);
+  EXPECT_EQ(stats.computed, 1);
+  EXPECT_EQ(stats.shared, 7);
+  EXPECT_EQ(stats.timedOut, 0);
+
+  // nothing is cached once the call lands
+  EXPECT_EQ(flights.run(key, slow), vector<double>({1.5, 2.5}));
+  EXPECT_EQ(runs, 2);
+  EXPECT_EQ(flights.allStats().size(), 1);
+
+  flights.resetStats();
+  EXPECT_EQ(flights.totalStats().computed, 0);
+  EXPECT_EQ(flights.stats(key).shared, 0);
+}
+
+
+TEST(SingleFlightTests, UnitTestSingleFlightErrorsAndWaits) {
+  SingleFlight flights(true, chrono::milliseconds(20), 1);
+  atomic<bool> release = false;
+
+  // waiting calls get the exception of the call in flight
+  function<int()> failing = [&]() -> int {
+    while (!release) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    throw invalid_argument("bad call");
+  };
+  thread first([&]() { EXPECT_THROW(flights.run("failing", failing), invalid_argument); });
+  while (flights.totalStats().computed == 0) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  thread second([&]() { EXPECT_THROW(flights.run("failing", failing), invalid_argument); });
+  this_thread::sleep_for(chrono::milliseconds(5));
+  release = true;
+  first.join();
+  second.join();
+
+  // a call that waits too long computes the result itself
+  release = false;
+  function<int()> slow = [&]() {
+    while (!release) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    return 1;
+  };
+  thread leader([&]() { EXPECT_EQ(flights.run("slow", slow), 1); });
+  while (flights.totalStats().computed < 2) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  thread impatient([&]() { EXPECT_EQ(flights.run("slow", function<int()>([]() { return 2; })), 2); });
+  impatient.join();
+  release = true;
+  leader.join();
+  EXPECT_GE(flights.totalStats().timedOut, 1);
+
+  // only the first key has stats of its own
+  EXPECT_EQ(flights.allStats().size(), 1);
+  EXPECT_EQ(flights.stats("slow").computed, 0);
+
+  // a function being coalesced calls itself without waiting on its own flight
+  function<int()> recursive = [&]() {
+    EXPECT_FALSE(flights.shouldCoalesce());
+    return flights.run("recursive", function<int()>([]() { return 3; }));
+  };
+  EXPECT_TRUE(flights.shouldCoalesce());
+  EXPECT_EQ(flights.run("recursive", recursive), 3);
+
+  SingleFlight disabled(false);
+  EXPECT_FALSE(disabled.shouldCoalesce());
+  EXPECT_EQ(disabled.run("key", slow), 1);
+  EXPECT_EQ(disabled.totalStats().computed, 0);
+}
+
+
+TEST_F(LroKernelSet, UnitTestSingleFlightApiCalls) {
+  vector<double> ets = {110000000, 110000001};
+  auto expected = getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"});
+
+  SingleFlight &flights = SingleFlight::instance();
+  bool wasEnabled = flights.shouldCoalesce();
+  flights.setEnabled(true);
+  flights.resetStats();
+
+  vector<thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&]() {
+      EXPECT_EQ(getTargetStates(ets, "LRO", "LRO", "J2000", "NONE", "lroc", {"smithed"}, {"smithed"}), expected);
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  // all calls had one key, the digest of their arguments, and the call
+  // computing a result was not coalesced again
+  map<string, SingleFlight::Stats> stats = flights.allStats();
+  ASSERT_EQ(stats.size(), 1);
+  const auto &[key, counts] = *stats.begin();
+  EXPECT_EQ(key.rfind("getTargetStates?", 0), 0);
+  EXPECT_EQ(key.size(), string("getTargetStates?").size() + 64);
+  EXPECT_GE(counts.computed, 1);
+  EXPECT_EQ(counts.computed + counts.shared + counts.timedOut, 8);
+
+  flights.setEnabled(wasEnabled);
+  flights.resetStats();
+}
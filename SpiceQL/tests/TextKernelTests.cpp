@@ -0,0 +1,140 @@
+#include <fstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "Fixtures.h"
+#include <SpiceQL/textkernel.h>
+#include <SpiceQL/spice_types.h>
+#include <SpiceQL/utils.h>
+
+using namespace std;
+using namespace SpiceQL;
+
+TEST_F(TempTestingFiles, UnitTestFindTextKernelKeywordsMatchesPool) {
+  fs::path first = tempDir / "first.tf";
+  fs::path second = tempDir / "second.ti";
+
+  ofstream firstFile(first);
+  firstFile << "KPL/FK\n"
+            << "\\begindata\n"
+            << "TK_TEST_LIST  = ( 1, 2 )\n"
+            << "TK_TEST_NAME  = 'first'\n"
+            << "TK_TEST_FLAG  = 'TRUE'\n"
+            << "TK_TEST_DATE  = @2020-JUL-02/04:12:13.51\n"
+            << "TK_TEST_DOY   = @2020-184T04:12\n"
+            << "TK_TEST_LONG  = ( 'a continued //'\n"
+            << "                  'string' )\n";
+  // more keywords than findKeywords used to return
+  for (int i = 0; i < 250; i++) {
+    firstFile << "TK_TEST_MANY_" << i << " = " << i << "\n";
+  }
+  firstFile << "\\begintext\n";
+  firstFile.close();
+
+  ofstream secondFile(second);
+  secondFile << "KPL/IK\n"
+             << "\\begindata\n"
+             << "TK_TEST_LIST += 3.5D0\n"
+             << "TK_TEST_NAME  = 'second'\n";
+  secondFile.close();
+
+  nlohmann::json native = findTextKernelKeywords("TK_TEST_*", {first.string(), second.string()});
+  EXPECT_EQ(native["TK_TEST_LIST"], nlohmann::json({1.0, 2.0, 3.5}));
+  EXPECT_EQ(native["TK_TEST_NAME"], "second");
+  EXPECT_EQ(native["TK_TEST_FLAG"], true);
+  EXPECT_EQ(native["TK_TEST_LONG"], nlohmann::json({"a continued //", "string"}));
+  EXPECT_EQ(native.size(), 256);
+
+  nlohmann::json kernels;
+  kernels["kernels"] = {{first.string()}, {second.string()}};
+  KernelSet kset(kernels);
+
+  EXPECT_EQ(native, findKeywords("TK_TEST_*"));
+  EXPECT_EQ(findTextKernelKeywords("TK_TEST_MANY_1%", {first.string(), second.string()}), findKeywords("TK_TEST_MANY_1%"));
+  EXPECT_TRUE(findTextKernelKeywords("NOT_A_KEYWORD*", {first.string(), second.string()}).is_null());
+}
+
+
+TEST_F(TempTestingFiles, UnitTestFindTextKernelKeywordsMetaKernel) {
+  fs::path kernel = tempDir / "listed.tf";
+  fs::path meta = tempDir / "listing.tm";
+
+  ofstream kernelFile(kernel);
+  kernelFile << "KPL/FK\n"
+             << "\\begindata\n"
+             << "TK_META_LIST += 2\n"
+             << "TK_META_NAME  = 'listed'\n";
+  kernelFile.close();
+
+  // a path continued with '+' and given by a symbol
+  string dir = tempDir.string();
+  ofstream metaFile(meta);
+  metaFile << "KPL/MK\n"
+           << "\\begindata\n"
+           << "TK_META_LIST  = 1\n"
+           << "TK_META_NAME  = 'meta'\n"
+           << "PATH_SYMBOLS  = 'DIR'\n"
+           << "PATH_VALUES   = ( '" << dir.substr(0, dir.size() / 2) << "+'\n"
+           << "                  '" << dir.substr(dir.size() / 2) << "' )\n"
+           << "KERNELS_TO_LOAD = ( '$DIR/listed.tf' )\n";
+  metaFile.close();
+
+  // the meta-kernel's keywords are replaced by those of the kernels it lists
+  nlohmann::json native = findTextKernelKeywords("*", {meta.string()});
+  EXPECT_EQ(native["TK_META_LIST"], nlohmann::json({1.0, 2.0}));
+  EXPECT_EQ(native["TK_META_NAME"], "listed");
+  EXPECT_FALSE(native.contains("KERNELS_TO_LOAD"));
+  EXPECT_FALSE(native.contains("PATH_VALUES"));
+
+  nlohmann::json kernels;
+  kernels["kernels"] = {{meta.string()}};
+  KernelSet kset(kernels);
+  EXPECT_EQ(findTextKernelKeywords("TK_META_*", {meta.string()}), findKeywords("TK_META_*"));
+  EXPECT_TRUE(findKeywords("KERNELS_TO_LOAD").is_null());
+}
+
+
+TEST_F(TempTestingFiles, UnitTestLoadTextKernelCache) {
+  fs::path path = tempDir / "cached.tf";
+  ofstream(path) << "\\begindata\nTK_CACHED = 1\n";
+
+  auto first = loadTextKernel(path.string());
+  EXPECT_EQ(first.get(), loadTextKernel(path.string()).get());
+
+  // a new modification time invalidates the entry
+  ofstream(path) << "\\begindata\nTK_CACHED = 2\n";
+  fs::last_write_time(path, fs::last_write_time(path) + chrono::seconds(5));
+  auto second = loadTextKernel(path.string());
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_EQ(second->at(0).values, nlohmann::json({2.0}));
+
+  vector<thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 100; j++) {
+        EXPECT_EQ(findTextKernelKeywords("TK_CACHED", {path.string()})["TK_CACHED"], 2.0);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+}
+
+
+TEST(TextKernelTests, UnitTestKeywordTemplates) {
+  EXPECT_TRUE(matchesKeywordTemplate("INS-85600_*", "INS-85600_CCD_CENTER"));
+  EXPECT_TRUE(matchesKeywordTemplate("*_CCD_*", "INS-85600_CCD_CENTER"));
+  EXPECT_TRUE(matchesKeywordTemplate("INS-8560%_CCD_CENTER", "INS-85600_CCD_CENTER"));
+  EXPECT_TRUE(matchesKeywordTemplate("*", "ANY"));
+  EXPECT_FALSE(matchesKeywordTemplate("INS-8560%", "INS-856000"));
+  EXPECT_FALSE(matchesKeywordTemplate("ins-85600_*", "INS-85600_CCD_CENTER"));
+
+  double seconds;
+  EXPECT_TRUE(textKernelDateToSeconds("@2000-JAN-01/12:00", seconds));
+  EXPECT_DOUBLE_EQ(seconds, 0);
+  EXPECT_TRUE(textKernelDateToSeconds("@1972-JAN-1", seconds));
+  EXPECT_DOUBLE_EQ(seconds, -883656000);
+  EXPECT_FALSE(textKernelDateToSeconds("@yesterday", seconds));
+}
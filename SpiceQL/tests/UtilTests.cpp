@@ -5,6 +5,7 @@
 #include <fstream>
 #include <utility>
 #include <algorithm>
+#include <numeric>
 #include <set>
 
 using namespace std::chrono;
@@ -472,6 +473,66 @@ TEST_F(GetRestUrlTest, HandlesEmptyEnvVar) {
 }
 
 
+TEST_F(EnvVar, GetRestMaxConnections) {
+  clear("SPICEQL_REST_MAX_CONNECTIONS");
+  EXPECT_EQ(getRestMaxConnections(), 8);
+
+  set("SPICEQL_REST_MAX_CONNECTIONS", "3");
+  EXPECT_EQ(getRestMaxConnections(), 3);
+
+  set("SPICEQL_REST_MAX_CONNECTIONS", "0");
+  EXPECT_EQ(getRestMaxConnections(), 1);
+
+  set("SPICEQL_REST_MAX_CONNECTIONS", "many");
+  EXPECT_EQ(getRestMaxConnections(), 8);
+}
+
+
+TEST(UtilTests, SplitEtBatches) {
+  vector<double> ets(1000);
+  iota(ets.begin(), ets.end(), 0.0);
+
+  vector<vector<double>> batches = splitEtBatches(ets, 150, 8);
+  ASSERT_EQ(batches.size(), 7);
+  EXPECT_EQ(batches.front().size(), 150);
+  EXPECT_EQ(batches.back().size(), 100);
+
+  vector<double> joined;
+  for (auto &batch : batches) {
+    joined.insert(joined.end(), batch.begin(), batch.end());
+  }
+  EXPECT_EQ(joined, ets);
+
+  // more ETs than maxBatches full batches grows the batches instead
+  batches = splitEtBatches(ets, 100, 4);
+  ASSERT_EQ(batches.size(), 4);
+  EXPECT_EQ(batches.front().size(), 250);
+
+  EXPECT_EQ(splitEtBatches({1, 2, 3}, 150, 8).size(), 1);
+  EXPECT_TRUE(splitEtBatches({}, 150, 8).empty());
+}
+
+
+TEST(UtilTests, MergeBatchKernels) {
+  nlohmann::json kernels = {{"ck", {"a.bc", "b.bc"}}, {"ck_quality", "reconstructed"},
+                                  {"lro_ck_coverage", {{"gaps", {{10.0, 20.0}, {30.0, 40.0}}}}}};
+  nlohmann::json batch = {{"ck", {"b.bc", "c.bc"}}, {"ck_quality", "reconstructed"},
+                                {"lro_ck_coverage", {{"gaps", {{40.0, 50.0}, {60.0, 70.0}}}}},
+                                {"lro_spk_coverage", {{"gaps", nlohmann::json::array()}}}};
+  mergeBatchKernels(kernels, batch);
+
+  EXPECT_EQ(kernels["ck"], nlohmann::json({"a.bc", "b.bc", "c.bc"}));
+  EXPECT_EQ(kernels["ck_quality"], "reconstructed");
+  // every batch's gaps are kept, touching ones are joined
+  EXPECT_EQ(kernels["lro_ck_coverage"]["gaps"], nlohmann::json({{10.0, 20.0}, {30.0, 50.0}, {60.0, 70.0}}));
+  EXPECT_EQ(kernels["lro_spk_coverage"]["gaps"], nlohmann::json::array());
+
+  nlohmann::json empty;
+  mergeBatchKernels(empty, batch);
+  EXPECT_EQ(empty, batch);
+}
+
+
 static vector<std::pair<string, string>> loadAliasPairs() {
   vector<std::pair<string, string>> pairs;
 
@@ -551,6 +612,49 @@ TEST_F(InferMissionAlias, FrameCacheGeneratedCorrectly) {
 }
 
 
+TEST_F(InferMissionAlias, TkFrameEdgesCached) {
+  EXPECT_EQ(Inventory::getFrameInfoFromCache(-85990, "lro"), vector<int>({-85, 4, -85990}));
+
+  auto [parent, rotation] = Inventory::getTkFrameFromCache(-85990, "lro");
+  EXPECT_EQ(parent, 1);
+  ASSERT_EQ(rotation.size(), 9);
+  EXPECT_NEAR(rotation[0], 1.0, 1e-12);
+  EXPECT_NEAR(rotation[4], 0.0, 1e-12);
+  EXPECT_NEAR(rotation[8], 0.0, 1e-12);
+
+  // Not a TK frame
+  EXPECT_EQ(Inventory::getTkFrameFromCache(-85600, "lro").first, 0);
+
+  // A constant chain traces from the cache without any kernels
+  auto [trace, kernels] = frameTrace(0, -85990, "lro", {"smithed", "reconstructed"}, {"smithed", "reconstructed"}, false, false);
+  EXPECT_EQ(trace[0], vector<int>({1}));
+  EXPECT_EQ(trace[1], vector<int>({-85990, 1}));
+}
+
+
+TEST_F(InferMissionAlias, TkFrameEdgesCachedPerMission) {
+  // both FKs define the same frame info for TEST_SHARED_TK
+  EXPECT_EQ(Inventory::getFrameInfoFromCache(-99990, "mro"), vector<int>({399, 4, -99990}));
+  EXPECT_EQ(Inventory::getFrameInfoFromCache(-99990, "lro"), vector<int>({399, 4, -99990}));
+  EXPECT_EQ(Inventory::getFrameInfoFromCache(-99990, ""), vector<int>({399, 4, -99990}));
+
+  // but rotate it differently, each mission gets its own edge
+  auto [mroParent, mroRotation] = Inventory::getTkFrameFromCache(-99990, "mro");
+  EXPECT_EQ(mroParent, 1);
+  ASSERT_EQ(mroRotation.size(), 9);
+  EXPECT_NEAR(mroRotation[4], 1.0, 1e-12);
+
+  auto [lroParent, lroRotation] = Inventory::getTkFrameFromCache(-99990, "lro");
+  EXPECT_EQ(lroParent, 1);
+  ASSERT_EQ(lroRotation.size(), 9);
+  EXPECT_NEAR(lroRotation[4], 0.0, 1e-12);
+
+  // a mission whose kernels do not define it misses instead of getting either
+  EXPECT_EQ(Inventory::getTkFrameFromCache(-99990, "").first, 0);
+  EXPECT_EQ(Inventory::getTkFrameFromCache(-99990, "not_a_mission").first, 0);
+}
+
+
 TEST_F(LroKernelSet, EmptyInputsReturnEmpty) {
   EXPECT_EQ(inferMission({}, {}), "");
   EXPECT_EQ(inferMission({""}, {}), "");
@@ -604,6 +708,29 @@ TEST_F(InferMissionFromCode, InstrumentCodeFallsBackToBusCode) {
 }
 
 
+TEST_F(InferMissionFromCode, CodeTableFollowsAliasChanges) {
+  EXPECT_EQ(inferMission({}, {-85}), "lro");
+
+  AliasMap::instance().addAliasKey("LRO", "test_mission");
+  EXPECT_EQ(inferMission({}, {-85}), "test_mission");
+  EXPECT_EQ(inferMission({}, {-85999}), "test_mission");
+
+  load_aliases((fs::path(_SOURCE_PREFIX) / "SpiceQL" / "aliasMap.json").string());
+  EXPECT_EQ(inferMission({}, {-85}), "lro");
+}
+
+
+TEST_F(InferMissionFromCode, CodeCandidatesKeepTheirOrder) {
+  // 499 is only known to NAIF's built-in bodies, -85 is in the code table.
+  // Whichever comes first wins.
+  AliasMap::instance().addAliasKey("MARS", "test_mission");
+  EXPECT_EQ(inferMission({}, {499, -85}), "test_mission");
+  EXPECT_EQ(inferMission({}, {-85, 499}), "lro");
+
+  load_aliases((fs::path(_SOURCE_PREFIX) / "SpiceQL" / "aliasMap.json").string());
+}
+
+
 TEST_F(InferMissionFromCode, ZeroCodeSkipped) {
   EXPECT_EQ(inferMission({}, {0}), "");
 }
@@ -613,3 +740,11 @@ TEST_F(InferMissionFromCode, NameCandidateTakesPrecedenceOverCode) {
   // String candidates are tried before codes.
   EXPECT_EQ(inferMission({"MRO_CTX"}, {-85}), "ctx");
 }
+
+
+TEST(UtilTests, mergeTimeIntervals) {
+  std::vector<std::pair<double, double>> intervals = {{30, 40}, {10, 20}, {15, 25}, {40, 45}, {60, 50}, {70, 80}};
+  std::vector<std::pair<double, double>> expected = {{10, 25}, {30, 45}, {70, 80}};
+  EXPECT_EQ(mergeTimeIntervals(intervals), expected);
+  EXPECT_TRUE(mergeTimeIntervals({}).empty());
+}
@@ -13,23 +13,281 @@
 
 %{
   #include <array>
+  #include <cstring>
   #include <vector> 
   #include <nlohmann/json.hpp>
+
+  // True if obj is a 1D contiguous float64 buffer, like a NumPy array, whose
+  // values are then copied into out (if not NULL) with one memcpy. Returns
+  // false without an error set if obj is not one.
+  static bool doublesFromBuffer(PyObject *obj, std::vector<double> *out) {
+    if (!PyObject_CheckBuffer(obj)) {
+      return false;
+    }
+    Py_buffer view;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+      PyErr_Clear();
+      return false;
+    }
+    bool isDoubles = view.ndim == 1 && view.itemsize == sizeof(double) && view.format != NULL &&
+                     (strcmp(view.format, "d") == 0 || strcmp(view.format, "<d") == 0 || strcmp(view.format, "=d") == 0);
+    if (isDoubles && out != NULL) {
+      out->resize(view.len / sizeof(double));
+      if (!out->empty()) {
+        memcpy(out->data(), view.buf, view.len);
+      }
+    }
+    PyBuffer_Release(&view);
+    return isDoubles;
+  }
+
+  // A float64 NumPy array of shape (rows, cols) filled from data, or NULL
+  // without an error set if NumPy is not installed.
+  static PyObject *numpyArray(const std::vector<const std::vector<double> *> &rowData, Py_ssize_t rows, Py_ssize_t cols, bool twoDimensional) {
+    PyObject *numpy = PyImport_ImportModule("numpy");
+    if (numpy == NULL) {
+      PyErr_Clear();
+      return NULL;
+    }
+    // a bytearray keeps the array writable, unlike bytes
+    PyObject *buffer = PyByteArray_FromStringAndSize(NULL, rows * cols * sizeof(double));
+    if (buffer == NULL) {
+      Py_DECREF(numpy);
+      return NULL;
+    }
+    char *bytes = PyByteArray_AS_STRING(buffer);
+    for (Py_ssize_t i = 0; i < (Py_ssize_t)rowData.size(); i++) {
+      memcpy(bytes + i * cols * sizeof(double), rowData[i]->data(), rowData[i]->size() * sizeof(double));
+    }
+    PyObject *flat = PyObject_CallMethod(numpy, "frombuffer", "Os", buffer, "float64");
+    Py_DECREF(buffer);
+    Py_DECREF(numpy);
+    if (flat == NULL || !twoDimensional) {
+      return flat;
+    }
+    PyObject *array = PyObject_CallMethod(flat, "reshape", "nn", rows, cols);
+    Py_DECREF(flat);
+    return array;
+  }
+
+  // NumPy array of the values, a list if NumPy is not installed
+  static PyObject *doubleArray(const std::vector<double> &values) {
+    PyObject *array = numpyArray({&values}, 1, values.size(), false);
+    if (array != NULL || PyErr_Occurred()) {
+      return array;
+    }
+    PyObject *list = PyList_New(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      PyList_SetItem(list, i, PyFloat_FromDouble(values[i]));
+    }
+    return list;
+  }
+
+  // 2D NumPy array of the rows, nested lists if NumPy is not installed or the
+  // rows differ in length
+  static PyObject *doubleArray(const std::vector<std::vector<double>> &values) {
+    size_t cols = values.empty() ? 0 : values[0].size();
+    bool rectangular = true;
+    std::vector<const std::vector<double> *> rowData;
+    rowData.reserve(values.size());
+    for (const std::vector<double> &row : values) {
+      rectangular = rectangular && row.size() == cols;
+      rowData.push_back(&row);
+    }
+    if (rectangular) {
+      PyObject *array = numpyArray(rowData, values.size(), cols, true);
+      if (array != NULL || PyErr_Occurred()) {
+        return array;
+      }
+    }
+    PyObject *outer = PyList_New(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      PyObject *inner = PyList_New(values[i].size());
+      for (size_t j = 0; j < values[i].size(); ++j) {
+        PyList_SetItem(inner, j, PyFloat_FromDouble(values[i][j]));
+      }
+      PyList_SetItem(outer, i, inner);
+    }
+    return outer;
+  }
+
+  // Builds the Python equivalent of j, what json.loads(j.dump()) would give.
+  // Returns a new reference, or NULL with an error set.
+  static PyObject *jsonToPy(const nlohmann::json &j) {
+    switch (j.type()) {
+      case nlohmann::json::value_t::boolean:
+        return PyBool_FromLong(j.get<bool>());
+      case nlohmann::json::value_t::number_integer:
+        return PyLong_FromLongLong(j.get<long long>());
+      case nlohmann::json::value_t::number_unsigned:
+        return PyLong_FromUnsignedLongLong(j.get<unsigned long long>());
+      case nlohmann::json::value_t::number_float:
+        return PyFloat_FromDouble(j.get<double>());
+      case nlohmann::json::value_t::string: {
+        const std::string &str = j.get_ref<const std::string&>();
+        return PyUnicode_DecodeUTF8(str.data(), str.size(), NULL);
+      }
+      case nlohmann::json::value_t::binary: {
+        const nlohmann::json::binary_t &bytes = j.get_binary();
+        return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+      }
+      case nlohmann::json::value_t::array: {
+        PyObject *list = PyList_New(j.size());
+        if (list == NULL) {
+          return NULL;
+        }
+        Py_ssize_t i = 0;
+        for (const nlohmann::json &element : j) {
+          PyObject *item = jsonToPy(element);
+          if (item == NULL) {
+            Py_DECREF(list);
+            return NULL;
+          }
+          PyList_SET_ITEM(list, i++, item);
+        }
+        return list;
+      }
+      case nlohmann::json::value_t::object: {
+        PyObject *dict = PyDict_New();
+        if (dict == NULL) {
+          return NULL;
+        }
+        for (auto it = j.begin(); it != j.end(); ++it) {
+          PyObject *key = PyUnicode_DecodeUTF8(it.key().data(), it.key().size(), NULL);
+          PyObject *value = key == NULL ? NULL : jsonToPy(it.value());
+          int res = value == NULL ? -1 : PyDict_SetItem(dict, key, value);
+          Py_XDECREF(key);
+          Py_XDECREF(value);
+          if (res != 0) {
+            Py_DECREF(dict);
+            return NULL;
+          }
+        }
+        return dict;
+      }
+      default:
+        Py_RETURN_NONE;
+    }
+  }
+
+  // Converts dicts, lists, tuples, str, int, float, bool and None to json,
+  // what json::parse(json.dumps(obj)) would give. Returns false with an
+  // error set if obj holds anything else.
+  static bool pyToJson(PyObject *obj, nlohmann::json &out) {
+    if (obj == Py_None) {
+      out = nullptr;
+    }
+    else if (PyBool_Check(obj)) {
+      out = obj == Py_True;
+    }
+    else if (PyLong_Check(obj)) {
+      int overflow = 0;
+      long long value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+      if (overflow > 0) {
+        unsigned long long unsignedValue = PyLong_AsUnsignedLongLong(obj);
+        if (PyErr_Occurred()) {
+          return false;
+        }
+        out = unsignedValue;
+      }
+      else if (overflow < 0) {
+        PyErr_SetString(PyExc_OverflowError, "int too small to convert to json");
+        return false;
+      }
+      else if (value == -1 && PyErr_Occurred()) {
+        return false;
+      }
+      else {
+        out = value;
+      }
+    }
+    else if (PyFloat_Check(obj)) {
+      out = PyFloat_AS_DOUBLE(obj);
+    }
+    else if (PyUnicode_Check(obj)) {
+      Py_ssize_t size;
+      const char *str = PyUnicode_AsUTF8AndSize(obj, &size);
+      if (str == NULL) {
+        return false;
+      }
+      out = std::string(str, size);
+    }
+    else if (PyList_Check(obj) || PyTuple_Check(obj)) {
+      if (Py_EnterRecursiveCall(" while converting to json")) {
+        return false;
+      }
+      Py_ssize_t size = PySequence_Fast_GET_SIZE(obj);
+      PyObject **items = PySequence_Fast_ITEMS(obj);
+      out = nlohmann::json::array();
+      for (Py_ssize_t i = 0; i < size; i++) {
+        nlohmann::json element;
+        if (!pyToJson(items[i], element)) {
+          Py_LeaveRecursiveCall();
+          return false;
+        }
+        out.push_back(std::move(element));
+      }
+      Py_LeaveRecursiveCall();
+    }
+    else if (PyDict_Check(obj)) {
+      if (Py_EnterRecursiveCall(" while converting to json")) {
+        return false;
+      }
+      out = nlohmann::json::object();
+      PyObject *key, *value;
+      Py_ssize_t pos = 0;
+      while (PyDict_Next(obj, &pos, &key, &value)) {
+        Py_ssize_t size;
+        const char *keyStr = PyUnicode_Check(key) ? PyUnicode_AsUTF8AndSize(key, &size) : NULL;
+        if (keyStr == NULL) {
+          if (!PyErr_Occurred()) {
+            PyErr_Format(PyExc_TypeError, "keys must be str, not %s", Py_TYPE(key)->tp_name);
+          }
+          Py_LeaveRecursiveCall();
+          return false;
+        }
+        if (!pyToJson(value, out[std::string(keyStr, size)])) {
+          Py_LeaveRecursiveCall();
+          return false;
+        }
+      }
+      Py_LeaveRecursiveCall();
+    }
+    else {
+      PyErr_Format(PyExc_TypeError, "Object of type %s is not JSON serializable", Py_TYPE(obj)->tp_name);
+      return false;
+    }
+    return true;
+  }
+
+  // Builds the (value, kernels) tuple the API functions return, stealing
+  // value. Returns NULL with an error set, value released, on failure.
+  static PyObject *resultTuple(PyObject *value, const nlohmann::json &kernels) {
+    if (value == NULL) {
+      return NULL;
+    }
+    PyObject *pyKernels = jsonToPy(kernels);
+    if (pyKernels == NULL) {
+      Py_DECREF(value);
+      return NULL;
+    }
+    PyObject *tuple = PyTuple_Pack(2, value, pyKernels);
+    Py_DECREF(value);
+    Py_DECREF(pyKernels);
+    return tuple;
+  }
 %}
 
 %template(DoublePair) std::pair<double, double>;
 
 %typemap(in) nlohmann::json {
-  if (PyDict_Check($input) || PyList_Check($input)) {
-    PyObject* module = PyImport_ImportModule("json");
-    PyObject* jsonDumps = PyUnicode_FromString("dumps");
-    PyObject* pythonJsonString = PyObject_CallMethodObjArgs(module, jsonDumps, $input, NULL);
-    $1 = nlohmann::json::parse(PyUnicode_AsUTF8(pythonJsonString));
-  }
-  else {
+  if (!PyDict_Check($input) && !PyList_Check($input)) {
     PyErr_SetString(PyExc_TypeError, "not a json serializable type");
     SWIG_fail;
   }
+  if (!pyToJson($input, $1)) {
+    SWIG_fail;
+  }
 }
 
 %typemap(typecheck, precedence=SWIG_TYPECHECK_MAP) nlohmann::json {
@@ -37,54 +295,36 @@
 }
 
 %typemap(out) nlohmann::json {
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-  std::string jsonString = ($1).dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-  $result = PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL);
+  $result = jsonToPy($1);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
 %typemap(out) nlohmann::json& {
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-  std::string jsonString = ($1)->dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-  $result = PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL);
+  $result = jsonToPy(*$1);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
-%typemap(in) nlohmann::json& {
-  if (PyDict_Check($input) || PyList_Check($input)) {
-    PyObject* module = PyImport_ImportModule("json");
-    PyObject* jsonDumps = PyUnicode_FromString("dumps");
-    PyObject* pythonJsonString = PyObject_CallMethodObjArgs(module, jsonDumps, $input, NULL);
-    $1 = new nlohmann::json(nlohmann::json::parse(PyUnicode_AsUTF8(pythonJsonString)));
-  }
-  else {
+%typemap(in) nlohmann::json& (nlohmann::json temp) {
+  if (!PyDict_Check($input) && !PyList_Check($input)) {
     PyErr_SetString(PyExc_TypeError, "not a json serializable type");
     SWIG_fail;
   }
+  if (!pyToJson($input, temp)) {
+    SWIG_fail;
+  }
+  $1 = &temp;
 }
 
 // pair<vector<vector<double>>, json>
-%typemap(out) std::pair<std::vector<std::vector<double>>, nlohmann::json> (PyObject* _inner,PyObject* _outer) {
-  _outer = PyList_New($1.first.size());
-  for (size_t i = 0; i < $1.first.size(); ++i) {
-    _inner = PyList_New($1.first[i].size());
-    for (size_t j = 0; j < $1.first[i].size(); ++j){
-      PyList_SetItem(_inner,j,PyFloat_FromDouble($1.first[i][j]));
-    }
-    PyList_SetItem(_outer,i,_inner);
+%typemap(out) std::pair<std::vector<std::vector<double>>, nlohmann::json> {
+  $result = resultTuple(doubleArray($1.first), $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
   }
-
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-
-  std::string jsonString = $1.second.dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0, _outer);
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL));
 }
 
 // pair<vector<vector<int>>, json>
@@ -98,33 +338,18 @@
     PyList_SetItem(_outer,i,_inner);
   }
 
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-
-  std::string jsonString = $1.second.dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0, _outer);
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL));
+  $result = resultTuple(_outer, $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
 // pair<vector<double>, json>
 %typemap(out) std::pair<std::vector<double>, nlohmann::json> {
-  PyObject* vec_list = PyList_New($1.first.size());
-  for (size_t i = 0; i < $1.first.size(); ++i) {
-      PyList_SetItem(vec_list, i, PyFloat_FromDouble($1.first[i]));
+  $result = resultTuple(doubleArray($1.first), $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
   }
-
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-
-  std::string jsonString = $1.second.dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0, vec_list);
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL));
 }
 
 // pair<vector<int>, json>
@@ -134,75 +359,55 @@
       PyList_SetItem(vec_list, i, PyInt_FromLong($1.first[i]));
   }
 
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
+  $result = resultTuple(vec_list, $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
+}
 
-  std::string jsonString = $1.second.dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
+// pair<vector<string>, json>
+%typemap(out) std::pair<std::vector<std::string>, nlohmann::json> {
+  PyObject* vec_list = PyList_New($1.first.size());
+  for (size_t i = 0; i < $1.first.size(); ++i) {
+      PyList_SetItem(vec_list, i, PyUnicode_DecodeUTF8($1.first[i].c_str(), $1.first[i].size(), NULL));
+  }
 
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0, vec_list);
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL));
+  $result = resultTuple(vec_list, $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
 // pair<double, json>
 %typemap(out) std::pair<double, nlohmann::json> {
-  PyObject* dblOut = PyFloat_FromDouble($1.first);
-
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-
-  std::string jsonString = $1.second.dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0, dblOut);
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL));
+  $result = resultTuple(PyFloat_FromDouble($1.first), $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
 // pair<int, json>
 %typemap(out) std::pair<int, nlohmann::json> {
-  PyObject* intOut = PyInt_FromLong($1.first);
-
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-
-  std::string jsonString = $1.second.dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0, intOut);
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL));
+  $result = resultTuple(PyInt_FromLong($1.first), $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
 // pair<string, json>
 %typemap(out) std::pair<std::string, nlohmann::json> {
-  PyObject* strOut = PyString_FromString($1.first.c_str());
-
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-
-  std::string jsonString = $1.second.dump();
-  PyObject* pythonJsonString = PyUnicode_DecodeUTF8(jsonString.c_str(), jsonString.size(), NULL);
-
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0, strOut);
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString, NULL));
+  $result = resultTuple(PyString_FromString($1.first.c_str()), $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
 // pair<json, json>
 %typemap(out) std::pair<nlohmann::json, nlohmann::json> {
-  PyObject* module = PyImport_ImportModule("json");
-  PyObject* jsonLoads = PyUnicode_FromString("loads");
-
-  std::string jsonString1 = $1.first.dump();
-  std::string jsonString2 = $1.second.dump();
-  PyObject* pythonJsonString1 = PyUnicode_DecodeUTF8(jsonString1.c_str(), jsonString1.size(), NULL);
-  PyObject* pythonJsonString2 = PyUnicode_DecodeUTF8(jsonString2.c_str(), jsonString2.size(), NULL);
-
-  $result = PyTuple_New(2);
-  PyTuple_SetItem($result, 0,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString1, NULL));
-  PyTuple_SetItem($result, 1,  PyObject_CallMethodObjArgs(module, jsonLoads, pythonJsonString2, NULL));
+  $result = resultTuple(jsonToPy($1.first), $1.second);
+  if ($result == NULL) {
+    SWIG_fail;
+  }
 }
 
 namespace std {
@@ -217,6 +422,32 @@ namespace std {
   %template(DoubleArray6) array<double, 6>;
 }
 
+// ET and SCLK lists, NumPy float64 arrays are copied in one go. Other
+// sequences of floats are converted element by element, bytes are not ETs
+// even though they are a sequence of ints.
+%typemap(in) std::vector<double> ets (std::vector<double> *ptr = 0, int res = 0),
+             std::vector<double> sclks (std::vector<double> *ptr = 0, int res = 0) {
+  if (PyBytes_Check($input) || PyByteArray_Check($input)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '$symname', argument $argnum of type '$type'");
+  }
+  if (!doublesFromBuffer($input, &$1)) {
+    res = swig::asptr($input, &ptr);
+    if (!SWIG_IsOK(res) || !ptr) {
+      SWIG_exception_fail(SWIG_ArgError(res), "in method '$symname', argument $argnum of type '$type'");
+    }
+    $1 = *ptr;
+    if (SWIG_IsNewObj(res)) {
+      delete ptr;
+    }
+  }
+}
+
+// accepts exactly what the in typemap accepts
+%typemap(typecheck, precedence=SWIG_TYPECHECK_DOUBLE_ARRAY) std::vector<double> ets, std::vector<double> sclks {
+  $1 = !PyBytes_Check($input) && !PyByteArray_Check($input) &&
+       (doublesFromBuffer($input, NULL) || SWIG_IsOK(swig::asptr($input, (std::vector<double>**)0))) ? 1 : 0;
+}
+
 %exception {
   try {
     $action
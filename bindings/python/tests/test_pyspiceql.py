@@ -1,3 +1,9 @@
+import json
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
 import pytest
 import pyspiceql
 from pyspiceql import getMissionConfig, Config, getKernelStringValue
@@ -8,6 +14,13 @@ def test_jsonConversion():
     kernel_list = lro_config["lro"]["iak"]["kernels"]
     assert isinstance(kernel_list, list)
 
+def test_jsonRoundTrip():
+    conf = {"mission": {"ck": {"kernels": ["a.bc", "b.bc"], "quality": None},
+                        "values": [1, -2, 2**63, 1.25, True, False]}}
+    assert Config(conf, "").globalConf() == conf
+    with pytest.raises(TypeError):
+        Config({"mission": object()}, "")
+
 def test_config():
     global_config = Config()
     lro_config = global_config['lro']
@@ -16,3 +29,103 @@ def test_exception():
     with pytest.raises(RuntimeError):
         getKernelStringValue("bad_terrible_no_good_key")
 
+
+@pytest.fixture
+def rest_service(monkeypatch):
+    """A local REST service that answers every query with its response and keeps each query's args"""
+    class Handler(BaseHTTPRequestHandler):
+        def answer(self, args):
+            service.queries.append(args)
+            body = json.dumps({"statusCode": 200, "body": service.response}).encode()
+            self.send_response(200)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def do_GET(self):
+            # string values come without their quotes
+            args = {}
+            for key, values in parse_qs(urlparse(self.path).query).items():
+                try:
+                    args[key] = json.loads(values[0])
+                except ValueError:
+                    args[key] = values[0]
+            self.answer(args)
+
+        def do_POST(self):
+            self.answer(json.loads(self.rfile.read(int(self.headers["Content-Length"]))))
+
+        def log_message(self, *args):
+            pass
+
+    service = ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+    service.queries = []
+    service.response = {"return": [], "kernels": {}}
+    thread = threading.Thread(target=service.serve_forever, daemon=True)
+    thread.start()
+    monkeypatch.setenv("SPICEQL_REST_URL", f"http://127.0.0.1:{service.server_address[1]}/")
+    yield service
+    service.shutdown()
+    service.server_close()
+    thread.join()
+
+def test_numpyArrays(rest_service):
+    np = pytest.importorskip("numpy")
+    states = [[float(i), 2.0, 3.0, 4.0, 5.0, 6.0, 7.0] for i in range(3)]
+    rest_service.response = {"return": states, "kernels": {"spk": ["a.bsp"]}}
+
+    # float64 arrays are passed as is, other sequences of floats still work
+    for ets in [np.array([1.5, 2.5, 3.5]), np.arange(0, 7, dtype=np.float64)[1::2], [1.5, 2.5, 3.5]]:
+        result, kernels = pyspiceql.getTargetStates(ets, "LRO", "MOON", "J2000", "NONE", "lro", useWeb=True)
+        assert rest_service.queries[-1]["ets"] == list(ets)
+        assert isinstance(result, np.ndarray)
+        assert result.dtype == np.float64
+        assert result.shape == (3, 7)
+        assert result.tolist() == states
+        assert kernels == {"spk": ["a.bsp"]}
+
+    # int arrays and bytes are not ETs
+    for ets in [np.array([1, 2, 3]), np.array([1.5, 2.5], dtype=np.float32), b"\x00" * 16, bytearray(16)]:
+        with pytest.raises(TypeError):
+            pyspiceql.getTargetStates(ets, "LRO", "MOON", "J2000", "NONE", "lro", useWeb=True)
+
+    # empty results are arrays too, no longer []
+    rest_service.response = {"return": [], "kernels": {}}
+    result, _ = pyspiceql.getTargetStates(np.array([1.5]), "LRO", "MOON", "J2000", "NONE", "lro", useWeb=True)
+    assert isinstance(result, np.ndarray)
+    assert result.dtype == np.float64
+    assert result.shape == (0, 0)
+
+    result, _ = pyspiceql.utcToEtBatch([])
+    assert isinstance(result, np.ndarray)
+    assert result.dtype == np.float64
+    assert result.shape == (0,)
+
+def test_gilReleased(rest_service):
+    # the service answering on a Python thread while the call waits for it,
+    # and other threads running meanwhile, need the call to release the GIL
+    answered = threading.Event()
+    ticks = []
+    def tick():
+        while not answered.is_set():
+            ticks.append(time.monotonic())
+            time.sleep(0.001)
+
+    rest_service.response = {"return": 1.5, "kernels": {}}
+    handle = rest_service.RequestHandlerClass.answer
+    def slowAnswer(self, args):
+        time.sleep(0.2)
+        handle(self, args)
+    rest_service.RequestHandlerClass.answer = slowAnswer
+
+    ticker = threading.Thread(target=tick)
+    ticker.start()
+    start = time.monotonic()
+    result, _ = pyspiceql.utcToEt("2016-12-31T23:59:59", useWeb=True)
+    stop = time.monotonic()
+    answered.set()
+    ticker.join()
+
+    assert result == 1.5
+    assert len([t for t in ticks if start + 0.05 < t < stop - 0.05]) > 10
@@ -3,8 +3,11 @@
 from .models import *
 
 from typing import Annotated
-from fastapi import FastAPI, Depends, Body
+from fastapi import FastAPI, Depends, Body, Request, Response
+from fastapi.middleware.gzip import GZipMiddleware
+import json
 import os
+import msgpack
 import pyspiceql
 import logging
 import h5py
@@ -12,11 +15,76 @@ import h5py
 
 logger = logging.getLogger(__name__)
 
+MSGPACK_MEDIA_TYPE = "application/msgpack"
+
 # Create FastAPI instance
 app = FastAPI()
 
+
+def dbVersionTag():
+    """Weak ETag of the kernel DB, from the DB file's modification time and size.
+
+    It changes whenever the DB file is regenerated. Kernel files changed in the
+    data directory without regenerating the DB keep the old tag.
+    """
+    try:
+        stat = os.stat(pyspiceql.getDbFilePath())
+    except (OSError, TypeError):
+        return None
+    return f'W/"{stat.st_mtime_ns:x}-{stat.st_size:x}"'
+
+
+@app.middleware("http")
+async def tagDbVersion(request: Request, call_next):
+    """Tag responses with the DB version and answer matching If-None-Match with 304.
+
+    Endpoints answer from the kernels the DB lists, so a client holding a
+    response with the current tag can keep using it without the query being
+    run again. The DB has to be regenerated after kernels in the data
+    directory are replaced for clients to see the change. Only GET and HEAD
+    get a 304, other methods get 412 as RFC 9110 requires.
+    """
+    tag = dbVersionTag() if request.url.path != "/" else None
+    if tag is not None and tag in request.headers.get("if-none-match", ""):
+        status = 304 if request.method in ("GET", "HEAD") else 412
+        return Response(status_code=status, headers={"ETag": tag})
+
+    response = await call_next(request)
+    if tag is not None and response.status_code == 200:
+        response.headers["ETag"] = tag
+    return response
+
+
+@app.middleware("http")
+async def negotiateMsgpack(request: Request, call_next):
+    """Re-encode JSON responses as MessagePack for clients that accept it.
+
+    States and orientations stay binary doubles instead of decimal text,
+    which is several times smaller and much cheaper to parse.
+    """
+    response = await call_next(request)
+    if response.headers.get("content-type") != "application/json":
+        return response
+
+    # JSON responses also depend on Accept, caches must not hand them to msgpack clients
+    response.headers.add_vary_header("Accept")
+    if MSGPACK_MEDIA_TYPE not in request.headers.get("accept", ""):
+        return response
+
+    body = b"".join([chunk async for chunk in response.body_iterator])
+    headers = {key: value for key, value in response.headers.items()
+               if key not in ("content-length", "content-type")}
+    return Response(content=msgpack.packb(json.loads(body)),
+                    status_code=response.status_code,
+                    headers=headers,
+                    media_type=MSGPACK_MEDIA_TYPE)
+
+
+# Added last so it wraps the MessagePack encoding, kernel lists compress well
+app.add_middleware(GZipMiddleware, minimum_size=1000)
+
 @app.get("/")
-async def message():
+def message():
     try: 
       data_dir_exists = os.path.exists(pyspiceql.getDataDirectory())
       db_exists = os.path.exists(pyspiceql.getDbFilePath())
@@ -43,7 +111,7 @@ async def message():
 
 # SpiceQL endpoints
 @app.get("/getTargetStates")
-async def getTargetStates(
+def getTargetStates(
     target: Annotated[TargetParam, Depends()],
     observer: Annotated[ObserverParam, Depends()],
     frame: Annotated[FrameStrParam, Depends()],
@@ -78,7 +146,7 @@ async def getTargetStates(
     
     
 @app.post("/getTargetStates")
-async def getTargetStates(params: Annotated[TargetStatesRequestModel, Body(
+def getTargetStates(params: Annotated[TargetStatesRequestModel, Body(
     openapi_examples={
         "example": {
             "summary": "LROC Payload",
@@ -125,7 +193,7 @@ async def getTargetStates(params: Annotated[TargetStatesRequestModel, Body(
 
 
 @app.get("/getTargetStatesRanged")
-async def getTargetStatesRanged(
+def getTargetStatesRanged(
     target: Annotated[TargetParam, Depends()],
     observer: Annotated[ObserverParam, Depends()],
     frame: Annotated[FrameStrParam, Depends()],
@@ -163,7 +231,7 @@ async def getTargetStatesRanged(
         return ResponseModel(statusCode=500, body=body)
     
 @app.get("/getTargetOrientations")
-async def getTargetOrientations(
+def getTargetOrientations(
     toFrame: Annotated[ToFrameParam, Depends()],
     refFrame: Annotated[RefFrameParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
@@ -190,7 +258,7 @@ async def getTargetOrientations(
         return ResponseModel(statusCode=500, body=body)
 
 @app.post("/getTargetOrientations")
-async def getTargetOrientations(params: Annotated[TargetOrientationsRequestModel, Body(
+def getTargetOrientations(params: Annotated[TargetOrientationsRequestModel, Body(
     openapi_examples={
         "example": {
             "summary": "LROC Payload",
@@ -229,7 +297,7 @@ async def getTargetOrientations(params: Annotated[TargetOrientationsRequestModel
         return ResponseModel(statusCode=500, body=body)
 
 @app.get("/getTargetOrientationsRanged")
-async def getTargetOrientationsRanged(
+def getTargetOrientationsRanged(
     startEt: Annotated[StartEtParam, Depends()],
     stopEt: Annotated[StopEtParam, Depends()],
     numRecords: Annotated[NumRecordsParam, Depends()],
@@ -260,7 +328,7 @@ async def getTargetOrientationsRanged(
         return ResponseModel(statusCode=500, body=body)
 
 @app.get("/strSclkToEt")
-async def strSclkToEt(
+def strSclkToEt(
     frameCode: Annotated[FrameCodeParam, Depends()],
     sclk: Annotated[SclkStrParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
@@ -284,7 +352,7 @@ async def strSclkToEt(
 
 
 @app.get("/doubleSclkToEt")
-async def doubleSclkToEt(
+def doubleSclkToEt(
     frameCode: Annotated[FrameCodeParam, Depends()],
     sclk: Annotated[SclkDblParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
@@ -308,7 +376,7 @@ async def doubleSclkToEt(
 
 
 @app.get("/doubleEtToSclk")
-async def doubleEtToSclk(
+def doubleEtToSclk(
     frameCode: Annotated[FrameCodeParam, Depends()],
     et: Annotated[EtParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
@@ -330,8 +398,89 @@ async def doubleEtToSclk(
         body = ErrorModel(error=str(e))
         return ResponseModel(statusCode=500, body=body)
 
+@app.post("/strSclkToEtBatch")
+def strSclkToEtBatch(params: Annotated[SclkStrBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "LROC Payload",
+            "value": {"frameCode": -85, "sclks": ["1/281199081:48971", "1/281199082:48971"], "mission": "lro"}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.strSclkToEtBatch(
+            params.frameCode,
+            params.sclks,
+            params.mission,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
+
+@app.post("/doubleSclkToEtBatch")
+def doubleSclkToEtBatch(params: Annotated[SclkDblBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "LROC Payload",
+            "value": {"frameCode": -85, "sclks": [922997380.174174, 922997381.174174], "mission": "lro"}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.doubleSclkToEtBatch(
+            params.frameCode,
+            params.sclks,
+            params.mission,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
+
+@app.post("/doubleEtToSclkBatch")
+def doubleEtToSclkBatch(params: Annotated[EtToSclkBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "LROC Payload",
+            "value": {"frameCode": -85, "ets": [312625320.93, 312625321.93], "mission": "lro"}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.doubleEtToSclkBatch(
+            params.frameCode,
+            params.ets,
+            params.mission,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
+
 @app.get("/utcToEt")
-async def utcToEt(
+def utcToEt(
     utc: Annotated[UtcParam, Depends()],
     commonParams: Annotated[CommonParams, Depends()]):
     try:
@@ -350,7 +499,7 @@ async def utcToEt(
         return ResponseModel(statusCode=500, body=body)
 
 @app.get("/etToUtc")
-async def etToUtc(
+def etToUtc(
     et: Annotated[EtParam, Depends()],
     format: Annotated[FormatParam, Depends()],
     precision: Annotated[PrecisionParam, Depends()],
@@ -372,8 +521,58 @@ async def etToUtc(
         body = ErrorModel(error=str(e))
         return ResponseModel(statusCode=500, body=body)
 
+@app.post("/utcToEtBatch")
+def utcToEtBatch(params: Annotated[UtcToEtBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "UTC Payload",
+            "value": {"utcs": ["2016-11-26T22:32:14.582000", "2016-11-26T22:32:15.582000"]}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.utcToEtBatch(
+            params.utcs,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
+@app.post("/etToUtcBatch")
+def etToUtcBatch(params: Annotated[EtToUtcBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "ET Payload",
+            "value": {"ets": [533471602.76499087, 533471603.76499087], "format": "ISOC", "precision": 6}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.etToUtcBatch(
+            params.ets,
+            params.format,
+            params.precision,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
 @app.get("/translateNameToCode")
-async def translateNameToCode(
+def translateNameToCode(
     frame: Annotated[FrameStrParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
     commonParams: Annotated[CommonParams, Depends()]):
@@ -394,7 +593,7 @@ async def translateNameToCode(
         return ResponseModel(statusCode=500, body=body)
 
 @app.get("/translateCodeToName")
-async def translateCodeToName(
+def translateCodeToName(
     frame: Annotated[FrameIntParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
     commonParams: Annotated[CommonParams, Depends()]):
@@ -414,8 +613,58 @@ async def translateCodeToName(
         body = ErrorModel(error=str(e))
         return ResponseModel(statusCode=500, body=body)
 
+@app.post("/translateNameToCodeBatch")
+def translateNameToCodeBatch(params: Annotated[TranslateNameToCodeBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "Frame names Payload",
+            "value": {"frames": ["LRO_LROCNACL", "LRO_LROCWAC"], "mission": "lroc"}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.translateNameToCodeBatch(
+            params.frames,
+            params.mission,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
+@app.post("/translateCodeToNameBatch")
+def translateCodeToNameBatch(params: Annotated[TranslateCodeToNameBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "Frame codes Payload",
+            "value": {"frames": [-85600, -85620], "mission": "lroc"}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.translateCodeToNameBatch(
+            params.frames,
+            params.mission,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
 @app.get("/getFrameInfo")
-async def getFrameInfo(
+def getFrameInfo(
     frame: Annotated[FrameIntParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
     commonParams: Annotated[CommonParams, Depends()]):
@@ -435,8 +684,33 @@ async def getFrameInfo(
         body = ErrorModel(error=str(e))
         return ResponseModel(statusCode=500, body=body)
 
+@app.post("/getFrameInfoBatch")
+def getFrameInfoBatch(params: Annotated[GetFrameInfoBatchRequestModel, Body(
+    openapi_examples={
+        "example": {
+            "summary": "Frame codes Payload",
+            "value": {"frames": [-85600, -85620], "mission": "lroc"}
+        }
+    }
+)]):
+    try:
+        result, kernels = pyspiceql.getFrameInfoBatch(
+            params.frames,
+            params.mission,
+            False,
+            params.searchKernels,
+            params.fullKernelPath,
+            params.limitCk,
+            params.limitSpk,
+            params.kernelList)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
+
 @app.get("/getTargetFrameInfo")
-async def getTargetFrameInfo(
+def getTargetFrameInfo(
     targetId: Annotated[TargetIdParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
     commonParams: Annotated[CommonParams, Depends()]):
@@ -457,7 +731,7 @@ async def getTargetFrameInfo(
         return ResponseModel(statusCode=500, body=body)
 
 @app.get("/findMissionKeywords")
-async def findMissionKeywords(
+def findMissionKeywords(
     key: Annotated[KeyParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
     commonParams: Annotated[CommonParams, Depends()]):
@@ -478,7 +752,7 @@ async def findMissionKeywords(
         return ResponseModel(statusCode=500, body=body)
 
 @app.get("/findTargetKeywords")
-async def findTargetKeywords(
+def findTargetKeywords(
     key: Annotated[KeyParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
     commonParams: Annotated[CommonParams, Depends()]):
@@ -499,7 +773,7 @@ async def findTargetKeywords(
         return ResponseModel(statusCode=500, body=body)
 
 @app.get("/frameTrace")
-async def frameTrace(
+def frameTrace(
     et: Annotated[EtParam, Depends()],
     initialFrame: Annotated[InitialFrameParam, Depends()],
     mission: Annotated[MissionParam, Depends()],
@@ -526,7 +800,7 @@ async def frameTrace(
         return ResponseModel(statusCode=500, body=body)
     
 @app.get("/extractExactCkTimes")
-async def extractExactCkTimes(
+def extractExactCkTimes(
     observStart: Annotated[ObservStartParam, Depends()],
     observEnd: Annotated[ObservEndParam, Depends()],
     targetFrame: Annotated[TargetFrameParam, Depends()],
@@ -556,7 +830,7 @@ async def extractExactCkTimes(
 
 
 @app.get("/getExactTargetOrientations")
-async def getExactTargetOrientations(
+def getExactTargetOrientations(
     startEt: Annotated[StartEtParam, Depends()],
     stopEt: Annotated[StopEtParam, Depends()],
     toFrame: Annotated[ToFrameParam, Depends()],
@@ -589,7 +863,7 @@ async def getExactTargetOrientations(
 
 
 @app.get("/searchForKernelsets")
-async def searchForKernelsets(
+def searchForKernelsets(
     spiceqlNames: Annotated[SpiceqlNamesParam, Depends()],
     types: Annotated[TypesParam, Depends()],
     startTime: Annotated[StartTimeParam, Depends()],
@@ -619,3 +893,27 @@ async def searchForKernelsets(
         return ResponseModel(statusCode=500, body=body)
 
     
+
+
+@app.get("/getKernelCoverage")
+def getKernelCoverage(
+    mission: Annotated[MissionParam, Depends()],
+    kernelType: Annotated[KernelTypeParam, Depends()],
+    qualities: Annotated[QualitiesParam, Depends()],
+    startTime: Annotated[StartTimeParam, Depends()],
+    stopTime: Annotated[StopTimeParam, Depends()],
+    naifCode: Annotated[NaifCodeParam, Depends()]):
+    try:
+        result, kernels = pyspiceql.getKernelCoverage(
+            mission.value,
+            kernelType.value,
+            qualities.value,
+            startTime.value,
+            stopTime.value,
+            naifCode.value,
+            False)
+        body = ResultModel(result=result, kernels=kernels)
+        return ResponseModel(statusCode=200, body=body)
+    except Exception as e:
+        body = ErrorModel(error=str(e))
+        return ResponseModel(statusCode=500, body=body)
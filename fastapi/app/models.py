@@ -59,7 +59,7 @@ def validate_params(init_func):
             
             # Check if variable names are possible list type
             if var_name in ['ckQualities', 'spkQualities', 'kernelList', 'spiceqlNames', 'types'] or \
-               any(sub in self.__class__.__name__.lower() for sub in ['ckqualities', 'spkqualities', 'spiceqlnames', 'types']):
+               any(sub in self.__class__.__name__.lower() for sub in ['ckqualities', 'spkqualities', 'qualities', 'spiceqlnames', 'types']):
                 setattr(self, var_name, to_list(var_value))
             
             # Check if variable name is 'ets'
@@ -125,6 +125,14 @@ class ResultModel(BaseModel):
     result: Any = Field(serialization_alias='return')
     kernels: Any = Field(serialization_alias='kernels')
 
+    @field_validator('result', mode='before')
+    @classmethod
+    def ndarray_to_list(cls, value: Any) -> Any:
+        # pyspiceql returns NumPy arrays for lists of doubles
+        if isinstance(value, np.ndarray):
+            return value.tolist()
+        return value
+
 class ErrorModel(BaseModel):
     error: str
 
@@ -181,6 +189,81 @@ class TargetOrientationsRequestModel(BaseModel):
         ets = verify_ets(info.data)
         return ets
 
+class SclkStrBatchRequestModel(BaseModel):
+    frameCode: int
+    sclks: Annotated[list[str], Query()]
+    mission: str = ""
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
+class SclkDblBatchRequestModel(BaseModel):
+    frameCode: int
+    sclks: Annotated[list[float], Query()]
+    mission: str = ""
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
+class EtToSclkBatchRequestModel(BaseModel):
+    frameCode: int
+    ets: Annotated[list[float], Query()]
+    mission: str = ""
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
+class TranslateNameToCodeBatchRequestModel(BaseModel):
+    frames: Annotated[list[str], Query()]
+    mission: str = ""
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
+class TranslateCodeToNameBatchRequestModel(BaseModel):
+    frames: Annotated[list[int], Query()]
+    mission: str = ""
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
+class GetFrameInfoBatchRequestModel(BaseModel):
+    frames: Annotated[list[int], Query()]
+    mission: str = ""
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
+class UtcToEtBatchRequestModel(BaseModel):
+    utcs: Annotated[list[str], Query()]
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
+class EtToUtcBatchRequestModel(BaseModel):
+    ets: Annotated[list[float], Query()]
+    format: str
+    precision: float
+    kernelList: Annotated[list[str], Query()] | str | None = []
+    searchKernels: bool = True
+    fullKernelPath: bool = False
+    limitCk: int = -1
+    limitSpk: int = 1
+
 #endregion
 
 
@@ -260,6 +343,10 @@ class CommonParams():
                     "five": {
                         "summary": "Return five CK kernels, if possible.",
                         "value": 5
+                    },
+                    "minimal": {
+                        "summary": "Return the fewest CK kernels covering the time range and report any gaps.",
+                        "value": -2
                     }
                 }
             )] = -1,
@@ -506,6 +593,26 @@ class InitialFrameParam():
         self.value = initialFrame
 
 
+class KernelTypeParam():
+    @validate_params
+    def __init__(
+            self,
+            type: Annotated[str, Query(
+                description="Time dependent kernel type, ck or spk.",
+                openapi_examples={
+                    "ck": {
+                        "summary": "CK",
+                        "value": "ck"
+                    },
+                    "spk": {
+                        "summary": "SPK",
+                        "value": "spk"
+                    }
+                }
+            )] = "ck"):
+        self.value = type
+
+
 class KeyParam():
     @validate_params
     def __init__(
@@ -573,6 +680,26 @@ class MissionParam():
             )] = ""):
         self.value = mission
 
+class NaifCodeParam():
+    @validate_params
+    def __init__(
+            self,
+            naifCode: Annotated[int, Query(
+                description="NAIF code to report coverage for, 0 for all codes.",
+                openapi_examples={
+                    "all": {
+                        "summary": "All codes",
+                        "value": 0
+                    },
+                    "lro": {
+                        "summary": "LRO spacecraft bus [-85000]",
+                        "value": -85000
+                    }
+                }
+            )] = 0):
+        self.value = naifCode
+
+
 class NumRecordsParam():
     @validate_params
     def __init__(
@@ -687,6 +814,26 @@ class PrecisionParam():
         self.value = precision  
 
 
+class QualitiesParam():
+    @validate_params
+    def __init__(
+            self,
+            qualities: Annotated[list[str], Query(
+                description="List of kernel qualities.",
+                openapi_examples={
+                    "reconstructed": {
+                        "summary": "Only reconstructed",
+                        "value": ["reconstructed"]
+                    },
+                    "all": {
+                        "summary": "All quality types",
+                        "value": ["smithed", "reconstructed", "predicted", "nadir", "noquality"]
+                    }
+                }
+            )] = ["smithed", "reconstructed"]):
+        self.value = qualities
+
+
 class RefFrameParam():
     def __init__(
             self,
@@ -12,6 +12,7 @@ Run:
 
 from unittest.mock import MagicMock, patch
 import sys
+import msgpack
 from fastapi import FastAPI
 
 # ---------------------------------------------------------------------------
@@ -79,6 +80,89 @@ def test_getTargetStates_returns_expected_state_vectors():
     assert response.status_code == 200
     assert response.json()["body"]["return"] == expected_return
 
+
+def test_getTargetStates_negotiates_msgpack_and_gzip():
+    expected_return = [[123515791.9195627, 187209003.7067195, 80611152.03610656,
+                        13251.543112834495, -8742.597438450646, -6.575020419444353,
+                        794.9856233875888]] * 50
+    params = {
+        "ets": "[690201375.8323615]",
+        "target": "SUN",
+        "observer": "Mars",
+        "frame": "IAU_MARS",
+        "mission": "ctx",
+        "abcorr": "LT+S",
+    }
+    with patch("pyspiceql.getTargetStates", return_value=(expected_return, CK_KERNELS)):
+        packed = client.get("/getTargetStates", params=params,
+                            headers={"Accept": "application/msgpack, application/json;q=0.9",
+                                     "Accept-Encoding": "gzip"})
+        plain = client.get("/getTargetStates", params=params, headers={"Accept-Encoding": "identity"})
+    assert packed.status_code == 200
+    assert packed.headers["content-type"] == "application/msgpack"
+    assert packed.headers["content-encoding"] == "gzip"
+    assert "Accept" in packed.headers["vary"]
+    body = msgpack.unpackb(packed.content)
+    assert body["statusCode"] == 200
+    assert body["body"]["return"] == expected_return
+    assert body["body"]["kernels"] == CK_KERNELS
+    assert plain.headers["content-type"] == "application/json"
+    assert "Accept" in plain.headers["vary"]
+    assert len(packed.content) < len(plain.content)
+
+
+def test_getTargetStates_etag_revalidates_without_running_query(tmp_path):
+    db = tmp_path / "spiceqldb.hdf"
+    db.write_bytes(b"db")
+    params = {
+        "ets": "[690201375.8323615]",
+        "target": "SUN",
+        "observer": "Mars",
+        "frame": "IAU_MARS",
+        "mission": "ctx",
+        "abcorr": "LT+S",
+    }
+    with patch("pyspiceql.getDbFilePath", return_value=str(db)), \
+         patch("pyspiceql.getTargetStates", return_value=([[1.0] * 7], CK_KERNELS)) as mock:
+        first = client.get("/getTargetStates", params=params)
+        tag = first.headers["etag"]
+        assert tag.startswith('W/"')
+
+        cached = client.get("/getTargetStates", params=params, headers={"If-None-Match": tag})
+        assert cached.status_code == 304
+        assert mock.call_count == 1
+
+        # regenerating the DB changes the tag
+        db.write_bytes(b"new db")
+        fresh = client.get("/getTargetStates", params=params, headers={"If-None-Match": tag})
+        assert fresh.status_code == 200
+        assert fresh.headers["etag"] != tag
+        assert mock.call_count == 2
+
+
+def test_getTargetStates_post_etag_precondition_fails(tmp_path):
+    db = tmp_path / "spiceqldb.hdf"
+    db.write_bytes(b"db")
+    payload = {
+        "ets": [690201375.8323615],
+        "target": "SUN",
+        "observer": "Mars",
+        "frame": "IAU_MARS",
+        "mission": "ctx",
+        "abcorr": "LT+S",
+    }
+    with patch("pyspiceql.getDbFilePath", return_value=str(db)), \
+         patch("pyspiceql.getTargetStates", return_value=([[1.0] * 7], CK_KERNELS)) as mock:
+        first = client.post("/getTargetStates", json=payload)
+        assert first.status_code == 200
+        tag = first.headers["etag"]
+
+        # only GET and HEAD may answer 304
+        matched = client.post("/getTargetStates", json=payload, headers={"If-None-Match": tag})
+        assert matched.status_code == 412
+        assert matched.headers["etag"] == tag
+        assert mock.call_count == 1
+
 # ---------------------------------------------------------------------------
 # getTargetStatesRanged
 # ---------------------------------------------------------------------------
@@ -242,6 +326,47 @@ def test_doubleEtToSclk_returns_expected_sclk_string():
     assert response.json()["body"]["return"] == expected_return
 
 
+# ---------------------------------------------------------------------------
+# SCLK batch conversions
+# ---------------------------------------------------------------------------
+
+def test_strSclkToEtBatch_returns_expected_ets():
+    expected_return = [690201375.8323615, 690201376.8323615]
+    with patch("pyspiceql.strSclkToEtBatch", return_value=(expected_return, SCLK_KERNELS)) as mock:
+        response = client.post("/strSclkToEtBatch", json={
+            "frameCode": -74,
+            "sclks": ["1321396563:036", "1321396564:036"],
+            "mission": "ctx",
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+    assert mock.call_args.args[1] == ["1321396563:036", "1321396564:036"]
+
+
+def test_doubleSclkToEtBatch_returns_expected_ets():
+    expected_return = [31593348.006268278, 31593349.006268278]
+    with patch("pyspiceql.doubleSclkToEtBatch", return_value=(expected_return, SCLK_KERNELS)):
+        response = client.post("/doubleSclkToEtBatch", json={
+            "frameCode": -85,
+            "sclks": [922997380.174174, 922997381.174174],
+            "mission": "lro",
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+
+
+def test_doubleEtToSclkBatch_returns_expected_sclk_strings():
+    expected_return = ["27/1321396563.036", "27/1321396564.036"]
+    with patch("pyspiceql.doubleEtToSclkBatch", return_value=(expected_return, SCLK_KERNELS)):
+        response = client.post("/doubleEtToSclkBatch", json={
+            "frameCode": -74,
+            "ets": [690201375.8323615, 690201376.8323615],
+            "mission": "ctx",
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+
+
 # ---------------------------------------------------------------------------
 # utcToEt
 # ---------------------------------------------------------------------------
@@ -274,6 +399,32 @@ def test_etToUtc_returns_expected_utc_string():
     assert response.json()["body"]["return"] == expected_return
 
 
+# ---------------------------------------------------------------------------
+# utcToEtBatch / etToUtcBatch
+# ---------------------------------------------------------------------------
+
+def test_utcToEtBatch_returns_expected_ets():
+    expected_return = [533471602.76499087, 533471603.76499087]
+    with patch("pyspiceql.utcToEtBatch", return_value=(expected_return, LSK_KERNELS)):
+        response = client.post("/utcToEtBatch", json={
+            "utcs": ["2016-11-26T22:32:14.582000", "2016-11-26T22:32:15.582000"],
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+
+
+def test_etToUtcBatch_returns_expected_utc_strings():
+    expected_return = ["2016-11-26T22:32:14.582000", "2016-11-26T22:32:15.582000"]
+    with patch("pyspiceql.etToUtcBatch", return_value=(expected_return, LSK_KERNELS)):
+        response = client.post("/etToUtcBatch", json={
+            "ets": [533471602.76499087, 533471603.76499087],
+            "format": "ISOC",
+            "precision": 6,
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+
+
 # ---------------------------------------------------------------------------
 # translateNameToCode
 # ---------------------------------------------------------------------------
@@ -306,6 +457,32 @@ def test_translateCodeToName_returns_expected_name():
     assert response.json()["body"]["return"] == expected_return
 
 
+# ---------------------------------------------------------------------------
+# translateNameToCodeBatch / translateCodeToNameBatch
+# ---------------------------------------------------------------------------
+
+def test_translateNameToCodeBatch_returns_expected_codes():
+    expected_return = [-74, -74021]
+    with patch("pyspiceql.translateNameToCodeBatch", return_value=(expected_return, FK_KERNELS)):
+        response = client.post("/translateNameToCodeBatch", json={
+            "frames": ["MRO", "MRO_CTX"],
+            "mission": "ctx",
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+
+
+def test_translateCodeToNameBatch_returns_expected_names():
+    expected_return = ["MRO", "MRO_CTX"]
+    with patch("pyspiceql.translateCodeToNameBatch", return_value=(expected_return, FK_KERNELS)):
+        response = client.post("/translateCodeToNameBatch", json={
+            "frames": [-74, -74021],
+            "mission": "ctx",
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+
+
 # ---------------------------------------------------------------------------
 # getFrameInfo
 # ---------------------------------------------------------------------------
@@ -322,6 +499,21 @@ def test_getFrameInfo_returns_expected_frame_info():
     assert response.json()["body"]["return"] == expected_return
 
 
+# ---------------------------------------------------------------------------
+# getFrameInfoBatch
+# ---------------------------------------------------------------------------
+
+def test_getFrameInfoBatch_returns_expected_frame_infos():
+    expected_return = [[-85, 3, -85600], [-85, 3, -85620]]
+    with patch("pyspiceql.getFrameInfoBatch", return_value=(expected_return, FK_KERNELS)):
+        response = client.post("/getFrameInfoBatch", json={
+            "frames": [-85600, -85620],
+            "mission": "lroc",
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+
+
 # ---------------------------------------------------------------------------
 # getTargetFrameInfo
 # ---------------------------------------------------------------------------
@@ -514,3 +706,29 @@ def test_searchForKernelsets_returns_expected_kernels():
         })
     assert response.status_code == 200
     assert response.json()["body"]["return"] == expected_return
+
+
+# ---------------------------------------------------------------------------
+# getKernelCoverage
+# ---------------------------------------------------------------------------
+
+def test_getKernelCoverage_returns_windows_and_gaps():
+    expected_return = {
+        "reconstructed": {
+            "windows": [[110000000.0, 120000000.0], [130000000.0, 140000000.0]],
+            "gaps": [[120000000.0, 130000000.0]],
+        }
+    }
+    with patch("pyspiceql.getKernelCoverage", return_value=(expected_return, {})) as mock:
+        response = client.get("/getKernelCoverage", params={
+            "mission": "lroc",
+            "type": "ck",
+            "qualities": '["reconstructed"]',
+            "naifCode": -85000,
+        })
+    assert response.status_code == 200
+    assert response.json()["body"]["return"] == expected_return
+    args = mock.call_args.args
+    assert args[0] == "lroc"
+    assert args[2] == ["reconstructed"]
+    assert args[5] == -85000
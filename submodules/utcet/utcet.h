@@ -1,24 +1,34 @@
 #include <algorithm>
 #include <cctype>
+#include <climits>
 #include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <ctime>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
-// Windows compatibility
-#ifdef _WIN32
-  #define timegm _mkgmtime
-#endif
+// Leap seconds and TDB-TAI constants used by the conversions. The built-in
+// table (defaultLeapSecondTable) matches naif0012.tls; makeLeapSecondTable
+// builds one from the DELTET values of any LSK so results follow the LSK in use.
+struct LeapSecondTable {
+  // Whole UTC seconds past J2000 at which each TAI-UTC value takes effect,
+  // ascending, and the values.
+  std::vector<long long> utc;
+  std::vector<double> tai_utc;
+  double delta_t_a = 32.184;
+  double k = 1.657e-3;
+  double eb = 1.671e-2;
+  double m[2] = {6.239996e0, 1.99096871e-7};
+};
 
 // Leap-second table: UTC dates when TAI-UTC incremented.
 // Source: IERS Bulletin C / NAIF naif0012.tls.
 namespace {
   struct LeapSecond { int y, m, d; double tai_utc; };
 
-  static const LeapSecond LEAP_SECONDS[] = {
+  constexpr LeapSecond LEAP_SECONDS[] = {
     {1972,  1, 1, 10}, {1972,  7, 1, 11}, {1973,  1, 1, 12},
     {1974,  1, 1, 13}, {1975,  1, 1, 14}, {1976,  1, 1, 15},
     {1977,  1, 1, 16}, {1978,  1, 1, 17}, {1979,  1, 1, 18},
@@ -31,15 +41,132 @@ namespace {
     {2017,  1, 1, 37},
   };
 
-  static const int NUM_LEAP_SECONDS = sizeof(LEAP_SECONDS) / sizeof(LEAP_SECONDS[0]);
+  constexpr int NUM_LEAP_SECONDS = sizeof(LEAP_SECONDS) / sizeof(LEAP_SECONDS[0]);
 
-  // Constants for time conversion
-  static const double DELTA_T_A = 32.184;  // TT - TAI offset (seconds)
-  static const double K = 1.657e-3;
-  static const double EB = 1.671e-2;
-  static const double M[] = {6.239996e0, 1.99096871e-7};
-  static const std::time_t J2000_UTC_UNIX = 946728000;  // 2000-01-01 12:00:00 UTC
-  static const double J2000_TAI_UTC = 32.0;  // TAI-UTC at J2000 epoch
+  // Floor division, so negative (pre-epoch) seconds land on the right day.
+  constexpr long long floorDiv(long long a, long long b) {
+    return (a / b) - ((a % b != 0) && ((a < 0) != (b < 0)));
+  }
+
+  // Days from 1970-01-01 to y-m-d in the proleptic Gregorian calendar
+  // (H. Hinnant's days_from_civil). Out of range months carry into the year and
+  // out of range days carry into the following months, like timegm does, but
+  // without touching the C library's shared state.
+  constexpr long long daysFromCivil(long long y, long long m, long long d) {
+    y += floorDiv(m - 1, 12);
+    m = m - 1 - floorDiv(m - 1, 12) * 12 + 1;
+    long long yy = y - (m <= 2);
+    long long era = floorDiv(yy, 400);
+    long long yoe = yy - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468 + (d - 1);
+  }
+
+  // Calendar date of a day count from 1970-01-01 (H. Hinnant's
+  // civil_from_days), plus the 1-based day of year. Reentrant replacement for
+  // gmtime.
+  inline void civilFromDays(long long z, int &y, int &m, int &d, int &doy) {
+    z += 719468;
+    long long era = floorDiv(z, 146097);
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long dy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * dy + 2) / 153;
+    d = (int)(dy - (153 * mp + 2) / 5 + 1);
+    m = (int)(mp < 10 ? mp + 3 : mp - 9);
+    y = (int)(yoe + era * 400 + (m <= 2));
+    doy = (int)(z - 719468 - daysFromCivil(y, 1, 1) + 1);
+  }
+
+  // 2000-01-01 12:00:00 UTC as days and seconds past the Unix epoch.
+  constexpr long long J2000_DAYS = daysFromCivil(2000, 1, 1);
+  constexpr long long J2000_UTC_UNIX = J2000_DAYS * 86400 + 43200;
+
+  // TAI-UTC in effect at a whole UTC second past J2000, a binary search over
+  // the table's integer thresholds.
+  inline int getLeapSeconds(const LeapSecondTable &table, long long utc_seconds_past_j2000) {
+    auto it = std::upper_bound(table.utc.begin(), table.utc.end(), utc_seconds_past_j2000);
+    // For dates before the first tabulated leap second (1972-01-01), CSPICE
+    // extrapolates TAI-UTC backward as a unit step, so the value just below the
+    // first entry is one less than it (9, not 10). Seeding with the first
+    // entry's value would make every pre-1972 epoch's ET a full second too large
+    // (e.g. the Apollo missions).
+    if (it == table.utc.begin()) {
+      return (int)table.tai_utc[0] - 1;
+    }
+    return (int)table.tai_utc[(it - table.utc.begin()) - 1];
+  }
+
+  // Index of the table entry in effect at a TAI instant past J2000, -1 before
+  // the first entry. Entry i takes effect at UTC table.utc[i], which is TAI
+  // table.utc[i] + table.tai_utc[i].
+  inline long leapSecondIndexAtTai(const LeapSecondTable &table, double tai) {
+    long lo = 0, hi = (long)table.utc.size();
+    while (lo < hi) {
+      long mid = (lo + hi) / 2;
+      if ((double)table.utc[mid] + table.tai_utc[mid] <= tai) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    return lo - 1;
+  }
+
+  // TAI-UTC of a table entry, extrapolated before the first one like getLeapSeconds.
+  inline int leapSecondsOfIndex(const LeapSecondTable &table, long index) {
+    return index < 0 ? (int)table.tai_utc[0] - 1 : (int)table.tai_utc[index];
+  }
+
+  // TDB-TAI at an ET. Branch free so loops over contiguous arrays vectorize.
+  inline double tdbMinusTai(const LeapSecondTable &table, double et) {
+    double mean_m = table.m[0] + table.m[1] * et;
+    double E = mean_m + table.eb * std::sin(mean_m);
+    return table.delta_t_a + table.k * std::sin(E);
+  }
+
+  // TDB-TAI for n ETs.
+  inline void tdbMinusTai(const LeapSecondTable &table, const double *ets, double *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = tdbMinusTai(table, ets[i]);
+    }
+  }
+
+  // Broken down calendar time; the reentrant stand-in for struct tm. Fields may
+  // be out of range (e.g. an ordinal day in mday) and are normalized by
+  // calendarSeconds.
+  struct CalendarFields {
+    int year = 0;
+    int mon = 0;   // 0-11
+    int mday = 1;
+    int hour = 0;
+    int min = 0;
+    int sec = 0;
+  };
+
+  // Whether calendar fields name a real date and time of day. An ordinal date
+  // keeps its day of year in mday. Seconds may be 60, calendarTimeToTai checks
+  // that against the leap seconds.
+  inline bool calendarFieldsInRange(const CalendarFields &t, bool ordinal) {
+    if (t.hour < 0 || t.hour > 23 || t.min < 0 || t.min > 59 || t.sec < 0 || t.sec > 60) {
+      return false;
+    }
+    if (ordinal) {
+      return t.mday >= 1 && t.mday <= daysFromCivil(t.year + 1, 1, 1) - daysFromCivil(t.year, 1, 1);
+    }
+    if (t.mon < 0 || t.mon > 11) {
+      return false;
+    }
+    return t.mday >= 1 && t.mday <= daysFromCivil(t.year, t.mon + 2, 1) - daysFromCivil(t.year, t.mon + 1, 1);
+  }
+
+  // Whole UTC seconds past J2000 of calendar fields read literally.
+  inline long long calendarSeconds(const CalendarFields &t) {
+    long long days = daysFromCivil(t.year, t.mon + 1, t.mday);
+    return days * 86400 + (long long)t.hour * 3600 + (long long)t.min * 60 + t.sec - J2000_UTC_UNIX;
+  }
 
   // Time system a calendar string is expressed in, as designated by a trailing
   // token (e.g. "... TDB"). Absent a token, CSPICE's str2et defaults to UTC.
@@ -55,24 +182,6 @@ namespace {
     return false;
   }
 
-  // Helper function to get leap second count for a given date
-  int getLeapSeconds(int y, int m, int d) {
-    // For dates before the first tabulated leap second (1972-01-01), CSPICE
-    // extrapolates TAI-UTC backward as a unit step, so the value just below the
-    // first entry is one less than it (9, not 10). Seeding with the first
-    // entry's value would make every pre-1972 epoch's ET a full second too large
-    // (e.g. the Apollo missions).
-    int leap = LEAP_SECONDS[0].tai_utc - 1;
-    for (int i = 0; i < NUM_LEAP_SECONDS; i++) {
-      if (y > LEAP_SECONDS[i].y ||
-          (y == LEAP_SECONDS[i].y && (m > LEAP_SECONDS[i].m ||
-          (m == LEAP_SECONDS[i].m && d >= LEAP_SECONDS[i].d)))) {
-        leap = LEAP_SECONDS[i].tai_utc;
-      }
-    }
-    return leap;
-  }
-
   // Map a (possibly full) English month name to 1-12, matching on the first
   // three letters as CSPICE's str2et does. Returns 0 when the token is not a
   // recognized month name.
@@ -93,7 +202,7 @@ namespace {
     return 0;
   }
 
-  // Parse a UTC calendar string into a normalized struct tm plus fractional
+  // Parse a UTC calendar string into calendar fields plus fractional
   // seconds. Supports the calendar formats CSPICE's str2et accepts, including:
   //   ISO 8601 with 'T' or space separators and an optional trailing 'Z'
   //     ("1986-01-18T12:19:52.18", "1986-01-18 12:19:52Z")
@@ -106,12 +215,16 @@ namespace {
   //   Partial date/time, with missing fields defaulting to zero
   //     ("1986-01-18", "1986", "1986-01-18T12")
   //
-  // The day-of-year case relies on timegm normalizing an out-of-range tm_mday,
-  // so callers must read the calendar date back out of struct tm afterwards.
+  // The day-of-year case leaves the ordinal day in mday for calendarSeconds to
+  // normalize.
   //
   // A trailing time-system designator (UTC/TDB/TDT/TT) is honored and reported
   // via ts; when absent, ts is left as UTC, matching CSPICE's str2et default.
-  void parseUtcString(const std::string &utc, struct tm &t, double &fractional_seconds,
+  //
+  // Anything else throws, so callers can hand the string to str2et instead:
+  // unknown words, years that are not four digits, fields that do not fit one of
+  // the orders above and dates or times out of range.
+  void parseUtcString(const std::string &utc, CalendarFields &t, double &fractional_seconds,
                       TimeSystem &ts) {
     t = {};
     fractional_seconds = 0.0;
@@ -175,16 +288,30 @@ namespace {
       }
     }
 
+    auto unparsable = [&]() {
+      return std::runtime_error("Unable to parse UTC string: \"" + utc + "\"");
+    };
+    auto isDigits = [](const std::string &token) {
+      return !token.empty() && std::all_of(token.begin(), token.end(),
+                                           [](char ch) { return std::isdigit((unsigned char)ch) != 0; });
+    };
+
     for (size_t ti = 0; ti < tokens.size(); ti++) {
       const std::string &token = tokens[ti];
       if (token.find(':') != std::string::npos || tokenIsTime[ti]) {
+        if (!timeToken.empty()) {
+          throw unparsable();
+        }
         timeToken = token;
         continue;
       }
       int month = monthFromName(token);
       if (month != 0) {
+        if (!monthName.empty() || token.size() > 9) {
+          throw unparsable();
+        }
         monthName = token;
-        t.tm_mon = month - 1;
+        t.mon = month - 1;
         continue;
       }
       // Trailing time-system designator (UTC/TDB/TDT/TT).
@@ -192,57 +319,78 @@ namespace {
         continue;
       }
       // Pure integer date field.
-      bool allDigits = !token.empty() &&
-          std::all_of(token.begin(), token.end(),
-                      [](char ch) { return std::isdigit((unsigned char)ch) != 0; });
-      if (allDigits) {
-        nums.push_back({std::stol(token), (int)token.size()});
+      if (!isDigits(token) || token.size() > 4) {
+        throw unparsable();
       }
+      nums.push_back({std::stol(token), (int)token.size()});
     }
 
     bool haveMonthName = !monthName.empty();
     int year = 0, day = 0, doy = 0;
     bool haveDoy = false;
 
+    // Only four digit years are read. str2et expands two digit years with its
+    // own rules, so those strings are left to it.
     auto isYear = [](const std::pair<long, int> &n) { return n.second == 4; };
+    auto isDayOrMonth = [](const std::pair<long, int> &n) { return n.second <= 2; };
 
     if (haveMonthName) {
       // Month is already set; remaining numbers are the year and day in any
       // order (the 4-digit one is the year).
-      for (const auto &n : nums) {
-        if (isYear(n)) year = (int)n.first;
-        else day = (int)n.first;
+      if (nums.size() == 1 && isYear(nums[0])) {
+        year = (int)nums[0].first;
+      }
+      else if (nums.size() == 2 && isYear(nums[0]) != isYear(nums[1])) {
+        const auto &yearTok = isYear(nums[0]) ? nums[0] : nums[1];
+        const auto &dayTok = isYear(nums[0]) ? nums[1] : nums[0];
+        if (!isDayOrMonth(dayTok)) {
+          throw unparsable();
+        }
+        year = (int)yearTok.first;
+        day = (int)dayTok.first;
+      }
+      else {
+        throw unparsable();
       }
     }
-    else if (nums.size() >= 3) {
+    else if (nums.size() == 3) {
       // Year/month/day. Determine order from which end carries the 4-digit year.
-      if (isYear(nums[0])) {            // Y M D
+      if (isYear(nums[0]) && isDayOrMonth(nums[1]) && isDayOrMonth(nums[2])) {  // Y M D
         year = (int)nums[0].first;
-        t.tm_mon = (int)nums[1].first - 1;
+        t.mon = (int)nums[1].first - 1;
         day = (int)nums[2].first;
       }
-      else {                            // M D Y (US style)
-        t.tm_mon = (int)nums[0].first - 1;
+      else if (isDayOrMonth(nums[0]) && isDayOrMonth(nums[1]) && isYear(nums[2])) {  // M D Y (US style)
+        t.mon = (int)nums[0].first - 1;
         day = (int)nums[1].first;
         year = (int)nums[2].first;
       }
+      else {
+        throw unparsable();
+      }
     }
     else if (nums.size() == 2) {
       // year + day-of-year. CSPICE's str2et reads a two-number date as an
       // ordinal (YYYY-DOY) date regardless of the day field's width -- it never
       // treats "YYYY-MM" as a year/month -- so "2003-2", "2003-32", and
       // "2003-122" are days 2, 32, and 122 of 2003 (Jan 2, Feb 1, May 2).
+      if (isYear(nums[0]) == isYear(nums[1])) {
+        throw unparsable();
+      }
       std::pair<long, int> yearTok = isYear(nums[0]) ? nums[0] : nums[1];
       std::pair<long, int> other = isYear(nums[0]) ? nums[1] : nums[0];
+      if (other.second > 3) {
+        throw unparsable();
+      }
       year = (int)yearTok.first;
       doy = (int)other.first;
       haveDoy = true;
     }
-    else if (nums.size() == 1) {
+    else if (nums.size() == 1 && isYear(nums[0])) {
       year = (int)nums[0].first;        // date-only, year
     }
     else {
-      throw std::runtime_error("Unable to parse UTC string: \"" + utc + "\"");
+      throw unparsable();
     }
 
     // Parse the time token (HH, HH:MM, or HH:MM:SS[.fff]). Missing fields are
@@ -261,63 +409,372 @@ namespace {
           part += timeToken[i];
         }
       }
-      if (parts.size() >= 1 && !parts[0].empty()) hour = std::stoi(parts[0]);
-      if (parts.size() >= 2 && !parts[1].empty()) minute = std::stoi(parts[1]);
-      if (parts.size() >= 3 && !parts[2].empty()) sec = std::stod(parts[2]);
-      t.tm_hour = hour;
-      t.tm_min = minute;
-      t.tm_sec = (int)sec;
-      fractional_seconds = sec - (double)t.tm_sec;
+      // HH and MM are whole numbers, SS may have a fraction
+      if (parts.size() > 3) {
+        throw unparsable();
+      }
+      for (size_t i = 0; i < parts.size(); i++) {
+        std::string whole = parts[i];
+        if (i == 2 && whole.find('.') != std::string::npos) {
+          std::string fraction = whole.substr(whole.find('.') + 1);
+          whole = whole.substr(0, whole.find('.'));
+          if (!fraction.empty() && !isDigits(fraction)) {
+            throw unparsable();
+          }
+        }
+        if (!isDigits(whole) || whole.size() > 2) {
+          throw unparsable();
+        }
+      }
+      if (parts.size() >= 1) hour = std::stoi(parts[0]);
+      if (parts.size() >= 2) minute = std::stoi(parts[1]);
+      if (parts.size() >= 3) sec = std::stod(parts[2]);
+      t.hour = hour;
+      t.min = minute;
+      t.sec = (int)sec;
+      fractional_seconds = sec - (double)t.sec;
     }
 
-    t.tm_year = year - 1900;
+    t.year = year;
     if (haveDoy) {
-      // Day-of-year: month already 0, let timegm normalize the ordinal day.
-      t.tm_mon = 0;
-      t.tm_mday = doy;
+      // Day-of-year: month already 0, let calendarSeconds normalize the ordinal day.
+      t.mon = 0;
+      t.mday = doy;
     }
     else {
-      t.tm_mday = (day > 0) ? day : 1;
+      t.mday = (day > 0) ? day : 1;
+    }
+    if (!calendarFieldsInRange(t, haveDoy)) {
+      throw unparsable();
     }
   }
-}
 
-double calendarTimeToEphemTime(std::string calendarTime) {
 
-  struct tm t = {};
-  double fractional_seconds = 0.0;
-  TimeSystem ts = TimeSystem::UTC;
-  parseUtcString(calendarTime, t, fractional_seconds, ts);
+  // Allocation free parse of the common "YYYY-MM-DDTHH:MM:SS[.fff][Z]" form,
+  // with 'T' or a space between the date and time. Returns false for anything
+  // else so the caller can fall back to parseUtcString, which produces the
+  // same fields for these strings.
+  bool parseIsoUtcString(const char *s, size_t len, CalendarFields &t, double &fractional_seconds) {
+    auto digits = [&](size_t pos, size_t count, int &value) {
+      value = 0;
+      for (size_t i = pos; i < pos + count; i++) {
+        if (!std::isdigit((unsigned char)s[i])) {
+          return false;
+        }
+        value = value * 10 + (s[i] - '0');
+      }
+      return true;
+    };
+
+    if (len > 19 && (s[len - 1] == 'Z' || s[len - 1] == 'z')) {
+      len--;
+    }
+
+    int year, mon, day, hour, min, sec;
+    if (len < 19 || len > 48 ||
+        !digits(0, 4, year) || s[4] != '-' || !digits(5, 2, mon) || s[7] != '-' || !digits(8, 2, day) ||
+        (s[10] != 'T' && s[10] != 't' && s[10] != ' ') ||
+        !digits(11, 2, hour) || s[13] != ':' || !digits(14, 2, min) || s[16] != ':' || !digits(17, 2, sec)) {
+      return false;
+    }
+
+    double seconds = sec;
+    if (len > 19) {
+      if (s[19] != '.') {
+        return false;
+      }
+      for (size_t i = 20; i < len; i++) {
+        if (!std::isdigit((unsigned char)s[i])) {
+          return false;
+        }
+      }
+      // parse "SS.fff" as one number, exactly like the general parser does
+      char buf[32];
+      std::memcpy(buf, s + 17, len - 17);
+      buf[len - 17] = '\0';
+      seconds = std::strtod(buf, nullptr);
+    }
+
+    t = {};
+    t.year = year;
+    t.mon = mon - 1;
+    t.mday = (day > 0) ? day : 1;
+    t.hour = hour;
+    t.min = min;
+    t.sec = (int)seconds;
+    fractional_seconds = seconds - (double)t.sec;
+    return calendarFieldsInRange(t, false);
+  }
+
+
+  // TAI seconds past J2000 of a calendar string, or its ET directly when the
+  // string is in TDB (flagged through isTdb).
+  double calendarTimeToTai(const LeapSecondTable &table, const std::string &calendarTime, bool &isTdb) {
+    CalendarFields t;
+    double fractional_seconds = 0.0;
+    TimeSystem ts = TimeSystem::UTC;
+    if (!parseIsoUtcString(calendarTime.c_str(), calendarTime.size(), t, fractional_seconds)) {
+      parseUtcString(calendarTime, t, fractional_seconds, ts);
+    }
 
-  std::time_t cal_unix = timegm(&t);
+    // Seconds past the J2000 epoch with the calendar fields read literally. Every
+    // supported time system uses a uniform 86400 s/day calendar (the leap-second
+    // adjustment is what distinguishes UTC), so this is the common starting point.
+    long long cal_seconds = calendarSeconds(t);
+    double seconds_since_j2000 = (double)cal_seconds + fractional_seconds;
+
+    // 23:59:60 reads literally as the next midnight. Only UTC has it, as the leap
+    // second inserted before that midnight, so it still has the previous day's
+    // count and lands one second before midnight on the TAI scale.
+    if (t.sec == 60) {
+      auto it = std::lower_bound(table.utc.begin(), table.utc.end(), cal_seconds);
+      bool leapSecond = ts == TimeSystem::UTC && t.hour == 23 && t.min == 59 &&
+                        it != table.utc.end() && *it == cal_seconds &&
+                        getLeapSeconds(table, cal_seconds) > getLeapSeconds(table, cal_seconds - 1);
+      if (!leapSecond) {
+        throw std::runtime_error("No leap second at \"" + calendarTime + "\"");
+      }
+      return seconds_since_j2000 + getLeapSeconds(table, cal_seconds - 1);
+    }
 
-  // Seconds past the J2000 epoch with the calendar fields read literally. Every
-  // supported time system uses a uniform 86400 s/day calendar (the leap-second
-  // adjustment is what distinguishes UTC), so this is the common starting point.
-  double seconds_since_j2000 = (double)cal_unix - J2000_UTC_UNIX + fractional_seconds;
+    // A TDB calendar string already names an instant on the ephemeris (TDB) time
+    // scale, so its seconds-past-J2000 are ET directly -- no leap-second or
+    // TDB-TAI correction is applied (this matches CSPICE's str2et, which returns
+    // the parsed value unchanged for a "... TDB" input).
+    isTdb = (ts == TimeSystem::TDB);
+    if (isTdb) {
+      return seconds_since_j2000;
+    }
 
-  // A TDB calendar string already names an instant on the ephemeris (TDB) time
-  // scale, so its seconds-past-J2000 are ET directly -- no leap-second or
-  // TDB-TAI correction is applied (this matches CSPICE's str2et, which returns
-  // the parsed value unchanged for a "... TDB" input).
-  if (ts == TimeSystem::TDB) {
-    return seconds_since_j2000;
+    // For UTC, shift onto the TAI scale with the leap-second count for this date;
+    // for TT (== TDT), TT is already 32.184 s ahead of TAI so it sits at the same
+    // offset as TAI + delta_t_a. The lookup uses the normalized whole seconds so
+    // day-of-year inputs are handled.
+    if (ts == TimeSystem::TT) {
+      // TT - TAI = delta_t_a, so TAI = TT - delta_t_a; adding delta_t_a back
+      // recovers TT. Equivalently, seed the iteration at TT past J2000.
+      return seconds_since_j2000 - table.delta_t_a;
+    }
+
+    return seconds_since_j2000 + getLeapSeconds(table, cal_seconds);
   }
 
-  // For UTC, shift onto the TAI scale with the leap-second count for this date;
-  // for TT (== TDT), TT is already 32.184 s ahead of TAI so it sits at the same
-  // offset as TAI + DELTA_T_A. Read the date back out of t so day-of-year inputs
-  // (normalized by timegm) are handled.
-  double tai_past_j2000;
-  if (ts == TimeSystem::TT) {
-    // TT - TAI = DELTA_T_A, so TAI = TT - DELTA_T_A; adding DELTA_T_A back below
-    // recovers TT. Equivalently, seed the iteration at TT past J2000.
-    tai_past_j2000 = seconds_since_j2000 - DELTA_T_A;
+
+  // Format the UTC of an ET given its TDB-TAI offset. fmt must be upper case.
+  std::string formatCalendarTime(const LeapSecondTable &table, double ephemTime, double tdb_tai, const std::string &fmt, int prec, int utclen) {
+    // Look up the leap-second count on the TAI scale, which is continuous. A UTC
+    // guess would pick the new count up to a leap second early and print the
+    // seconds before it one second early.
+    long leapIndex = leapSecondIndexAtTai(table, ephemTime - tdb_tai);
+    int leap = leapSecondsOfIndex(table, leapIndex);
+
+    // The next step in the table. Its inserted seconds are 23:59:60 of the day before.
+    long long nextUtc = leapIndex + 1 < (long)table.utc.size() ? table.utc[leapIndex + 1] : LLONG_MAX;
+    int inserted = nextUtc == LLONG_MAX ? 0 : leapSecondsOfIndex(table, leapIndex + 1) - leap;
+
+    // Now compute the actual UTC time
+    // ET = seconds_since_j2000_utc + leap + tdb_tai
+    // seconds_since_j2000_utc = ET - leap - tdb_tai
+    double seconds_since_j2000_utc = ephemTime - leap - tdb_tai;
+
+    // Julian Date format ("J") reports the UTC Julian date directly and is not
+    // affected by the calendar rounding/carry logic below. J2000 (2000-01-01
+    // 12:00:00 UTC) is JD 2451545.0, and seconds_since_j2000_utc is measured from
+    // that same epoch.
+    if (fmt == "J") {
+      double jd = 2451545.0 + seconds_since_j2000_utc / 86400.0;
+      // Round half away from zero to match CSPICE (printf's %f rounds half to
+      // even, which disagrees on exact .5 boundaries such as JD x.5).
+      double scale = std::pow(10.0, prec);
+      jd = std::floor(jd * scale + 0.5) / scale;
+      char jbuf[64];
+      snprintf(jbuf, sizeof(jbuf), "JD %.*f", prec, jd);
+      std::string result = jbuf;
+      // CSPICE always emits the decimal point, even at precision 0 ("JD 2451545.").
+      if (prec == 0) {
+        result += '.';
+      }
+      if ((int)result.size() + 1 > utclen) {
+        throw std::runtime_error("A utclen of {" + std::to_string(utclen) + "} to small for expected string size of "
+                            "{" + std::to_string(result.size() + 1) + "}");
+      }
+      return result;
+    }
+
+    // Split into the integer second and fraction at the seconds-past-J2000
+    // magnitude, *before* shifting onto the Unix epoch. The J2000-to-1970 offset
+    // (~9.5e8 s) would push the value to ~1.2e9, where a double resolves only ~6
+    // fractional decimals; keeping the split at the smaller seconds-past-J2000
+    // magnitude preserves the extra decimal CSPICE's et2utc reports (e.g. a 2008
+    // epoch at ~2.6e8 resolves 7). The whole seconds are then broken down as
+    // integers, which cannot perturb the fraction.
+    double floor_j2000 = std::floor(seconds_since_j2000_utc);
+    double frac = seconds_since_j2000_utc - floor_j2000;
+    long long utc_seconds = (long long)floor_j2000;
+
+    // Inside a leap second the count has not stepped yet, so the UTC seconds run
+    // past the next midnight. Show them as 23:59:59 plus the seconds past 59.
+    int leapSecond = 0;
+    if (utc_seconds >= nextUtc) {
+      leapSecond = (int)(utc_seconds - nextUtc) + 1;
+      utc_seconds = nextUtc - 1;
+    }
+
+    // Strip sub-resolution noise before rounding. A double holds ~15-16
+    // significant digits, so at this epoch's magnitude the fractional second is
+    // only meaningful to ulp = |seconds_since_j2000_utc| * 2^-52 seconds. Asking
+    // for more decimals than that surfaces floating-point dust (e.g. .1234 stored
+    // as .12339997). Snap the fraction to the resolvable number of decimals first
+    // so those trailing digits round cleanly instead of leaking noise. The
+    // resolvable count is taken at the seconds-past-J2000 magnitude actually
+    // carried, not the inflated Unix value, so it does not under-report by a
+    // decimal.
+    if (seconds_since_j2000_utc != 0.0) {
+      double ulp = std::fabs(seconds_since_j2000_utc) * 2.220446049250313e-16;  // 2^-52
+      int resolvable = (int)std::floor(-std::log10(ulp));
+      if (resolvable < 0) resolvable = 0;
+      if (resolvable < prec) {
+        double snapMult = std::pow(10.0, resolvable);
+        frac = std::lround(frac * snapMult) / snapMult;
+      }
+    }
+
+    long precisionMult = (long)std::lround(std::pow(10.0, prec));
+    // Round the fraction to the requested precision instead of truncating, so a
+    // value like x.600 does not degrade to x.599 through floating-point error.
+    long fracDigits = std::lround(frac * (double)precisionMult);
+    // A round-up can carry into the next whole second (e.g. 0.9999996 -> 1.000000
+    // at prec=6); roll it into utc_seconds so we never emit an out-of-range field.
+    // Carries into and through a leap second stay on 23:59:60.
+    if (fracDigits >= precisionMult) {
+      fracDigits -= precisionMult;
+      if (leapSecond > 0 && leapSecond < inserted) {
+        leapSecond++;
+      }
+      else if (leapSecond > 0) {
+        leapSecond = 0;
+        utc_seconds = nextUtc;
+      }
+      else if (utc_seconds + 1 == nextUtc && inserted > 0) {
+        leapSecond = 1;
+      }
+      else {
+        utc_seconds++;
+      }
+    }
+
+    // Break the rounded UTC instant into calendar fields.
+    long long utc_unix = utc_seconds + J2000_UTC_UNIX;
+    long long days = floorDiv(utc_unix, 86400);
+    long long second_of_day = utc_unix - days * 86400;
+    int year, month, day, doy;
+    civilFromDays(days, year, month, day, doy);
+    int hour = (int)(second_of_day / 3600);
+    int minute = (int)(second_of_day % 3600 / 60);
+    int second = (int)(second_of_day % 60) + leapSecond;
+
+    static const char *kMonthAbbr[] = {
+      "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+      "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+    };
+
+    // Fractional-seconds suffix. prec == 0 omits the decimal point entirely, as
+    // CSPICE's et2utc does. For prec > 0 the fraction is zero-padded to exactly
+    // prec digits with no trailing-zero trimming -- matching et2utc_c, which
+    // emits a fixed-width fraction for every calendar format (C, D, ISOC, ISOD),
+    // e.g. ".582000" at prec 6 and ".000000" on a whole second. (The J format
+    // uses %f above and is unaffected by this.)
+    char fracStr[64] = "";
+    if (prec > 0) {
+      snprintf(fracStr, sizeof(fracStr), ".%0*ld", prec, fracDigits);
+    }
+
+    // Assemble the date/time portion per the requested format code. Defaults to
+    // ISOC for unrecognized codes to preserve prior behavior.
+    char datebuf[64];
+    if (fmt == "C") {
+      // "1986 APR 12 16:31:09"
+      snprintf(datebuf, sizeof(datebuf), "%04d %s %02d %02d:%02d:%02d",
+               year, kMonthAbbr[month - 1], day, hour, minute, second);
+    }
+    else if (fmt == "D") {
+      // "1986-102 // 16:31:12"
+      snprintf(datebuf, sizeof(datebuf), "%04d-%03d // %02d:%02d:%02d",
+               year, doy, hour, minute, second);
+    }
+    else if (fmt == "ISOD") {
+      // "1986-102T16:31:12"
+      snprintf(datebuf, sizeof(datebuf), "%04d-%03dT%02d:%02d:%02d",
+               year, doy, hour, minute, second);
+    }
+    else {
+      // ISOC: "1986-04-12T16:31:12"
+      snprintf(datebuf, sizeof(datebuf), "%04d-%02d-%02dT%02d:%02d:%02d",
+               year, month, day, hour, minute, second);
+    }
+
+    std::string result = std::string(datebuf) + fracStr;
+    if ((int)result.size() + 1 > utclen) {
+      throw std::runtime_error("A utclen of {" + std::to_string(utclen) + "} to small for expected string size of "
+                          "{" + std::to_string(result.size() + 1) + "}");
+    }
+    return result;
   }
-  else {
-    int y = t.tm_year + 1900, m = t.tm_mon + 1, d = t.tm_mday;
-    int leap = getLeapSeconds(y, m, d);
-    tai_past_j2000 = seconds_since_j2000 + leap;
+}
+
+
+// The built-in leap-second table (naif0012.tls).
+const LeapSecondTable &defaultLeapSecondTable() {
+  static const LeapSecondTable table = [] {
+    LeapSecondTable t;
+    for (int i = 0; i < NUM_LEAP_SECONDS; i++) {
+      t.utc.push_back(daysFromCivil(LEAP_SECONDS[i].y, LEAP_SECONDS[i].m, LEAP_SECONDS[i].d) * 86400 - J2000_UTC_UNIX);
+      t.tai_utc.push_back(LEAP_SECONDS[i].tai_utc);
+    }
+    return t;
+  }();
+  return table;
+}
+
+
+// Build a leap-second table from an LSK's DELTET/DELTA_AT pairs, given as the
+// TAI-UTC values and their "@" dates (e.g. "@1972-JAN-1", with or without the
+// '@'), plus the other DELTET constants.
+LeapSecondTable makeLeapSecondTable(const std::vector<double> &taiUtc, const std::vector<std::string> &dates,
+                                    double deltaTA, double k, double eb, double m0, double m1) {
+  if (taiUtc.empty() || taiUtc.size() != dates.size()) {
+    throw std::runtime_error("Leap second values and dates must be non-empty and the same length");
+  }
+
+  LeapSecondTable table;
+  for (size_t i = 0; i < dates.size(); i++) {
+    std::string date = (!dates[i].empty() && dates[i][0] == '@') ? dates[i].substr(1) : dates[i];
+    CalendarFields t;
+    double fractional_seconds = 0.0;
+    TimeSystem ts = TimeSystem::UTC;
+    parseUtcString(date, t, fractional_seconds, ts);
+
+    long long seconds = calendarSeconds(t);
+    if (!table.utc.empty() && seconds <= table.utc.back()) {
+      throw std::runtime_error("Leap second dates must be increasing, [" + dates[i] + "] is not");
+    }
+    table.utc.push_back(seconds);
+    table.tai_utc.push_back(taiUtc[i]);
+  }
+  table.delta_t_a = deltaTA;
+  table.k = k;
+  table.eb = eb;
+  table.m[0] = m0;
+  table.m[1] = m1;
+  return table;
+}
+
+
+double calendarTimeToEphemTime(std::string calendarTime, const LeapSecondTable &table = defaultLeapSecondTable()) {
+  bool isTdb = false;
+  double tai_past_j2000 = calendarTimeToTai(table, calendarTime, isTdb);
+  if (isTdb) {
+    return tai_past_j2000;
   }
 
   // Calculate the TDB-TAI periodic correction. The mean-anomaly argument is ET
@@ -327,12 +784,9 @@ double calendarTimeToEphemTime(std::string calendarTime) {
   // |d(TDB_TAI)/dET| = K*M[1] ~ 3e-10. (The inverse, ephemTimeToCalendarTime,
   // already uses ET directly; iterating here keeps the round-trip consistent
   // and matches CSPICE's str2et.)
-  double et = tai_past_j2000 + DELTA_T_A;  // initial guess: TT past J2000
+  double et = tai_past_j2000 + table.delta_t_a;  // initial guess: TT past J2000
   for (int i = 0; i < 3; i++) {
-    double mean_m = M[0] + M[1] * et;
-    double E = mean_m + EB * sin(mean_m);
-    double tdb_tai = DELTA_T_A + K * sin(E);
-    et = tai_past_j2000 + tdb_tai;
+    et = tai_past_j2000 + tdbMinusTai(table, et);
   }
 
   // ET (TDB) = TAI past J2000 + TDB-TAI offset
@@ -340,156 +794,77 @@ double calendarTimeToEphemTime(std::string calendarTime) {
 }
 
 
-std::string ephemTimeToCalendarTime(double ephemTime, std::string format, int prec, int utclen) {
-  // Calculate TDB-TAI using periodic terms
-  double mean_m = M[0] + M[1] * ephemTime;
-  double E = mean_m + EB * sin(mean_m);
-  double tdb_tai = DELTA_T_A + K * sin(E);
-
-  // Approximate UTC time for leap second lookup
-  // ET ≈ seconds_since_j2000_utc + leap + tdb_tai
-  // So: seconds_since_j2000_utc ≈ ET - leap - tdb_tai
-  // Use J2000 leap count (32) for first approximation
-  double approx_seconds_since_j2000 = ephemTime - J2000_TAI_UTC - tdb_tai;
-  std::time_t approx_utc = (std::time_t)(approx_seconds_since_j2000 + J2000_UTC_UNIX);
-
-  // Look up the correct leap-second count for this UTC date
-  struct tm *g = std::gmtime(&approx_utc);
-  int y = g->tm_year + 1900, m = g->tm_mon + 1, d = g->tm_mday;
-  int leap = getLeapSeconds(y, m, d);
-
-  // Now compute the actual UTC time
-  // ET = seconds_since_j2000_utc + leap + tdb_tai
-  // seconds_since_j2000_utc = ET - leap - tdb_tai
-  double seconds_since_j2000_utc = ephemTime - leap - tdb_tai;
-
-  // Julian Date format ("J") reports the UTC Julian date directly and is not
-  // affected by the calendar rounding/carry logic below. J2000 (2000-01-01
-  // 12:00:00 UTC) is JD 2451545.0, and seconds_since_j2000_utc is measured from
-  // that same epoch.
-  std::string fmt = format;
-  std::transform(fmt.begin(), fmt.end(), fmt.begin(),
+std::string ephemTimeToCalendarTime(double ephemTime, std::string format, int prec, int utclen,
+                                    const LeapSecondTable &table = defaultLeapSecondTable()) {
+  std::transform(format.begin(), format.end(), format.begin(),
                  [](unsigned char c) { return (char)std::toupper(c); });
+  return formatCalendarTime(table, ephemTime, tdbMinusTai(table, ephemTime), format, prec, utclen);
+}
+
 
-  if (fmt == "J") {
-    double jd = 2451545.0 + seconds_since_j2000_utc / 86400.0;
-    // Round half away from zero to match CSPICE (printf's %f rounds half to
-    // even, which disagrees on exact .5 boundaries such as JD x.5).
-    double scale = std::pow(10.0, prec);
-    jd = std::floor(jd * scale + 0.5) / scale;
-    std::vector<char> jbuf(32 + prec);
-    snprintf(jbuf.data(), jbuf.size(), "JD %.*f", prec, jd);
-    std::string result = jbuf.data();
-    // CSPICE always emits the decimal point, even at precision 0 ("JD 2451545.").
-    if (prec == 0) {
-      result += '.';
+// Convert n calendar strings to ET. Strings are parsed one by one and the
+// TDB-TAI iteration then runs over the whole array. Results are identical to
+// calendarTimeToEphemTime.
+void calendarTimesToEphemTimes(const std::string *calendarTimes, double *ephemTimes, size_t n,
+                               const LeapSecondTable &table = defaultLeapSecondTable()) {
+  const size_t CHUNK = 256;
+  double tai[CHUNK];
+  bool tdb[CHUNK];
+
+  for (size_t start = 0; start < n; start += CHUNK) {
+    size_t count = std::min(CHUNK, n - start);
+    double *et = ephemTimes + start;
+
+    for (size_t i = 0; i < count; i++) {
+      tai[i] = calendarTimeToTai(table, calendarTimes[start + i], tdb[i]);
+      et[i] = tai[i] + table.delta_t_a;
     }
-    if ((int)result.size() + 1 > utclen) {
-      throw std::runtime_error("A utclen of {" + std::to_string(utclen) + "} to small for expected string size of "
-                          "{" + std::to_string(result.size() + 1) + "}");
+    for (int iter = 0; iter < 3; iter++) {
+      for (size_t i = 0; i < count; i++) {
+        et[i] = tai[i] + tdbMinusTai(table, et[i]);
+      }
     }
-    return result;
-  }
-
-  // Split into the integer second and fraction at the seconds-past-J2000
-  // magnitude, *before* shifting onto the Unix epoch. The J2000-to-1970 offset
-  // (~9.5e8 s) would push the value to ~1.2e9, where a double resolves only ~6
-  // fractional decimals; keeping the split at the smaller seconds-past-J2000
-  // magnitude preserves the extra decimal CSPICE's et2utc reports (e.g. a 2008
-  // epoch at ~2.6e8 resolves 7). The offset is a whole number of seconds, so
-  // shifting the floored second onto the Unix epoch is an exact integer add
-  // that cannot perturb the fraction.
-  double floor_j2000 = std::floor(seconds_since_j2000_utc);
-  double frac = seconds_since_j2000_utc - floor_j2000;
-  std::time_t utc_unix = (std::time_t)floor_j2000 + J2000_UTC_UNIX;
-
-  // Strip sub-resolution noise before rounding. A double holds ~15-16
-  // significant digits, so at this epoch's magnitude the fractional second is
-  // only meaningful to ulp = |seconds_since_j2000_utc| * 2^-52 seconds. Asking
-  // for more decimals than that surfaces floating-point dust (e.g. .1234 stored
-  // as .12339997). Snap the fraction to the resolvable number of decimals first
-  // so those trailing digits round cleanly instead of leaking noise. The
-  // resolvable count is taken at the seconds-past-J2000 magnitude actually
-  // carried, not the inflated Unix value, so it does not under-report by a
-  // decimal.
-  if (seconds_since_j2000_utc != 0.0) {
-    double ulp = std::fabs(seconds_since_j2000_utc) * 2.220446049250313e-16;  // 2^-52
-    int resolvable = (int)std::floor(-std::log10(ulp));
-    if (resolvable < 0) resolvable = 0;
-    if (resolvable < prec) {
-      double snapMult = std::pow(10.0, resolvable);
-      frac = std::lround(frac * snapMult) / snapMult;
+    for (size_t i = 0; i < count; i++) {
+      if (tdb[i]) {
+        et[i] = tai[i];
+      }
     }
   }
+}
 
-  long precisionMult = (long)std::lround(std::pow(10.0, prec));
-  // Round the fraction to the requested precision instead of truncating, so a
-  // value like x.600 does not degrade to x.599 through floating-point error.
-  long fracDigits = std::lround(frac * (double)precisionMult);
-  // A round-up can carry into the next whole second (e.g. 0.9999996 -> 1.000000
-  // at prec=6); roll it into utc_unix so we never emit an out-of-range field.
-  if (fracDigits >= precisionMult) {
-    fracDigits -= precisionMult;
-    utc_unix++;
-  }
 
-  // Break the rounded UTC instant into calendar fields.
-  struct tm utc_tm = *std::gmtime(&utc_unix);
-  int year = utc_tm.tm_year + 1900;
-  int month = utc_tm.tm_mon + 1;
-  int day = utc_tm.tm_mday;
-  int doy = utc_tm.tm_yday + 1;
-  int hour = utc_tm.tm_hour;
-  int minute = utc_tm.tm_min;
-  int second = utc_tm.tm_sec;
-
-  static const char *kMonthAbbr[] = {
-    "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
-    "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
-  };
+std::vector<double> calendarTimesToEphemTimes(const std::vector<std::string> &calendarTimes,
+                                              const LeapSecondTable &table = defaultLeapSecondTable()) {
+  std::vector<double> ephemTimes(calendarTimes.size());
+  calendarTimesToEphemTimes(calendarTimes.data(), ephemTimes.data(), calendarTimes.size(), table);
+  return ephemTimes;
+}
 
-  // Fractional-seconds suffix. prec == 0 omits the decimal point entirely, as
-  // CSPICE's et2utc does. For prec > 0 the fraction is zero-padded to exactly
-  // prec digits with no trailing-zero trimming -- matching et2utc_c, which
-  // emits a fixed-width fraction for every calendar format (C, D, ISOC, ISOD),
-  // e.g. ".582000" at prec 6 and ".000000" on a whole second. (The J format
-  // uses %f above and is unaffected by this.)
-  std::string fracStr;
-  if (prec > 0) {
-    std::vector<char> fbuf(prec + 2);
-    std::string fracFmt = ".%0" + std::to_string(prec) + "ld";
-    snprintf(fbuf.data(), fbuf.size(), fracFmt.c_str(), fracDigits);
-    fracStr = fbuf.data();
-  }
 
-  // Assemble the date/time portion per the requested format code. Defaults to
-  // ISOC for unrecognized codes to preserve prior behavior.
-  std::vector<char> datebuf(64);
-  if (fmt == "C") {
-    // "1986 APR 12 16:31:09"
-    snprintf(datebuf.data(), datebuf.size(), "%04d %s %02d %02d:%02d:%02d",
-             year, kMonthAbbr[month - 1], day, hour, minute, second);
-  }
-  else if (fmt == "D") {
-    // "1986-102 // 16:31:12"
-    snprintf(datebuf.data(), datebuf.size(), "%04d-%03d // %02d:%02d:%02d",
-             year, doy, hour, minute, second);
-  }
-  else if (fmt == "ISOD") {
-    // "1986-102T16:31:12"
-    snprintf(datebuf.data(), datebuf.size(), "%04d-%03dT%02d:%02d:%02d",
-             year, doy, hour, minute, second);
-  }
-  else {
-    // ISOC: "1986-04-12T16:31:12"
-    snprintf(datebuf.data(), datebuf.size(), "%04d-%02d-%02dT%02d:%02d:%02d",
-             year, month, day, hour, minute, second);
-  }
+// Convert n ETs to calendar strings. The TDB-TAI term is computed over the
+// array before formatting. Results are identical to ephemTimeToCalendarTime.
+void ephemTimesToCalendarTimes(const double *ephemTimes, std::string *calendarTimes, size_t n,
+                               std::string format, int prec, int utclen,
+                               const LeapSecondTable &table = defaultLeapSecondTable()) {
+  std::transform(format.begin(), format.end(), format.begin(),
+                 [](unsigned char c) { return (char)std::toupper(c); });
 
-  std::string result = std::string(datebuf.data()) + fracStr;
-  if ((int)result.size() + 1 > utclen) {
-    throw std::runtime_error("A utclen of {" + std::to_string(utclen) + "} to small for expected string size of "
-                        "{" + std::to_string(result.size() + 1) + "}");
+  const size_t CHUNK = 256;
+  double tdb_tai[CHUNK];
+
+  for (size_t start = 0; start < n; start += CHUNK) {
+    size_t count = std::min(CHUNK, n - start);
+    tdbMinusTai(table, ephemTimes + start, tdb_tai, count);
+    for (size_t i = 0; i < count; i++) {
+      calendarTimes[start + i] = formatCalendarTime(table, ephemTimes[start + i], tdb_tai[i], format, prec, utclen);
+    }
   }
-  return result;
+}
+
+
+std::vector<std::string> ephemTimesToCalendarTimes(const std::vector<double> &ephemTimes, std::string format, int prec, int utclen,
+                                                   const LeapSecondTable &table = defaultLeapSecondTable()) {
+  std::vector<std::string> calendarTimes(ephemTimes.size());
+  ephemTimesToCalendarTimes(ephemTimes.data(), calendarTimes.data(), ephemTimes.size(), format, prec, utclen, table);
+  return calendarTimes;
 }